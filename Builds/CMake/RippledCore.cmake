@@ -28,6 +28,7 @@ target_sources (xrpl_core PRIVATE
   src/ripple/beast/insight/impl/Metric.cpp
   src/ripple/beast/insight/impl/NullCollector.cpp
   src/ripple/beast/insight/impl/StatsDCollector.cpp
+  src/ripple/beast/insight/impl/TextCollector.cpp
   src/ripple/beast/net/impl/IPAddressConversion.cpp
   src/ripple/beast/net/impl/IPAddressV4.cpp
   src/ripple/beast/net/impl/IPAddressV6.cpp
@@ -90,6 +91,7 @@ target_sources (xrpl_core PRIVATE
   src/ripple/protocol/impl/STBlob.cpp
   src/ripple/protocol/impl/STInteger.cpp
   src/ripple/protocol/impl/STLedgerEntry.cpp
+  src/ripple/protocol/impl/STLedgerEntryView.cpp
   src/ripple/protocol/impl/STObject.cpp
   src/ripple/protocol/impl/STParsedJSON.cpp
   src/ripple/protocol/impl/STPathSet.cpp
@@ -230,6 +232,7 @@ install (
     src/ripple/protocol/STExchange.h
     src/ripple/protocol/STInteger.h
     src/ripple/protocol/STLedgerEntry.h
+    src/ripple/protocol/STLedgerEntryView.h
     src/ripple/protocol/STObject.h
     src/ripple/protocol/STParsedJSON.h
     src/ripple/protocol/STPathSet.h
@@ -351,6 +354,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/ledger/impl/InboundLedger.cpp
   src/ripple/app/ledger/impl/InboundLedgers.cpp
   src/ripple/app/ledger/impl/InboundTransactions.cpp
+  src/ripple/app/ledger/impl/LedgerBackfill.cpp
   src/ripple/app/ledger/impl/LedgerCleaner.cpp
   src/ripple/app/ledger/impl/LedgerDeltaAcquire.cpp
   src/ripple/app/ledger/impl/LedgerMaster.cpp
@@ -362,6 +366,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/ledger/impl/LocalTxs.cpp
   src/ripple/app/ledger/impl/OpenLedger.cpp
   src/ripple/app/ledger/impl/SkipListAcquire.cpp
+  src/ripple/app/ledger/impl/StripeScheduler.cpp
   src/ripple/app/ledger/impl/TimeoutCounter.cpp
   src/ripple/app/ledger/impl/TransactionAcquire.cpp
   src/ripple/app/ledger/impl/TransactionMaster.cpp
@@ -439,6 +444,7 @@ target_sources (rippled PRIVATE
   src/ripple/basics/impl/BasicConfig.cpp
   src/ripple/basics/impl/PerfLogImp.cpp
   src/ripple/basics/impl/ResolverAsio.cpp
+  src/ripple/basics/impl/SlabAllocator.cpp
   src/ripple/basics/impl/UptimeClock.cpp
   src/ripple/basics/impl/make_SSLContext.cpp
   src/ripple/basics/impl/mulDiv.cpp
@@ -522,6 +528,7 @@ target_sources (rippled PRIVATE
   src/ripple/nodestore/impl/ManagerImp.cpp
   src/ripple/nodestore/impl/NodeObject.cpp
   src/ripple/nodestore/impl/Shard.cpp
+  src/ripple/nodestore/impl/ShardArchive.cpp
   src/ripple/nodestore/impl/TaskQueue.cpp
   #[===============================[
      main sources:
@@ -672,8 +679,11 @@ target_sources (rippled PRIVATE
   src/test/app/Flow_test.cpp
   src/test/app/Freeze_test.cpp
   src/test/app/HashRouter_test.cpp
+  src/test/app/InboundLedger_test.cpp
+  src/test/app/InboundTransactions_test.cpp
   src/test/app/LedgerHistory_test.cpp
   src/test/app/LedgerLoad_test.cpp
+  src/test/app/LedgerMaster_test.cpp
   src/test/app/LedgerReplay_test.cpp
   src/test/app/LoadFeeTrack_test.cpp
   src/test/app/Manifest_test.cpp
@@ -692,12 +702,14 @@ target_sources (rippled PRIVATE
   src/test/app/SetAuth_test.cpp
   src/test/app/SetRegularKey_test.cpp
   src/test/app/SetTrust_test.cpp
+  src/test/app/StripeScheduler_test.cpp
   src/test/app/Taker_test.cpp
   src/test/app/TheoreticalQuality_test.cpp
   src/test/app/Ticket_test.cpp
   src/test/app/Transaction_ordering_test.cpp
   src/test/app/TrustAndBalance_test.cpp
   src/test/app/TxQ_test.cpp
+  src/test/app/TxReplay_test.cpp
   src/test/app/ValidatorKeys_test.cpp
   src/test/app/ValidatorList_test.cpp
   src/test/app/ValidatorSite_test.cpp
@@ -713,6 +725,7 @@ target_sources (rippled PRIVATE
   src/test/basics/KeyCache_test.cpp
   src/test/basics/PerfLog_test.cpp
   src/test/basics/RangeSet_test.cpp
+  src/test/basics/SlabAllocator_test.cpp
   src/test/basics/Slice_test.cpp
   src/test/basics/StringUtilities_test.cpp
   src/test/basics/TaggedCache_test.cpp
@@ -738,6 +751,7 @@ target_sources (rippled PRIVATE
   src/test/beast/beast_Zero_test.cpp
   src/test/beast/beast_abstract_clock_test.cpp
   src/test/beast/beast_basic_seconds_clock_test.cpp
+  src/test/beast/beast_insight_Histogram_test.cpp
   src/test/beast/beast_io_latency_probe_test.cpp
   src/test/beast/define_print.cpp
   #[===============================[
@@ -750,6 +764,7 @@ target_sources (rippled PRIVATE
        subdir: consensus
   #]===============================]
   src/test/consensus/ByzantineFailureSim_test.cpp
+  src/test/consensus/ConsensusScaleSim_test.cpp
   src/test/consensus/Consensus_test.cpp
   src/test/consensus/DistributedValidatorsSim_test.cpp
   src/test/consensus/LedgerTiming_test.cpp
@@ -859,6 +874,7 @@ target_sources (rippled PRIVATE
   src/test/nodestore/Basics_test.cpp
   src/test/nodestore/DatabaseShard_test.cpp
   src/test/nodestore/Database_test.cpp
+  src/test/nodestore/ShardArchive_test.cpp
   src/test/nodestore/Timing_test.cpp
   src/test/nodestore/import_test.cpp
   src/test/nodestore/varint_test.cpp
@@ -888,15 +904,18 @@ target_sources (rippled PRIVATE
   src/test/protocol/KnownFormatToGRPC_test.cpp
   src/test/protocol/PublicKey_test.cpp
   src/test/protocol/Quality_test.cpp
+  src/test/protocol/SField_test.cpp
   src/test/protocol/STAccount_test.cpp
   src/test/protocol/STAmount_test.cpp
   src/test/protocol/STObject_test.cpp
+  src/test/protocol/STLedgerEntryView_test.cpp
   src/test/protocol/STTx_test.cpp
   src/test/protocol/STValidation_test.cpp
   src/test/protocol/SecretKey_test.cpp
   src/test/protocol/Seed_test.cpp
   src/test/protocol/SeqProxy_test.cpp
   src/test/protocol/TER_test.cpp
+  src/test/protocol/digest_test.cpp
   src/test/protocol/types_test.cpp
   #[===============================[
      test sources:
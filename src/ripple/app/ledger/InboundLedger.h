@@ -21,6 +21,7 @@
 #define RIPPLE_APP_LEDGER_INBOUNDLEDGER_H_INCLUDED
 
 #include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/impl/StripeScheduler.h>
 #include <ripple/app/ledger/impl/TimeoutCounter.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/basics/CountedObject.h>
@@ -30,6 +31,9 @@
 #include <utility>
 
 namespace ripple {
+namespace test {
+class InboundLedger_test;
+}
 
 // A ledger we are trying to acquire
 class InboundLedger final : public TimeoutCounter,
@@ -37,6 +41,8 @@ class InboundLedger final : public TimeoutCounter,
                             public CountedObject<InboundLedger>
 {
 public:
+    friend class test::InboundLedger_test;
+
     using clock_type = beast::abstract_clock<std::chrono::steady_clock>;
 
     using PeerDataPairType =
@@ -133,6 +139,13 @@ private:
     void
     trigger(std::shared_ptr<Peer> const&, TriggerReason);
 
+    bool
+    requestNodes(
+        protocol::TMGetLedger& tmGL,
+        std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes,
+        std::shared_ptr<Peer> const& peer,
+        TriggerReason reason);
+
     std::vector<neededHash_t>
     getNeededHashes();
 
@@ -161,7 +174,10 @@ private:
     takeHeader(std::string const& data);
 
     void
-    receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode&);
+    receiveNode(
+        protocol::TMLedgerData& packet,
+        std::vector<SHAMapNodeID> const& nodeIDs,
+        SHAMapAddNode&);
 
     bool
     takeTxRootNode(Slice const& data, SHAMapAddNode&);
@@ -189,6 +205,9 @@ private:
 
     std::set<uint256> mRecentNodes;
 
+    // Spreads the nodes requested after a reply across the peers
+    StripeScheduler mStripes;
+
     SHAMapAddNode mStats;
 
     // Data we have received from peers
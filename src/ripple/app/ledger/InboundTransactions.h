@@ -29,6 +29,7 @@
 namespace ripple {
 
 class Application;
+class PeerSetBuilder;
 
 /** Manages the acquisition and lifetime of transaction sets.
  */
@@ -94,6 +95,18 @@ make_InboundTransactions(
     beast::insight::Collector::ptr const& collector,
     std::function<void(std::shared_ptr<SHAMap> const&, bool)> gotSet);
 
+/** Create an InboundTransactions that obtains peers from peerSetBuilder.
+
+    Used by unit tests to observe and answer the requests an acquire makes.
+*/
+std::unique_ptr<InboundTransactions>
+make_InboundTransactions(
+    Application& app,
+    Stoppable& parent,
+    beast::insight::Collector::ptr const& collector,
+    std::function<void(std::shared_ptr<SHAMap> const&, bool)> gotSet,
+    std::unique_ptr<PeerSetBuilder> peerSetBuilder);
+
 }  // namespace ripple
 
 #endif
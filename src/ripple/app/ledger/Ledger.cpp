@@ -119,7 +119,7 @@ public:
     sles_type::value_type
     dereference() const override
     {
-        auto const item = *iter_;
+        auto const& item = *iter_;
         SerialIter sit(item.slice());
         return std::make_shared<SLE const>(sit, item.key());
     }
@@ -168,7 +168,7 @@ public:
     txs_type::value_type
     dereference() const override
     {
-        auto const item = *iter_;
+        auto const& item = *iter_;
         if (metadata_)
             return deserializeTxPlusMeta(item);
         return {deserializeTx(item), nullptr};
@@ -371,8 +371,9 @@ Ledger::setAccepted(
 bool
 Ledger::addSLE(SLE const& sle)
 {
-    SHAMapItem item(sle.key(), sle.getSerializer());
-    return stateMap_->addItem(SHAMapNodeType::tnACCOUNT_STATE, std::move(item));
+    return stateMap_->addItem(
+        SHAMapNodeType::tnACCOUNT_STATE,
+        make_shamapitem(sle.key(), sle.getSerializer().slice()));
 }
 
 //------------------------------------------------------------------------------
@@ -445,6 +446,26 @@ Ledger::read(Keylet const& k) const
     return sle;
 }
 
+std::shared_ptr<STLedgerEntryView const>
+Ledger::readLazy(Keylet const& k) const
+{
+    if (k.key == beast::zero)
+    {
+        assert(false);
+        return nullptr;
+    }
+    auto const& item = stateMap_->peekItem(k.key);
+    if (!item)
+        return nullptr;
+    // The view holds a reference to the item
+    std::shared_ptr<void const> owner(item.get(), [item](void const*) {});
+    auto view = std::make_shared<STLedgerEntryView>(
+        item->slice(), item->key(), std::move(owner));
+    if (!k.check(*view))
+        return nullptr;
+    return view;
+}
+
 //------------------------------------------------------------------------------
 
 auto
@@ -533,7 +554,7 @@ Ledger::rawInsert(std::shared_ptr<SLE> const& sle)
     sle->add(ss);
     if (!stateMap_->addGiveItem(
             SHAMapNodeType::tnACCOUNT_STATE,
-            std::make_shared<SHAMapItem const>(sle->key(), std::move(ss))))
+            make_shamapitem(sle->key(), ss.slice())))
         LogicError("Ledger::rawInsert: key already exists");
 }
 
@@ -544,7 +565,7 @@ Ledger::rawReplace(std::shared_ptr<SLE> const& sle)
     sle->add(ss);
     if (!stateMap_->updateGiveItem(
             SHAMapNodeType::tnACCOUNT_STATE,
-            std::make_shared<SHAMapItem const>(sle->key(), std::move(ss))))
+            make_shamapitem(sle->key(), ss.slice())))
         LogicError("Ledger::rawReplace: key not found");
 }
 
@@ -562,7 +583,7 @@ Ledger::rawTxInsert(
     s.addVL(metaData->peekData());
     if (!txMap().addGiveItem(
             SHAMapNodeType::tnTRANSACTION_MD,
-            std::make_shared<SHAMapItem const>(key, std::move(s))))
+            make_shamapitem(key, s.slice())))
         LogicError("duplicate_tx: " + to_string(key));
 }
 
@@ -578,9 +599,8 @@ Ledger::rawTxInsertWithHash(
     Serializer s(txn->getDataLength() + metaData->getDataLength() + 16);
     s.addVL(txn->peekData());
     s.addVL(metaData->peekData());
-    auto item = std::make_shared<SHAMapItem const>(key, std::move(s));
-    auto hash = sha512Half(
-        HashPrefix::txNode, makeSlice(item->peekData()), item->key());
+    auto item = make_shamapitem(key, s.slice());
+    auto hash = sha512Half(HashPrefix::txNode, item->slice(), item->key());
     if (!txMap().addGiveItem(SHAMapNodeType::tnTRANSACTION_MD, std::move(item)))
         LogicError("duplicate_tx: " + to_string(key));
 
@@ -920,6 +940,7 @@ saveValidatedLedger(
     std::shared_ptr<Ledger const> const& ledger,
     bool current)
 {
+    ScopedLedgerPhase timer{app.getLedgerMaster(), perf::LedgerPhase::store};
     auto j = app.journal("Ledger");
     auto seq = ledger->info().seq;
     if (!app.pendingSaves().startWork(seq))
@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_LEDGERBACKFILL_H_INCLUDED
+#define RIPPLE_APP_LEDGER_LEDGERBACKFILL_H_INCLUDED
+
+#include <ripple/app/ledger/InboundLedger.h>
+#include <ripple/app/ledger/impl/TimeoutCounter.h>
+#include <ripple/app/main/Application.h>
+#include <ripple/basics/CountedObject.h>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+class InboundLedgers;
+class Ledger;
+class LedgerDeltaAcquire;
+class LedgerReplayer;
+class SkipListAcquire;
+namespace test {
+class LedgerReplayClient;
+}  // namespace test
+
+/**
+ * Replay a range of ledgers too long for one LedgerReplayTask, such as a
+ * gap in the ledger history.
+ *
+ * The backfill first walks the skip lists down from the finish ledger, one
+ * per 256 ledgers, to learn the hash of every ledger in the range. Then,
+ * starting from the start ledger, it keeps a window of LedgerDeltaAcquire
+ * subtasks ahead of the ledger being built, bounded by a depth and by the
+ * size of the transactions they hold. The ledgers are built in order by a
+ * job of their own, so that the deltas further up the window are fetched,
+ * deserialized and have their signatures checked meanwhile.
+ *
+ * Every ledger built is handed over as soon as it is built, so a backfill
+ * which fails part way can be restarted from the last of them.
+ */
+class LedgerBackfill final
+    : public TimeoutCounter,
+      public std::enable_shared_from_this<LedgerBackfill>,
+      public CountedObject<LedgerBackfill>
+{
+public:
+    /**
+     * Constructor
+     * @param app  Application reference
+     * @param inboundLedgers  InboundLedgers reference
+     * @param replayer  LedgerReplayer reference
+     * @param r  the reason of the backfill
+     * @param finishLedgerHash  hash of the last ledger in the range
+     * @param totalNumLedgers  number of ledgers in the range, including the
+     *        start ledger, which is not built but acquired
+     */
+    LedgerBackfill(
+        Application& app,
+        InboundLedgers& inboundLedgers,
+        LedgerReplayer& replayer,
+        InboundLedger::Reason r,
+        uint256 const& finishLedgerHash,
+        std::uint32_t totalNumLedgers);
+
+    ~LedgerBackfill();
+
+    /** Start the backfill */
+    void
+    init();
+
+    uint256 const&
+    getFinishHash() const
+    {
+        return hash_;
+    }
+
+    /** return if the backfill is finished */
+    bool
+    finished() const;
+
+    static char const*
+    getCountedObjectName()
+    {
+        return "LedgerBackfill";
+    }
+
+private:
+    void
+    onTimer(bool progress, ScopedLockType& sl) override;
+
+    std::weak_ptr<TimeoutCounter>
+    pmDowncast() override;
+
+    /**
+     * Acquire the next skip list down the range
+     * @param sl  lock. this function must be called with the lock
+     */
+    void
+    walk(ScopedLockType& sl);
+
+    /**
+     * Process the skip list of the lowest ledger with a known hash
+     * @param good  if the skip list was acquired
+     */
+    void
+    gotSkipList(bool good);
+
+    /**
+     * Find the start ledger and fill the window, once the hashes are known
+     * @param sl  lock. this function must be called with the lock
+     */
+    void
+    trigger(ScopedLockType& sl);
+
+    /**
+     * Add deltas to the window, up to the depth and memory limits. The
+     * memory held counts the hashes of the range, and the deltas still
+     * being acquired at an estimate of their size
+     * @param sl  lock. this function must be called with the lock
+     */
+    void
+    fill(ScopedLockType& sl);
+
+    /**
+     * Notify this backfill (by a LedgerDeltaAcquire subtask) that a delta
+     * is ready
+     * @param deltaHash  ledger hash of the delta
+     */
+    void
+    deltaReady(uint256 const& deltaHash);
+
+    /**
+     * Schedule the build job, unless it is running already
+     * @param sl  lock. this function must be called with the lock
+     */
+    void
+    scheduleBuild(ScopedLockType& sl);
+
+    /** Build the ledgers at the front of the window which are ready */
+    void
+    build();
+
+    InboundLedgers& inboundLedgers_;
+    LedgerReplayer& replayer_;
+    InboundLedger::Reason const reason_;
+    std::uint32_t const totalLedgers_;
+    std::uint32_t const depth_;
+    std::size_t const maxBytes_;
+
+    // hashes_[i] is the hash of the ledger startSeq_ + i, known from
+    // hashes_[lowest_] up
+    std::vector<uint256> hashes_;
+    std::uint32_t startSeq_ = 0;
+    std::uint32_t lowest_;
+    std::shared_ptr<SkipListAcquire> skipList_;
+    bool walking_ = false;
+
+    // The last ledger built, and the deltas of the ledgers which follow it,
+    // up to hashes_[next_]
+    std::shared_ptr<Ledger const> parent_;
+    std::deque<std::shared_ptr<LedgerDeltaAcquire>> window_;
+    std::uint32_t next_ = 1;
+    bool building_ = false;
+    bool rebuild_ = false;
+
+    friend class test::LedgerReplayClient;
+};
+
+}  // namespace ripple
+
+#endif
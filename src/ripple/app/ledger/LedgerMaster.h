@@ -29,9 +29,12 @@
 #include <ripple/app/ledger/LedgerReplay.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/CanonicalTXSet.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/basics/RangeSet.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/basics/chrono.h>
+#include <ripple/beast/container/aged_unordered_map.h>
 #include <ripple/beast/insight/Collector.h>
 #include <ripple/beast/utility/PropertyStream.h>
 #include <ripple/core/Stoppable.h>
@@ -41,12 +44,19 @@
 #include <ripple/protocol/messages.h>
 #include <boost/optional.hpp>
 
+#include <array>
+#include <future>
+#include <limits>
 #include <mutex>
 
 namespace ripple {
 
 class Peer;
 class Transaction;
+namespace test {
+class LedgerMaster_test;
+class LedgerReplayClient;
+}  // namespace test
 
 // This error is thrown when a codepath tries to access the open or closed
 // ledger while the server is running in reporting mode. Any RPCs that request
@@ -281,9 +291,25 @@ public:
     void
     gotFetchPack(bool progress, std::uint32_t seq);
 
-    void
+    /** Stash an object if its data hashes to the given hash.
+
+        @return Whether the object was stashed.
+    */
+    bool
     addFetchPack(uint256 const& hash, std::shared_ptr<Blob> data);
 
+    /** Stash the objects of a fetch pack which match their hashes.
+
+        Large packs are verified in batches on several jobs at once.
+
+        @param onDone Called once every object is stashed, with the number
+                      of objects which did not match their hash.
+    */
+    void
+    addFetchPack(
+        std::vector<std::pair<uint256, std::shared_ptr<Blob>>> objects,
+        std::function<void(std::size_t)> onDone);
+
     boost::optional<Blob>
     getFetchPack(uint256 const& hash) override;
 
@@ -308,6 +334,14 @@ public:
     boost::optional<LedgerIndex>
     minSqlSeq();
 
+    /** Record how long one phase of closing a ledger took.
+
+        The duration goes to the PerfLog counters and, as a timing
+        event, to the insight collector.
+    */
+    void
+    notePhase(perf::LedgerPhase phase, std::chrono::microseconds duration);
+
 private:
     void
     setValidLedger(std::shared_ptr<Ledger const> const& l);
@@ -320,6 +354,22 @@ private:
     void
     getFetchPack(LedgerIndex missing, InboundLedger::Reason reason);
 
+    // Stash an object already checked against its hash
+    void
+    stashFetchPack(uint256 const& hash, std::shared_ptr<Blob> data);
+
+    std::size_t
+    addFetchPack(
+        std::pair<uint256, std::shared_ptr<Blob>> const* objects,
+        std::size_t count);
+
+    // The part of a fetch pack covering want, the parent of have
+    std::shared_ptr<protocol::TMGetObjectByHash>
+    getFetchPackDiff(Ledger const& have, Ledger const& want);
+
+    void
+    prebuildFetchPack(std::shared_ptr<Ledger const> const& ledger);
+
     boost::optional<LedgerHash>
     getLedgerHashForHistory(LedgerIndex index, InboundLedger::Reason reason);
 
@@ -333,6 +383,10 @@ private:
         bool& progress,
         InboundLedger::Reason reason,
         std::unique_lock<std::recursive_mutex>&);
+    // Fill the history gap ending at missing by ledger replay, if enabled.
+    // Returns false if the gap is to be filled one ledger at a time.
+    bool
+    backfillForHistory(std::uint32_t missing, uint256 const& hash);
     // Try to publish ledgers, acquire missing ledgers.  Always called with
     // m_mutex locked.  The passed lock is a reminder to callers.
     void
@@ -419,6 +473,44 @@ private:
 
     TaggedCache<uint256, Blob> fetch_packs_;
 
+    // The most bytes of objects kept in built parts of fetch packs, and
+    // how long a part is kept
+    static constexpr std::size_t fetchPackDiffBytes = 32 * 1024 * 1024;
+    static constexpr std::chrono::minutes fetchPackDiffAge{2};
+
+    struct FetchPackDiff
+    {
+        std::shared_ptr<protocol::TMGetObjectByHash> objects;
+
+        // The bytes of the objects' data
+        std::size_t bytes;
+    };
+
+    // The parts of fetch packs we built, keyed by the hash of the child of
+    // the ledger each covers, which with its parent identifies the pair of
+    // state maps the part was diffed from. Peers catching up ask for the
+    // same recent ledgers, so the parts are shared between them. The most
+    // recently used parts are kept while their objects fit in
+    // fetchPackDiffBytes.
+    std::mutex fetch_pack_diffs_mutex_;
+    beast::aged_unordered_map<
+        uint256,
+        FetchPackDiff,
+        Stopwatch::clock_type,
+        hardened_hash<strong_hash>>
+        fetch_pack_diffs_;
+    std::size_t fetch_pack_diff_bytes_{0};
+
+    // The parts being built, which peers asking for them wait on
+    hash_map<
+        uint256,
+        std::shared_future<std::shared_ptr<protocol::TMGetObjectByHash>>>
+        fetch_pack_diffs_building_;
+
+    // When a peer last asked us for a fetch pack, in seconds of uptime
+    std::atomic<UptimeClock::rep> fetch_pack_requested_{
+        std::numeric_limits<UptimeClock::rep>::min()};
+
     std::uint32_t fetch_seq_{0};
 
     // Try to keep a validator from switching from test to live network
@@ -441,11 +533,19 @@ private:
             , publishedLedgerAge(
                   collector->make_gauge("LedgerMaster", "Published_Ledger_Age"))
         {
+            for (std::size_t i = 0; i < phases.size(); ++i)
+                phases[i] = collector->make_event(
+                    "LedgerClose",
+                    ledgerPhaseName(static_cast<perf::LedgerPhase>(i)));
         }
 
         beast::insight::Hook hook;
         beast::insight::Gauge validatedLedgerAge;
         beast::insight::Gauge publishedLedgerAge;
+        std::array<
+            beast::insight::Event,
+            static_cast<std::size_t>(perf::LedgerPhase::count)>
+            phases;
     };
 
     Stats m_stats;
@@ -458,6 +558,38 @@ private:
         m_stats.validatedLedgerAge.set(getValidatedLedgerAge().count());
         m_stats.publishedLedgerAge.set(getPublishedLedgerAge().count());
     }
+
+    friend class test::LedgerReplayClient;
+    friend class test::LedgerMaster_test;
+};
+
+/** Reports the time spent in a scope as a phase of closing a ledger. */
+class ScopedLedgerPhase
+{
+public:
+    ScopedLedgerPhase(LedgerMaster& ledgerMaster, perf::LedgerPhase phase)
+        : ledgerMaster_(ledgerMaster)
+        , phase_(phase)
+        , start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    ScopedLedgerPhase(ScopedLedgerPhase const&) = delete;
+    ScopedLedgerPhase&
+    operator=(ScopedLedgerPhase const&) = delete;
+
+    ~ScopedLedgerPhase()
+    {
+        ledgerMaster_.notePhase(
+            phase_,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start_));
+    }
+
+private:
+    LedgerMaster& ledgerMaster_;
+    perf::LedgerPhase const phase_;
+    std::chrono::steady_clock::time_point const start_;
 };
 
 }  // namespace ripple
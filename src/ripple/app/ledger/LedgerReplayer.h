@@ -20,6 +20,7 @@
 #ifndef RIPPLE_APP_LEDGER_LEDGERREPLAYER_H_INCLUDED
 #define RIPPLE_APP_LEDGER_LEDGERREPLAYER_H_INCLUDED
 
+#include <ripple/app/ledger/LedgerBackfill.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerReplayTask.h>
 #include <ripple/app/main/Application.h>
@@ -65,6 +66,23 @@ std::uint32_t constexpr MAX_TASK_SIZE = 256;
 
 // to limit the number of LedgerReplay related jobs in JobQueue
 std::uint32_t constexpr MAX_QUEUED_TASKS = 100;
+
+// timeout value for LedgerBackfill
+auto constexpr BACKFILL_TIMEOUT = std::chrono::milliseconds{1000};
+// max of allowed LedgerBackfill timeouts in a row, the start ledger
+// may have to be acquired from scratch
+std::uint32_t constexpr BACKFILL_MAX_TIMEOUTS = 300;
+
+// for LedgerReplayer to limit the number of LedgerBackfill
+std::uint32_t constexpr MAX_BACKFILLS = 2;
+
+// for LedgerReplayer to limit the number of ledgers in one LedgerBackfill,
+// which keeps the hashes of all of them
+std::uint32_t constexpr MAX_BACKFILL_SIZE = 256 * 4096;
+
+// the serialized size LedgerBackfill charges for the transactions of a
+// ledger delta which has not arrived yet
+std::size_t constexpr DELTA_SIZE_ESTIMATE = 64 * 1024;
 }  // namespace LedgerReplayParameters
 
 /**
@@ -94,10 +112,39 @@ public:
         uint256 const& finishLedgerHash,
         std::uint32_t totalNumLedgers);
 
+    /**
+     * Replay a long range of ledgers, such as a gap in the ledger history
+     * @param r  reason for the backfill request
+     * @param finishLedgerHash  hash of the last ledger
+     * @param totalNumLedgers  total number of ledgers in the range, inclusive
+     * @return false if the backfill was not started, e.g. too many backfills
+     * @note totalNumLedgers must > 0 &&
+     *       totalNumLedgers must <= MAX_BACKFILL_SIZE
+     */
+    bool
+    backfill(
+        InboundLedger::Reason r,
+        uint256 const& finishLedgerHash,
+        std::uint32_t totalNumLedgers);
+
     /** Create LedgerDeltaAcquire subtasks for the LedgerReplayTask task */
     void
     createDeltas(std::shared_ptr<LedgerReplayTask> task);
 
+    /**
+     * Find or create, and start, the SkipListAcquire subtask of a ledger
+     * @return nullptr if stopping
+     */
+    std::shared_ptr<SkipListAcquire>
+    acquireSkipList(uint256 const& hash);
+
+    /**
+     * Find or create, and start, the LedgerDeltaAcquire subtask of a ledger
+     * @return nullptr if stopping
+     */
+    std::shared_ptr<LedgerDeltaAcquire>
+    acquireDelta(uint256 const& hash, std::uint32_t seq);
+
     /**
      * Process a skip list (extracted from a TMProofPathResponse message)
      * @param info  ledger info
@@ -107,7 +154,7 @@ public:
     void
     gotSkipList(
         LedgerInfo const& info,
-        std::shared_ptr<SHAMapItem const> const& data);
+        boost::intrusive_ptr<SHAMapItem const> const& data);
 
     /**
      * Process a ledger delta (extracted from a TMReplayDeltaResponse message)
@@ -130,6 +177,9 @@ public:
 private:
     mutable std::mutex mtx_;
     std::vector<std::shared_ptr<LedgerReplayTask>> tasks_;
+    // A LedgerBackfill calls the replayer with its own lock held, so it
+    // must not be called with mtx_ held
+    std::vector<std::shared_ptr<LedgerBackfill>> backfills_;
     hash_map<uint256, std::weak_ptr<LedgerDeltaAcquire>> deltas_;
     hash_map<uint256, std::weak_ptr<SkipListAcquire>> skipLists_;
 
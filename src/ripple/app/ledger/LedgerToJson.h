@@ -27,6 +27,8 @@
 #include <ripple/protocol/STTx.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/Context.h>
+#include <boost/optional.hpp>
+#include <functional>
 
 namespace ripple {
 
@@ -70,6 +72,33 @@ addJson(Json::Value&, LedgerFill const&);
 Json::Value
 getJson(LedgerFill const&);
 
+/** Convert the state entries of a ledger to JSON, in key order.
+
+    The entries after `after` are split by the root branch of the state map
+    holding them. The calling thread converts the branches in key order,
+    helped by up to `threads - 1` jobs which convert the branches ahead of
+    it, and `emit` receives the converted entries in key order on the
+    calling thread. No branch is converted past the entries left to return.
+    Entries whose type does not match `type` are skipped, but they still
+    count against `limit`, as they always have for ledger_data.
+
+    Only views which are not modified concurrently, such as closed ledgers,
+    should be converted with more than one thread.
+
+    @return The marker to resume from if `limit` entries were visited
+            before the last entry.
+*/
+boost::optional<uint256>
+forEachStateJson(
+    ReadView const& ledger,
+    uint256 const& after,
+    std::size_t limit,
+    LedgerEntryType type,
+    JobQueue* jobQueue,
+    unsigned int threads,
+    std::function<Json::Value(SLE const&)> const& convert,
+    std::function<void(Json::Value&&)> const& emit);
+
 /** Serialize an object to a blob. */
 template <class Object>
 Blob
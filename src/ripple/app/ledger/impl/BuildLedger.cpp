@@ -19,6 +19,7 @@
 
 #include <ripple/app/ledger/BuildLedger.h>
 #include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerReplay.h>
 #include <ripple/app/ledger/OpenLedger.h>
 #include <ripple/app/main/Application.h>
@@ -56,6 +57,8 @@ buildLedgerImpl(
     //   perform updates, extract changes
 
     {
+        ScopedLedgerPhase timer{
+            app.getLedgerMaster(), perf::LedgerPhase::apply};
         OpenView accum(&*built);
         assert(!accum.open());
         applyTxs(accum, built);
@@ -66,6 +69,8 @@ buildLedgerImpl(
     {
         // Write the final version of all modified SHAMap
         // nodes to the node store to preserve the new LCL
+        ScopedLedgerPhase timer{
+            app.getLedgerMaster(), perf::LedgerPhase::flush};
 
         int const asf = built->stateMap().flushDirty(hotACCOUNT_NODE);
         int const tmf = built->txMap().flushDirty(hotTRANSACTION_NODE);
@@ -34,6 +34,7 @@
 #include <ripple/shamap/SHAMapNodeID.h>
 
 #include <algorithm>
+#include <map>
 
 namespace ripple {
 
@@ -92,6 +93,7 @@ InboundLedger::InboundLedger(
     , mByHash(true)
     , mSeq(seq)
     , mReason(reason)
+    , mStripes(clock, reqNodes, reqNodesReply, ledgerAcquireTimeout)
     , mReceiveDispatched(false)
     , mPeerSet(std::move(peerSet))
 {
@@ -719,27 +721,16 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
                 }
                 else
                 {
-                    filterNodes(nodes, reason);
-
-                    if (!nodes.empty())
-                    {
-                        tmGL.set_itype(protocol::liAS_NODE);
-                        for (auto const& id : nodes)
-                        {
-                            *(tmGL.add_nodeids()) = id.first.getRawString();
-                        }
+                    // Replies are striped, which does its own filtering
+                    if (reason != TriggerReason::reply)
+                        filterNodes(nodes, reason);
 
-                        JLOG(journal_.trace())
-                            << "Sending AS node request (" << nodes.size()
-                            << ") to "
-                            << (peer ? "selected peer" : "all peers");
-                        mPeerSet->sendRequest(tmGL, peer);
+                    tmGL.set_itype(protocol::liAS_NODE);
+                    if (!nodes.empty() &&
+                        requestNodes(tmGL, nodes, peer, reason))
                         return;
-                    }
-                    else
-                    {
-                        JLOG(journal_.trace()) << "All AS nodes filtered";
-                    }
+
+                    JLOG(journal_.trace()) << "All AS nodes filtered";
                 }
             }
         }
@@ -785,25 +776,14 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
             }
             else
             {
-                filterNodes(nodes, reason);
+                if (reason != TriggerReason::reply)
+                    filterNodes(nodes, reason);
 
-                if (!nodes.empty())
-                {
-                    tmGL.set_itype(protocol::liTX_NODE);
-                    for (auto const& n : nodes)
-                    {
-                        *(tmGL.add_nodeids()) = n.first.getRawString();
-                    }
-                    JLOG(journal_.trace())
-                        << "Sending TX node request (" << nodes.size()
-                        << ") to " << (peer ? "selected peer" : "all peers");
-                    mPeerSet->sendRequest(tmGL, peer);
+                tmGL.set_itype(protocol::liTX_NODE);
+                if (!nodes.empty() && requestNodes(tmGL, nodes, peer, reason))
                     return;
-                }
-                else
-                {
-                    JLOG(journal_.trace()) << "All TX nodes filtered";
-                }
+
+                JLOG(journal_.trace()) << "All TX nodes filtered";
             }
         }
     }
@@ -818,6 +798,69 @@ InboundLedger::trigger(std::shared_ptr<Peer> const& peer, TriggerReason reason)
     }
 }
 
+/** Request map nodes
+    After a reply the nodes are striped across the idle peers of the set.
+    Otherwise they are requested from the given peer, or from all peers.
+    Returns false if nothing was requested.
+*/
+bool
+InboundLedger::requestNodes(
+    protocol::TMGetLedger& tmGL,
+    std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes,
+    std::shared_ptr<Peer> const& peer,
+    TriggerReason reason)
+{
+    char const* const type =
+        (tmGL.itype() == protocol::liAS_NODE) ? "AS" : "TX";
+
+    if (reason != TriggerReason::reply || !peer)
+    {
+        for (auto const& n : nodes)
+            *(tmGL.add_nodeids()) = n.first.getRawString();
+
+        JLOG(journal_.trace())
+            << "Sending " << type << " node request (" << nodes.size()
+            << ") to " << (peer ? "selected peer" : "all peers");
+        mPeerSet->sendRequest(tmGL, peer);
+        return true;
+    }
+
+    std::map<Peer::id_t, std::shared_ptr<Peer>> peers;
+    peers.emplace(peer->id(), peer);
+    for (auto const id : mPeerSet->getPeerIds())
+    {
+        if (auto p = app_.overlay().findPeerByShortID(id))
+            peers.emplace(id, std::move(p));
+    }
+
+    std::vector<Peer::id_t> ids;
+    ids.reserve(peers.size());
+    for (auto const& p : peers)
+        ids.push_back(p.first);
+
+    auto const stripes = mStripes.assign(nodes, ids);
+    for (auto const& [id, stripe] : stripes)
+    {
+        auto const& p = peers[id];
+
+        protocol::TMGetLedger request(tmGL);
+        // If the peer has high latency, query extra deep
+        request.set_querydepth(p->isHighLatency() ? 2 : 1);
+        for (auto const& n : stripe)
+        {
+            *(request.add_nodeids()) = n.first.getRawString();
+            mRecentNodes.insert(n.second);
+        }
+
+        JLOG(journal_.trace())
+            << "Sending " << type << " node stripe (" << stripe.size()
+            << ") to " << p->id();
+        mPeerSet->sendRequest(request, p);
+    }
+
+    return !stripes.empty();
+}
+
 void
 InboundLedger::filterNodes(
     std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
@@ -911,9 +954,13 @@ InboundLedger::takeHeader(std::string const& data)
 
 /** Process node data received from a peer
     Call with a lock
+    nodeIDs holds the ID of each node in the packet
 */
 void
-InboundLedger::receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode& san)
+InboundLedger::receiveNode(
+    protocol::TMLedgerData& packet,
+    std::vector<SHAMapNodeID> const& nodeIDs,
+    SHAMapAddNode& san)
 {
     if (!mHaveHeader)
     {
@@ -952,22 +999,20 @@ InboundLedger::receiveNode(protocol::TMLedgerData& packet, SHAMapAddNode& san)
 
     try
     {
+        std::vector<Slice> rawNodes;
+        rawNodes.reserve(packet.nodes().size());
         for (auto const& node : packet.nodes())
-        {
-            auto const nodeID = deserializeSHAMapNodeID(node.nodeid());
+            rawNodes.push_back(makeSlice(node.nodedata()));
 
-            if (!nodeID)
-            {
-                san.incInvalid();
-                return;
-            }
+        // Verifying the nodes means hashing them: hash them together
+        auto const nodes = SHAMapTreeNode::makeFromWire(rawNodes);
 
-            if (nodeID->isRoot())
-                san += map.addRootNode(
-                    rootHash, makeSlice(node.nodedata()), filter.get());
+        for (std::size_t i = 0; i < nodeIDs.size(); ++i)
+        {
+            if (nodeIDs[i].isRoot())
+                san += map.addRootNode(rootHash, nodes[i], filter.get());
             else
-                san += map.addKnownNode(
-                    *nodeID, makeSlice(node.nodedata()), filter.get());
+                san += map.addKnownNode(nodeIDs[i], nodes[i], filter.get());
 
             if (!san.isGood())
             {
@@ -1185,6 +1230,8 @@ InboundLedger::processData(
         }
 
         // Verify node IDs and data are complete
+        std::vector<SHAMapNodeID> nodeIDs;
+        nodeIDs.reserve(packet.nodes().size());
         for (auto const& node : packet.nodes())
         {
             if (!node.has_nodeid() || !node.has_nodedata())
@@ -1193,10 +1240,19 @@ InboundLedger::processData(
                 peer->charge(Resource::feeInvalidRequest);
                 return -1;
             }
+
+            auto const nodeID = deserializeSHAMapNodeID(node.nodeid());
+            if (!nodeID)
+            {
+                JLOG(journal_.warn()) << "Got bad node ID";
+                peer->charge(Resource::feeInvalidRequest);
+                return -1;
+            }
+            nodeIDs.push_back(*nodeID);
         }
 
         SHAMapAddNode san;
-        receiveNode(packet, san);
+        receiveNode(packet, nodeIDs, san);
 
         if (packet.type() == protocol::liTX_NODE)
         {
@@ -1210,6 +1266,9 @@ InboundLedger::processData(
         if (san.isUseful())
             progress_ = true;
 
+        // Only a reply to the peer's stripe measures its throughput
+        mStripes.onReply(peer->id(), nodeIDs, san.getGood());
+
         mStats += san;
         return san.getGood();
     }
@@ -231,20 +231,21 @@ public:
     void
     gotStaleData(std::shared_ptr<protocol::TMLedgerData> packet_ptr) override
     {
-        const uint256 uZero;
         Serializer s;
         try
         {
-            for (int i = 0; i < packet_ptr->nodes().size(); ++i)
+            std::vector<Slice> rawNodes;
+            rawNodes.reserve(packet_ptr->nodes().size());
+            for (auto const& node : packet_ptr->nodes())
             {
-                auto const& node = packet_ptr->nodes(i);
-
                 if (!node.has_nodeid() || !node.has_nodedata())
                     return;
 
-                auto newNode =
-                    SHAMapTreeNode::makeFromWire(makeSlice(node.nodedata()));
+                rawNodes.push_back(makeSlice(node.nodedata()));
+            }
 
+            for (auto const& newNode : SHAMapTreeNode::makeFromWire(rawNodes))
+            {
                 if (!newNode)
                     return;
 
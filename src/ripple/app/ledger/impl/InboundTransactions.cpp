@@ -19,6 +19,7 @@
 
 #include <ripple/app/ledger/InboundLedgers.h>
 #include <ripple/app/ledger/InboundTransactions.h>
+#include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/impl/TransactionAcquire.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
@@ -26,6 +27,8 @@
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/RippleLedgerHash.h>
 #include <ripple/resource/Fees.h>
+#include <boost/optional.hpp>
+#include <chrono>
 #include <memory>
 #include <mutex>
 
@@ -46,6 +49,8 @@ public:
     std::uint32_t mSeq;
     TransactionAcquire::pointer mAcquire;
     std::shared_ptr<SHAMap> mSet;
+    // When we started acquiring the set
+    std::chrono::steady_clock::time_point mAcquireStart;
 
     InboundTransactionSet(std::uint32_t seq, std::shared_ptr<SHAMap> const& set)
         : mSeq(seq), mSet(set)
@@ -127,6 +132,7 @@ public:
             auto& obj = m_map[hash];
             obj.mAcquire = ta;
             obj.mSeq = m_seq;
+            obj.mAcquireStart = std::chrono::steady_clock::now();
         }
 
         ta->init(startPeers);
@@ -192,6 +198,7 @@ public:
         bool fromAcquire) override
     {
         bool isNew = true;
+        boost::optional<std::chrono::steady_clock::duration> acquireTime;
 
         {
             std::lock_guard sl(mLock);
@@ -206,11 +213,25 @@ public:
             else
                 inboundSet.mSet = set;
 
+            if (isNew && fromAcquire && inboundSet.mAcquire)
+                acquireTime = std::chrono::steady_clock::now() -
+                    inboundSet.mAcquireStart;
+
             inboundSet.mAcquire.reset();
         }
 
+        if (acquireTime)
+            app_.getLedgerMaster().notePhase(
+                perf::LedgerPhase::acquire,
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    *acquireTime));
+
         if (isNew)
+        {
+            if (!fromAcquire)
+                cacheInnerNodes(*set);
             m_gotSet(set, fromAcquire);
+        }
     }
 
     void
@@ -252,6 +273,29 @@ public:
     }
 
 private:
+    /** Make the inner nodes of a locally built set available to acquires.
+
+        Proposed sets usually differ from ours by only a few transactions.
+        Acquisitions consult the temporary node cache through their sync
+        filter before asking peers, so with our inner nodes cached only the
+        branches that actually differ are fetched, and leaves we already
+        hold are supplied by the transaction master.
+    */
+    void
+    cacheInnerNodes(SHAMap const& set)
+    {
+        auto& cache = app_.getTempNodeCache();
+        set.visitNodes([&cache](SHAMapTreeNode& node) {
+            if (node.isInner())
+            {
+                Serializer s;
+                node.serializeWithPrefix(s);
+                cache.insert(node.getHash(), s.peekData());
+            }
+            return true;
+        });
+    }
+
     using MapType = hash_map<uint256, InboundTransactionSet>;
 
     std::recursive_mutex mLock;
@@ -282,4 +326,16 @@ make_InboundTransactions(
         app, parent, collector, std::move(gotSet), make_PeerSetBuilder(app));
 }
 
+std::unique_ptr<InboundTransactions>
+make_InboundTransactions(
+    Application& app,
+    Stoppable& parent,
+    beast::insight::Collector::ptr const& collector,
+    std::function<void(std::shared_ptr<SHAMap> const&, bool)> gotSet,
+    std::unique_ptr<PeerSetBuilder> peerSetBuilder)
+{
+    return std::make_unique<InboundTransactionsImp>(
+        app, parent, collector, std::move(gotSet), std::move(peerSetBuilder));
+}
+
 }  // namespace ripple
@@ -0,0 +1,341 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/InboundLedgers.h>
+#include <ripple/app/ledger/LedgerBackfill.h>
+#include <ripple/app/ledger/LedgerReplayer.h>
+#include <ripple/app/ledger/impl/LedgerDeltaAcquire.h>
+#include <ripple/app/ledger/impl/SkipListAcquire.h>
+#include <ripple/core/JobQueue.h>
+
+namespace ripple {
+
+LedgerBackfill::LedgerBackfill(
+    Application& app,
+    InboundLedgers& inboundLedgers,
+    LedgerReplayer& replayer,
+    InboundLedger::Reason r,
+    uint256 const& finishLedgerHash,
+    std::uint32_t totalNumLedgers)
+    : TimeoutCounter(
+          app,
+          finishLedgerHash,
+          LedgerReplayParameters::BACKFILL_TIMEOUT,
+          {jtREPLAY_TASK,
+           "LedgerBackfill",
+           LedgerReplayParameters::MAX_QUEUED_TASKS},
+          app.journal("LedgerBackfill"))
+    , inboundLedgers_(inboundLedgers)
+    , replayer_(replayer)
+    , reason_(r)
+    , totalLedgers_(totalNumLedgers)
+    , depth_(std::max<std::uint32_t>(
+          app.config().LEDGER_REPLAY_BACKFILL_DEPTH,
+          1))
+    , maxBytes_(app.config().LEDGER_REPLAY_BACKFILL_MEMORY * 1024 * 1024)
+    , hashes_(totalNumLedgers)
+    , lowest_(totalNumLedgers - 1)
+{
+    assert(finishLedgerHash.isNonZero() && totalNumLedgers > 0);
+    hashes_[lowest_] = finishLedgerHash;
+    JLOG(journal_.trace()) << "Create " << hash_;
+}
+
+LedgerBackfill::~LedgerBackfill()
+{
+    JLOG(journal_.trace()) << "Destroy " << hash_;
+}
+
+void
+LedgerBackfill::init()
+{
+    JLOG(journal_.debug()) << "Backfill start " << hash_ << ", "
+                           << totalLedgers_ << " ledgers";
+
+    ScopedLockType sl(mtx_);
+    if (!isDone())
+    {
+        walk(sl);
+        setTimer(sl);
+    }
+}
+
+void
+LedgerBackfill::walk(ScopedLockType& sl)
+{
+    // A skip list the local node has calls back from addDataCallback,
+    // so loop instead of recursing through gotSkipList
+    if (walking_)
+        return;
+    walking_ = true;
+    while (!isDone() && !skipList_ && lowest_ > 0)
+    {
+        skipList_ = replayer_.acquireSkipList(hashes_[lowest_]);
+        if (!skipList_)
+        {
+            failed_ = true;
+            break;
+        }
+
+        std::weak_ptr<LedgerBackfill> wptr = shared_from_this();
+        skipList_->addDataCallback([wptr](bool good, uint256 const&) {
+            if (auto sptr = wptr.lock(); sptr)
+                sptr->gotSkipList(good);
+        });
+    }
+    walking_ = false;
+
+    if (!isDone() && lowest_ == 0)
+        trigger(sl);
+}
+
+void
+LedgerBackfill::gotSkipList(bool good)
+{
+    ScopedLockType sl(mtx_);
+    if (isDone() || !skipList_)
+        return;
+
+    auto const data = skipList_->getData();
+    skipList_.reset();
+    if (!good || !data)
+    {
+        failed_ = true;
+        JLOG(journal_.debug()) << "Skip list failed " << hash_;
+        return;
+    }
+
+    if (lowest_ == totalLedgers_ - 1)
+    {
+        if (data->ledgerSeq <= lowest_)
+        {
+            failed_ = true;
+            JLOG(journal_.error()) << "Range too long " << hash_;
+            return;
+        }
+        startSeq_ = data->ledgerSeq - lowest_;
+    }
+    else if (data->ledgerSeq != startSeq_ + lowest_)
+    {
+        failed_ = true;
+        JLOG(journal_.error()) << "Skip list sequence mismatch " << hash_;
+        return;
+    }
+
+    // The skip list ends with the parent of its ledger
+    auto const& sList = data->skipList;
+    auto const count = std::min<std::size_t>(sList.size(), lowest_);
+    if (count == 0)
+    {
+        failed_ = true;
+        JLOG(journal_.error()) << "Skip list too short " << hash_;
+        return;
+    }
+    std::copy(
+        sList.end() - count, sList.end(), hashes_.begin() + lowest_ - count);
+    lowest_ -= count;
+    progress_ = true;
+
+    JLOG(journal_.trace()) << "Backfill " << hash_ << " knows "
+                           << totalLedgers_ - lowest_ << " hashes";
+    walk(sl);
+}
+
+void
+LedgerBackfill::trigger(ScopedLockType& sl)
+{
+    if (lowest_ != 0)
+        return;
+
+    if (!parent_)
+    {
+        parent_ = app_.getLedgerMaster().getLedgerByHash(hashes_[0]);
+        if (!parent_)
+            parent_ = inboundLedgers_.acquire(hashes_[0], startSeq_, reason_);
+        if (!parent_)
+            return;
+
+        JLOG(journal_.debug())
+            << "Got start ledger " << hashes_[0] << " for backfill " << hash_;
+        progress_ = true;
+    }
+
+    fill(sl);
+    if (window_.empty())
+    {
+        complete_ = true;
+        JLOG(journal_.info()) << "Completed " << hash_;
+        return;
+    }
+    scheduleBuild(sl);
+}
+
+void
+LedgerBackfill::fill(ScopedLockType& sl)
+{
+    // The hashes of the range are held until the backfill is done
+    std::size_t bytes = hashes_.size() * sizeof(uint256);
+    for (auto const& delta : window_)
+        bytes += delta->dataSize();
+
+    while (!isDone() && next_ < hashes_.size() && window_.size() < depth_ &&
+           (window_.empty() || bytes < maxBytes_))
+    {
+        auto delta = replayer_.acquireDelta(hashes_[next_], startSeq_ + next_);
+        if (!delta)
+        {
+            failed_ = true;
+            return;
+        }
+
+        window_.push_back(delta);
+        ++next_;
+
+        std::weak_ptr<LedgerBackfill> wptr = shared_from_this();
+        delta->addDataCallback(reason_, [wptr](bool good, uint256 const& hash) {
+            if (auto sptr = wptr.lock(); sptr)
+            {
+                if (!good)
+                    sptr->cancel();
+                else
+                    sptr->deltaReady(hash);
+            }
+        });
+        bytes += delta->dataSize();
+    }
+}
+
+void
+LedgerBackfill::deltaReady(uint256 const& deltaHash)
+{
+    JLOG(journal_.trace()) << "Delta " << deltaHash << " ready for backfill "
+                           << hash_;
+    ScopedLockType sl(mtx_);
+    if (!isDone() && parent_ && !window_.empty())
+        scheduleBuild(sl);
+}
+
+void
+LedgerBackfill::scheduleBuild(ScopedLockType& sl)
+{
+    if (building_)
+    {
+        rebuild_ = true;
+        return;
+    }
+
+    building_ = app_.getJobQueue().addJob(
+        jtREPLAY_TASK,
+        "LedgerBackfillBuild",
+        [wptr = std::weak_ptr<LedgerBackfill>(shared_from_this())](Job&) {
+            if (auto sptr = wptr.lock(); sptr)
+                sptr->build();
+        });
+}
+
+void
+LedgerBackfill::build()
+{
+    ScopedLockType sl(mtx_);
+    while (!isDone() && !window_.empty())
+    {
+        auto const delta = window_.front();
+        auto const parent = parent_;
+        rebuild_ = false;
+
+        // Deltas keep arriving while the ledger is built
+        sl.unlock();
+        std::shared_ptr<Ledger const> ledger;
+        try
+        {
+            ledger = delta->tryBuild(parent);
+        }
+        catch (std::runtime_error const&)
+        {
+            sl.lock();
+            failed_ = true;
+            JLOG(journal_.error())
+                << "Backfill " << hash_ << " failed to build on "
+                << parent->info().hash;
+            break;
+        }
+        sl.lock();
+
+        if (!ledger)
+        {
+            // The front delta is not ready yet, unless it became ready
+            // while the lock was released
+            if (rebuild_)
+                continue;
+            break;
+        }
+
+        parent_ = ledger;
+        window_.pop_front();
+        progress_ = true;
+        JLOG(journal_.debug()) << "Backfill " << hash_ << " built "
+                               << ledger->info().seq << ", "
+                               << hashes_.size() - next_ + window_.size()
+                               << " to go";
+        fill(sl);
+    }
+
+    if (!isDone() && window_.empty() && next_ == hashes_.size())
+    {
+        complete_ = true;
+        JLOG(journal_.info()) << "Completed " << hash_;
+    }
+    building_ = false;
+}
+
+void
+LedgerBackfill::onTimer(bool progress, ScopedLockType& sl)
+{
+    JLOG(journal_.trace()) << "mTimeouts=" << timeouts_ << " for " << hash_;
+
+    // A backfill can run for hours, only a lack of progress counts
+    if (progress)
+        timeouts_ = 0;
+
+    if (timeouts_ > LedgerReplayParameters::BACKFILL_MAX_TIMEOUTS)
+    {
+        failed_ = true;
+        JLOG(journal_.debug())
+            << "LedgerBackfill Failed, too many timeouts " << hash_;
+    }
+    else
+    {
+        trigger(sl);
+    }
+}
+
+std::weak_ptr<TimeoutCounter>
+LedgerBackfill::pmDowncast()
+{
+    return shared_from_this();
+}
+
+bool
+LedgerBackfill::finished() const
+{
+    ScopedLockType sl(mtx_);
+    return isDone();
+}
+
+}  // namespace ripple
@@ -23,6 +23,8 @@
 #include <ripple/app/ledger/LedgerReplayer.h>
 #include <ripple/app/ledger/impl/LedgerDeltaAcquire.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/misc/HashRouter.h>
+#include <ripple/app/tx/apply.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/overlay/PeerSet.h>
 
@@ -154,6 +156,9 @@ LedgerDeltaAcquire::processData(
         {
             complete_ = true;
             orderedTxns_ = std::move(orderedTxns);
+            for (auto const& [index, tx] : orderedTxns_)
+                dataSize_ += tx->getSerializer().size();
+            checkSignatures(sl);
             JLOG(journal_.debug()) << "ready to replay " << hash_;
             notify(sl);
             return;
@@ -220,6 +225,47 @@ LedgerDeltaAcquire::tryBuild(std::shared_ptr<Ledger const> const& parent)
     }
 }
 
+std::size_t
+LedgerDeltaAcquire::dataSize() const
+{
+    ScopedLockType sl(mtx_);
+    if (fullLedger_ || failed_)
+        return 0;
+    return complete_ ? dataSize_ : LedgerReplayParameters::DELTA_SIZE_ESTIMATE;
+}
+
+void
+LedgerDeltaAcquire::checkSignatures(ScopedLockType& sl)
+{
+    if (orderedTxns_.empty())
+        return;
+
+    std::vector<std::shared_ptr<STTx const>> txns;
+    txns.reserve(orderedTxns_.size());
+    for (auto const& [index, tx] : orderedTxns_)
+        txns.push_back(tx);
+
+    app_.getJobQueue().addJob(
+        jtREPLAY_TASK,
+        "checkReplaySigs",
+        [txns = std::move(txns), &app = app_](Job&) {
+            auto& router = app.getHashRouter();
+            for (auto const& tx : txns)
+            {
+                // The transactions were verified against the ledger hash,
+                // so a signature that is not fully canonical is still good.
+                // One that fails is left for the build to report.
+                if (tx->checkSign(STTx::RequireFullyCanonicalSig::no).first)
+                {
+                    forceValidity(
+                        router,
+                        tx->getTransactionID(),
+                        Validity::SigGoodOnly);
+                }
+            }
+        });
+}
+
 void
 LedgerDeltaAcquire::onLedgerBuilt(
     ScopedLockType& sl,
@@ -248,6 +294,10 @@ LedgerDeltaAcquire::onLedgerBuilt(
                     case InboundLedger::Reason::GENERIC:
                         app.getLedgerMaster().storeLedger(ledger);
                         break;
+                    case InboundLedger::Reason::HISTORY:
+                        app.getLedgerMaster().setFullLedger(
+                            ledger, false, false);
+                        break;
                     default:
                         // TODO for other use cases
                         break;
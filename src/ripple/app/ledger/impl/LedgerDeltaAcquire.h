@@ -101,6 +101,13 @@ public:
     std::shared_ptr<Ledger const>
     tryBuild(std::shared_ptr<Ledger const> const& parent);
 
+    /**
+     * Return the serialized size of the transactions held for the build,
+     * or an estimate of it while the delta is being acquired
+     */
+    std::size_t
+    dataSize() const;
+
     /**
      * Add a reason and a callback to the LedgerDeltaAcquire subtask.
      * The reason is used to process the ledger once it is replayed.
@@ -152,12 +159,21 @@ private:
     void
     notify(ScopedLockType& sl);
 
+    /**
+     * Check the signatures of the transactions in a job, ahead of the
+     * build, which then finds them checked in the HashRouter
+     * @param sl  lock. this function must be called with the lock
+     */
+    void
+    checkSignatures(ScopedLockType& sl);
+
     InboundLedgers& inboundLedgers_;
     std::uint32_t const ledgerSeq_;
     std::unique_ptr<PeerSet> peerSet_;
     std::shared_ptr<Ledger const> replayTemp_ = {};
     std::shared_ptr<Ledger const> fullLedger_ = {};
     std::map<std::uint32_t, std::shared_ptr<STTx const>> orderedTxns_;
+    std::size_t dataSize_ = 0;
     std::vector<OnDeltaDataCB> dataReadyCallbacks_;
     std::set<InboundLedger::Reason> reasons_;
     std::uint32_t noFeaturePeerCount = 0;
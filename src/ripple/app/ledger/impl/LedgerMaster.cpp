@@ -55,6 +55,7 @@
 #include <cassert>
 #include <chrono>
 #include <cstdlib>
+#include <future>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -202,6 +203,7 @@ LedgerMaster::LedgerMaster(
           std::chrono::seconds{45},
           stopwatch,
           app_.journal("TaggedCache"))
+    , fetch_pack_diffs_(stopwatch)
     , m_stats(std::bind(&LedgerMaster::collect_metrics, this), collector)
 {
 }
@@ -402,6 +404,8 @@ LedgerMaster::setValidLedger(std::shared_ptr<Ledger const> const& l)
                 app_.getOPs().clearAmendmentWarned();
         }
     }
+
+    prebuildFetchPack(l);
 }
 
 void
@@ -1850,6 +1854,15 @@ LedgerMaster::sweep()
 {
     mLedgerHistory.sweep();
     fetch_packs_.sweep();
+
+    std::lock_guard lock(fetch_pack_diffs_mutex_);
+    auto const expired = fetch_pack_diffs_.clock().now() - fetchPackDiffAge;
+    for (auto it = fetch_pack_diffs_.chronological.begin();
+         it != fetch_pack_diffs_.chronological.end() && it.when() <= expired;)
+    {
+        fetch_pack_diff_bytes_ -= it->second.bytes;
+        it = fetch_pack_diffs_.erase(it);
+    }
 }
 
 float
@@ -1902,6 +1915,11 @@ LedgerMaster::fetchForHistory(
     {
         assert(hash->isNonZero());
         auto ledger = getLedgerByHash(*hash);
+        if (!ledger && reason == InboundLedger::Reason::HISTORY &&
+            backfillForHistory(missing, *hash))
+        {
+            return;
+        }
         if (!ledger)
         {
             if (!app_.getInboundLedgers().isFailure(*hash))
@@ -2013,6 +2031,40 @@ LedgerMaster::fetchForHistory(
     }
 }
 
+bool
+LedgerMaster::backfillForHistory(std::uint32_t missing, uint256 const& hash)
+{
+    if (!app_.config().LEDGER_REPLAY ||
+        app_.config().LEDGER_REPLAY_BACKFILL_DEPTH == 0)
+        return false;
+
+    // Replay starts from the closest ledger we have below the gap or, if
+    // there is none, from the oldest ledger we should have, which is
+    // acquired in full.
+    std::uint32_t const validSeq = mValidLedgerSeq;
+    std::uint32_t start =
+        (validSeq > ledger_history_) ? validSeq - ledger_history_ : 0;
+    if (auto const minimumOnline = app_.getSHAMapStore().minimumOnline())
+        start = std::min(start, *minimumOnline);
+    start = std::max(start, app_.getNodeStore().earliestLedgerSeq());
+    {
+        std::lock_guard ml(mCompleteLock);
+        for (auto const& interval : mCompleteLedgers)
+        {
+            if (interval.last() >= missing)
+                break;
+            start = std::max(start, interval.last());
+        }
+    }
+    if (start >= missing)
+        return false;
+
+    auto const total = std::min<std::uint32_t>(
+        missing - start + 1, LedgerReplayParameters::MAX_BACKFILL_SIZE);
+    return app_.getLedgerReplayer().backfill(
+        InboundLedger::Reason::HISTORY, hash, total);
+}
+
 // Try to publish ledgers, acquire missing ledgers
 void
 LedgerMaster::doAdvance(std::unique_lock<std::recursive_mutex>& sl)
@@ -2103,6 +2155,7 @@ LedgerMaster::doAdvance(std::unique_lock<std::recursive_mutex>& sl)
 
                 {
                     ScopedUnlock sul{sl};
+                    ScopedLedgerPhase timer{*this, perf::LedgerPhase::publish};
                     app_.getOPs().pubLedger(ledger);
                 }
             }
@@ -2116,20 +2169,106 @@ LedgerMaster::doAdvance(std::unique_lock<std::recursive_mutex>& sl)
 }
 
 void
+LedgerMaster::notePhase(
+    perf::LedgerPhase phase,
+    std::chrono::microseconds duration)
+{
+    app_.getPerfLog().ledgerPhase(phase, duration);
+    m_stats.phases[static_cast<std::size_t>(phase)].notify(duration);
+}
+
+bool
 LedgerMaster::addFetchPack(uint256 const& hash, std::shared_ptr<Blob> data)
+{
+    if (sha512Half(makeSlice(*data)) != hash)
+        return false;
+    stashFetchPack(hash, std::move(data));
+    return true;
+}
+
+void
+LedgerMaster::stashFetchPack(uint256 const& hash, std::shared_ptr<Blob> data)
 {
     fetch_packs_.canonicalize_replace_client(hash, data);
 }
 
+std::size_t
+LedgerMaster::addFetchPack(
+    std::pair<uint256, std::shared_ptr<Blob>> const* objects,
+    std::size_t count)
+{
+    std::vector<Slice> data;
+    data.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        data.push_back(makeSlice(*objects[i].second));
+
+    std::vector<uint256> hashes(count);
+    sha512HalfBatch(data.data(), hashes.data(), count);
+
+    std::size_t bad = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (hashes[i] == objects[i].first)
+            stashFetchPack(objects[i].first, objects[i].second);
+        else
+            ++bad;
+    }
+    return bad;
+}
+
+void
+LedgerMaster::addFetchPack(
+    std::vector<std::pair<uint256, std::shared_ptr<Blob>>> objects,
+    std::function<void(std::size_t)> onDone)
+{
+    // The number of objects each job verifies
+    static std::size_t constexpr batchSize = 256;
+
+    if (objects.size() <= batchSize)
+    {
+        onDone(addFetchPack(objects.data(), objects.size()));
+        return;
+    }
+
+    struct Pack
+    {
+        std::vector<std::pair<uint256, std::shared_ptr<Blob>>> objects;
+        std::function<void(std::size_t)> onDone;
+        std::atomic<std::size_t> remaining;
+        std::atomic<std::size_t> bad{0};
+    };
+
+    auto const batches = (objects.size() + batchSize - 1) / batchSize;
+    auto pack = std::make_shared<Pack>();
+    pack->objects = std::move(objects);
+    pack->onDone = std::move(onDone);
+    pack->remaining = batches;
+
+    for (std::size_t i = 0; i < batches; ++i)
+    {
+        auto verify = [this, pack, first = i * batchSize]() {
+            auto const count =
+                std::min(batchSize, pack->objects.size() - first);
+            pack->bad += addFetchPack(pack->objects.data() + first, count);
+            if (--pack->remaining == 0)
+                pack->onDone(pack->bad);
+        };
+
+        if (!app_.getJobQueue().addJob(
+                jtLEDGER_DATA, "addFetchPack", [verify](Job&) { verify(); }))
+            verify();
+    }
+}
+
 boost::optional<Blob>
 LedgerMaster::getFetchPack(uint256 const& hash)
 {
+    // Objects are verified when they are stashed
     Blob data;
     if (fetch_packs_.retrieve(hash, data))
     {
         fetch_packs_.del(hash, false);
-        if (hash == sha512Half(makeSlice(data)))
-            return data;
+        return data;
     }
     return boost::none;
 }
@@ -2212,6 +2351,9 @@ LedgerMaster::makeFetchPack(
     UptimeClock::time_point uptime)
 {
     using namespace std::chrono_literals;
+
+    fetch_pack_requested_ = uptime.time_since_epoch().count();
+
     if (UptimeClock::now() > uptime + 1s)
     {
         JLOG(m_journal.info()) << "Fetch pack request got stale";
@@ -2267,8 +2409,6 @@ LedgerMaster::makeFetchPack(
 
     try
     {
-        Serializer hdr(128);
-
         protocol::TMGetObjectByHash reply;
         reply.set_query(false);
 
@@ -2279,39 +2419,14 @@ LedgerMaster::makeFetchPack(
         reply.set_type(protocol::TMGetObjectByHash::otFETCH_PACK);
 
         // Building a fetch pack:
-        //  1. Add the header for the requested ledger.
-        //  2. Add the nodes for the AccountStateMap of that ledger.
-        //  3. If there are transactions, add the nodes for the
-        //     transactions of the ledger.
-        //  4. If the FetchPack now contains at least 512 entries then stop.
-        //  5. If not very much time has elapsed, then loop back and repeat
+        //  1. Add the part for the requested ledger (see getFetchPackDiff).
+        //  2. If the FetchPack now contains at least 512 entries then stop.
+        //  3. If not very much time has elapsed, then loop back and repeat
         //     the same process adding the previous ledger to the FetchPack.
         do
         {
-            std::uint32_t lSeq = want->info().seq;
-
-            {
-                // Serialize the ledger header:
-                hdr.erase();
-
-                hdr.add32(HashPrefix::ledgerMaster);
-                addRaw(want->info(), hdr);
-
-                // Add the data
-                protocol::TMIndexedObject* obj = reply.add_objects();
-                obj->set_hash(
-                    want->info().hash.data(), want->info().hash.size());
-                obj->set_data(hdr.getDataPtr(), hdr.getLength());
-                obj->set_ledgerseq(lSeq);
-            }
-
-            populateFetchPack(
-                want->stateMap(), &have->stateMap(), 16384, &reply, lSeq);
-
-            // We use nullptr here because transaction maps are per ledger
-            // and so the requestor is unlikely to already have it.
-            if (want->info().txHash.isNonZero())
-                populateFetchPack(want->txMap(), nullptr, 512, &reply, lSeq);
+            auto const diff = getFetchPackDiff(*have, *want);
+            reply.mutable_objects()->MergeFrom(diff->objects());
 
             if (reply.objects().size() >= 512)
                 break;
@@ -2334,6 +2449,159 @@ LedgerMaster::makeFetchPack(
     }
 }
 
+/** Build the part of a fetch pack covering one ledger.
+
+    The part holds:
+     1. The header of the ledger.
+     2. The nodes of its state map which its child does not have.
+     3. If there are transactions, the nodes of its transaction map.
+*/
+static std::shared_ptr<protocol::TMGetObjectByHash>
+makeFetchPackDiff(Ledger const& have, Ledger const& want)
+{
+    auto diff = std::make_shared<protocol::TMGetObjectByHash>();
+    std::uint32_t const lSeq = want.info().seq;
+
+    {
+        // Serialize the ledger header:
+        Serializer hdr(128);
+        hdr.add32(HashPrefix::ledgerMaster);
+        addRaw(want.info(), hdr);
+
+        // Add the data
+        protocol::TMIndexedObject* obj = diff->add_objects();
+        obj->set_hash(want.info().hash.data(), want.info().hash.size());
+        obj->set_data(hdr.getDataPtr(), hdr.getLength());
+        obj->set_ledgerseq(lSeq);
+    }
+
+    populateFetchPack(
+        want.stateMap(), &have.stateMap(), 16384, diff.get(), lSeq);
+
+    // We use nullptr here because transaction maps are per ledger
+    // and so the requestor is unlikely to already have it.
+    if (want.info().txHash.isNonZero())
+        populateFetchPack(want.txMap(), nullptr, 512, diff.get(), lSeq);
+
+    return diff;
+}
+
+/** Return the part of a fetch pack covering one ledger.
+
+    Parts are cached, so serving peers that are catching up from the same
+    ledger does not walk the same maps again. A part is built without
+    holding the cache's lock; peers asking for a part while it is being
+    built wait for that build rather than starting their own.
+*/
+std::shared_ptr<protocol::TMGetObjectByHash>
+LedgerMaster::getFetchPackDiff(Ledger const& have, Ledger const& want)
+{
+    assert(have.info().parentHash == want.info().hash);
+
+    auto const& key = have.info().hash;
+    std::promise<std::shared_ptr<protocol::TMGetObjectByHash>> promise;
+
+    {
+        std::unique_lock lock(fetch_pack_diffs_mutex_);
+
+        if (auto it = fetch_pack_diffs_.find(key);
+            it != fetch_pack_diffs_.end())
+        {
+            fetch_pack_diffs_.touch(it);
+            return it->second.objects;
+        }
+
+        if (auto it = fetch_pack_diffs_building_.find(key);
+            it != fetch_pack_diffs_building_.end())
+        {
+            auto const building = it->second;
+            lock.unlock();
+            return building.get();
+        }
+
+        fetch_pack_diffs_building_.emplace(key, promise.get_future().share());
+    }
+
+    std::shared_ptr<protocol::TMGetObjectByHash> diff;
+    try
+    {
+        diff = makeFetchPackDiff(have, want);
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard lock(fetch_pack_diffs_mutex_);
+            fetch_pack_diffs_building_.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    std::size_t bytes = 0;
+    for (auto const& obj : diff->objects())
+        bytes += obj.data().size();
+
+    {
+        std::lock_guard lock(fetch_pack_diffs_mutex_);
+        fetch_pack_diffs_building_.erase(key);
+
+        // Make room for the new part, oldest first
+        while (!fetch_pack_diffs_.empty() &&
+               fetch_pack_diff_bytes_ + bytes > fetchPackDiffBytes)
+        {
+            auto const oldest = fetch_pack_diffs_.chronological.begin();
+            fetch_pack_diff_bytes_ -= oldest->second.bytes;
+            fetch_pack_diffs_.erase(oldest);
+        }
+
+        if (bytes <= fetchPackDiffBytes)
+        {
+            fetch_pack_diffs_.emplace(key, FetchPackDiff{diff, bytes});
+            fetch_pack_diff_bytes_ += bytes;
+        }
+    }
+
+    promise.set_value(diff);
+    return diff;
+}
+
+/** Build the part of a fetch pack for the parent of a new validated ledger.
+
+    A peer catching up acquires the newest validated ledger, then asks for
+    a fetch pack starting with its parent. While peers are asking us for
+    fetch packs, the parts they are going to ask for are built ahead of the
+    requests, one for each ledger we validate.
+*/
+void
+LedgerMaster::prebuildFetchPack(std::shared_ptr<Ledger const> const& ledger)
+{
+    using namespace std::chrono_literals;
+
+    auto const now = UptimeClock::now().time_since_epoch();
+    if (fetch_pack_requested_.load() < (now - 1min).count())
+        return;
+
+    if (app_.getFeeTrack().isLoadedLocal())
+        return;
+
+    app_.getJobQueue().addJob(
+        jtPACK, "PrebuildFetchPack", [this, ledger](Job&) {
+            auto const want = getLedgerByHash(ledger->info().parentHash);
+            if (!want)
+                return;
+
+            try
+            {
+                getFetchPackDiff(*ledger, *want);
+            }
+            catch (std::exception const& e)
+            {
+                JLOG(m_journal.warn())
+                    << "Exception building fetch pack: " << e.what();
+            }
+        });
+}
+
 std::size_t
 LedgerMaster::getFetchPackCacheSize() const
 {
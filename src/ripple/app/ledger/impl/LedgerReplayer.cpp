@@ -41,6 +41,7 @@ LedgerReplayer::~LedgerReplayer()
 {
     std::lock_guard<std::mutex> lock(mtx_);
     tasks_.clear();
+    backfills_.clear();
 }
 
 void
@@ -110,6 +111,57 @@ LedgerReplayer::replay(
     task->init();
 }
 
+bool
+LedgerReplayer::backfill(
+    InboundLedger::Reason r,
+    uint256 const& finishLedgerHash,
+    std::uint32_t totalNumLedgers)
+{
+    assert(
+        finishLedgerHash.isNonZero() && totalNumLedgers > 0 &&
+        totalNumLedgers <= LedgerReplayParameters::MAX_BACKFILL_SIZE);
+
+    std::vector<std::shared_ptr<LedgerBackfill>> backfills;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (isStopping())
+            return false;
+        backfills = backfills_;
+    }
+
+    // A backfill which failed is not retried until it is swept, so the
+    // caller falls back to other means meanwhile
+    std::size_t running = 0;
+    for (auto const& b : backfills)
+    {
+        auto const finished = b->finished();
+        if (b->getFinishHash() == finishLedgerHash)
+            return !finished;
+        if (!finished)
+            ++running;
+    }
+    if (running >= LedgerReplayParameters::MAX_BACKFILLS)
+    {
+        JLOG(j_.info()) << "Too many backfills, dropping new backfill "
+                        << finishLedgerHash;
+        return false;
+    }
+
+    JLOG(j_.info()) << "Backfill " << totalNumLedgers
+                    << " ledgers. Finish ledger hash " << finishLedgerHash;
+    auto const backfill = std::make_shared<LedgerBackfill>(
+        app_, inboundLedgers_, *this, r, finishLedgerHash, totalNumLedgers);
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (isStopping())
+            return false;
+        backfills_.push_back(backfill);
+    }
+
+    backfill->init();
+    return true;
+}
+
 void
 LedgerReplayer::createDeltas(std::shared_ptr<LedgerReplayTask> task)
 {
@@ -141,40 +193,68 @@ LedgerReplayer::createDeltas(std::shared_ptr<LedgerReplayTask> task)
              skipListItem != parameter.skipList_.end();
              ++seq, ++skipListItem)
         {
-            std::shared_ptr<LedgerDeltaAcquire> delta;
-            bool newDelta = false;
-            {
-                std::lock_guard<std::mutex> lock(mtx_);
-                if (isStopping())
-                    return;
-                auto i = deltas_.find(*skipListItem);
-                if (i != deltas_.end())
-                    delta = i->second.lock();
-
-                if (!delta)  // cannot find, or found but cannot lock
-                {
-                    delta = std::make_shared<LedgerDeltaAcquire>(
-                        app_,
-                        inboundLedgers_,
-                        *skipListItem,
-                        seq,
-                        peerSetBuilder_->build());
-                    deltas_[*skipListItem] = delta;
-                    newDelta = true;
-                }
-            }
-
+            auto const delta = acquireDelta(*skipListItem, seq);
+            if (!delta)
+                return;
             task->addDelta(delta);
-            if (newDelta)
-                delta->init(1);
         }
     }
 }
 
+std::shared_ptr<SkipListAcquire>
+LedgerReplayer::acquireSkipList(uint256 const& hash)
+{
+    std::shared_ptr<SkipListAcquire> skipList;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (isStopping())
+            return {};
+        auto i = skipLists_.find(hash);
+        if (i != skipLists_.end())
+        {
+            skipList = i->second.lock();
+            if (skipList)
+                return skipList;
+        }
+
+        skipList = std::make_shared<SkipListAcquire>(
+            app_, inboundLedgers_, hash, peerSetBuilder_->build());
+        skipLists_[hash] = skipList;
+    }
+
+    skipList->init(1);
+    return skipList;
+}
+
+std::shared_ptr<LedgerDeltaAcquire>
+LedgerReplayer::acquireDelta(uint256 const& hash, std::uint32_t seq)
+{
+    std::shared_ptr<LedgerDeltaAcquire> delta;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (isStopping())
+            return {};
+        auto i = deltas_.find(hash);
+        if (i != deltas_.end())
+        {
+            delta = i->second.lock();
+            if (delta)
+                return delta;
+        }
+
+        delta = std::make_shared<LedgerDeltaAcquire>(
+            app_, inboundLedgers_, hash, seq, peerSetBuilder_->build());
+        deltas_[hash] = delta;
+    }
+
+    delta->init(1);
+    return delta;
+}
+
 void
 LedgerReplayer::gotSkipList(
     LedgerInfo const& info,
-    std::shared_ptr<SHAMapItem const> const& item)
+    boost::intrusive_ptr<SHAMapItem const> const& item)
 {
     std::shared_ptr<SkipListAcquire> skipList = {};
     {
@@ -220,9 +300,28 @@ LedgerReplayer::gotReplayDelta(
 void
 LedgerReplayer::sweep()
 {
+    std::vector<std::shared_ptr<LedgerBackfill>> finished;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        finished = backfills_;
+    }
+    finished.erase(
+        std::remove_if(
+            finished.begin(),
+            finished.end(),
+            [](auto const& b) { return !b->finished(); }),
+        finished.end());
+
     std::lock_guard<std::mutex> lock(mtx_);
+    for (auto const& b : finished)
+    {
+        JLOG(j_.debug()) << "Sweep backfill " << b->getFinishHash();
+        backfills_.erase(std::find(backfills_.begin(), backfills_.end(), b));
+    }
+
     JLOG(j_.debug()) << "Sweeping, LedgerReplayer has " << tasks_.size()
-                     << " tasks, " << skipLists_.size() << " skipLists, and "
+                     << " tasks, " << backfills_.size() << " backfills, "
+                     << skipLists_.size() << " skipLists, and "
                      << deltas_.size() << " deltas.";
 
     tasks_.erase(
@@ -259,8 +358,10 @@ void
 LedgerReplayer::onStop()
 {
     JLOG(j_.info()) << "Stopping...";
+    std::vector<std::shared_ptr<LedgerBackfill>> backfills;
     {
         std::lock_guard<std::mutex> lock(mtx_);
+        std::swap(backfills, backfills_);
         std::for_each(
             tasks_.begin(), tasks_.end(), [](auto& i) { i->cancel(); });
         tasks_.clear();
@@ -275,6 +376,8 @@ LedgerReplayer::onStop()
         std::for_each(deltas_.begin(), deltas_.end(), lockAndCancel);
         deltas_.clear();
     }
+    std::for_each(
+        backfills.begin(), backfills.end(), [](auto& b) { b->cancel(); });
 
     stopped();
     JLOG(j_.info()) << "Stopped";
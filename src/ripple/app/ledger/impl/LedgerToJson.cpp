@@ -24,9 +24,18 @@
 #include <ripple/core/Pg.h>
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/DeliveredAmount.h>
+#include <ripple/rpc/impl/Tuning.h>
 
 #include <date/date.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+
 namespace ripple {
 
 namespace {
@@ -209,22 +218,26 @@ fillJsonState(Object& json, LedgerFill const& fill)
     auto expanded = isExpanded(fill);
     auto binary = isBinary(fill);
 
-    for (auto const& sle : ledger.sles)
-    {
-        if (fill.type == ltINVALID || sle->getType() == fill.type)
-        {
+    forEachStateJson(
+        ledger,
+        uint256{},
+        std::numeric_limits<std::size_t>::max(),
+        fill.type,
+        fill.context ? &fill.context->app.getJobQueue() : nullptr,
+        ledger.open() ? 1 : RPC::Tuning::stateThreads(),
+        [binary, expanded](SLE const& sle) -> Json::Value {
             if (binary)
             {
-                auto&& obj = appendObject(array);
-                obj[jss::hash] = to_string(sle->key());
-                obj[jss::tx_blob] = serializeHex(*sle);
+                Json::Value obj{Json::objectValue};
+                obj[jss::hash] = to_string(sle.key());
+                obj[jss::tx_blob] = serializeHex(sle);
+                return obj;
             }
-            else if (expanded)
-                array.append(sle->getJson(JsonOptions::none));
-            else
-                array.append(to_string(sle->key()));
-        }
-    }
+            if (expanded)
+                return sle.getJson(JsonOptions::none);
+            return to_string(sle.key());
+        },
+        [&array](Json::Value&& entry) { array.append(entry); });
 }
 
 template <class Object>
@@ -277,8 +290,244 @@ fillJson(Object& json, LedgerFill const& fill)
         fillJsonState(json, fill);
 }
 
+// The keys held under a root branch of the state map share their first
+// four bits.
+int constexpr stateBranches = 16;
+
+uint256
+branchFirstKey(int branch)
+{
+    uint256 key;
+    *key.begin() = static_cast<std::uint8_t>(branch << 4);
+    return key;
+}
+
+// The converted entries of one root branch of the state map
+struct StateBranch
+{
+    struct Entry
+    {
+        // The number of entries visited before this one
+        std::size_t visited;
+        uint256 key;
+        Json::Value json;
+    };
+
+    std::vector<Entry> entries;
+
+    // The number of entries visited, at most one more than the entries left
+    // to return when the branch was converted
+    std::size_t visited = 0;
+
+    // The key of the last entry read, and the number of entries visited up
+    // to and including it
+    uint256 last;
+    std::size_t lastVisited = 0;
+
+    std::exception_ptr error;
+    bool claimed = false;
+    bool done = false;
+};
+
+// The branches of one conversion, shared by the caller and the jobs helping
+// it. A job only reads the ledger while it holds a branch, and the caller
+// does not return while a job holds one, so a job which starts late finds
+// nothing left and touches nothing but this.
+struct StateBranches
+{
+    std::vector<StateBranch> branches{stateBranches};
+
+    // The entries left to return after the branches already emitted
+    std::atomic<std::size_t> remaining;
+    std::atomic<bool> stop{false};
+    std::atomic<int> next;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    // Converts a branch, only called by the holder of the branch
+    std::function<void(StateBranch&, int)> fill;
+
+    StateBranches(std::size_t limit, int firstBranch)
+        : remaining(limit), next(firstBranch)
+    {
+    }
+
+    // Take a branch no one else converts, unless the conversion is over
+    bool
+    claim(int b)
+    {
+        std::lock_guard lock(mutex);
+        if (stop || branches[b].claimed)
+            return false;
+        branches[b].claimed = true;
+        return true;
+    }
+
+    void
+    convert(int b)
+    {
+        fill(branches[b], b);
+        {
+            std::lock_guard lock(mutex);
+            branches[b].done = true;
+        }
+        cv.notify_all();
+    }
+
+    // Convert branches in key order until there are none left
+    void
+    help()
+    {
+        for (int b = next++; b < stateBranches && !stop; b = next++)
+        {
+            if (claim(b))
+                convert(b);
+        }
+    }
+
+    // Stop the conversion and wait for the branches being converted
+    void
+    finish()
+    {
+        std::unique_lock lock(mutex);
+        stop = true;
+        cv.wait(lock, [this] {
+            return std::all_of(
+                branches.begin(), branches.end(), [](auto const& branch) {
+                    return branch.done || !branch.claimed;
+                });
+        });
+    }
+};
+
 }  // namespace
 
+boost::optional<uint256>
+forEachStateJson(
+    ReadView const& ledger,
+    uint256 const& after,
+    std::size_t limit,
+    LedgerEntryType type,
+    JobQueue* jobQueue,
+    unsigned int threads,
+    std::function<Json::Value(SLE const&)> const& convert,
+    std::function<void(Json::Value&&)> const& emit)
+{
+    int const firstBranch = *after.begin() >> 4;
+
+    // Only the keys after `after` are visited in its own branch
+    auto const start = [&](int branch) {
+        return branch == firstBranch ? after : --branchFirstKey(branch);
+    };
+
+    auto const state = std::make_shared<StateBranches>(limit, firstBranch);
+    state->fill = [&ledger, &convert, &start, type, s = state.get()](
+                      StateBranch& branch, int b) {
+        try
+        {
+            auto const end = b + 1 == stateBranches
+                ? ledger.sles.end()
+                : ledger.sles.upper_bound(--branchFirstKey(b + 1));
+            for (auto i = ledger.sles.upper_bound(start(b)); i != end; ++i)
+            {
+                // Entries past those left to return are not converted, the
+                // first of them is only counted for the marker
+                if (s->stop || branch.visited++ >= s->remaining)
+                    break;
+
+                auto const& sle = *i;
+                branch.last = sle->key();
+                branch.lastVisited = branch.visited;
+                if (type == ltINVALID || sle->getType() == type)
+                    branch.entries.push_back(
+                        {branch.visited - 1, sle->key(), convert(*sle)});
+            }
+        }
+        catch (std::exception const&)
+        {
+            branch.error = std::current_exception();
+        }
+    };
+
+    // Wait for the jobs however the branches are consumed
+    struct Finisher
+    {
+        StateBranches& state;
+
+        ~Finisher()
+        {
+            state.finish();
+        }
+    } finisher{*state};
+
+    // The calling thread converts branches too, so it never waits for a
+    // job which has not started
+    threads = std::min<unsigned int>(threads, stateBranches - firstBranch);
+    for (unsigned int t = 1; jobQueue && t < threads; ++t)
+    {
+        if (!jobQueue->addJob(
+                jtSTATE_JSON, "stateJson", [state](Job&) { state->help(); }))
+            break;
+    }
+
+    for (int b = firstBranch; b < stateBranches; ++b)
+    {
+        auto& branch = state->branches[b];
+        if (state->claim(b))
+        {
+            state->convert(b);
+        }
+        else
+        {
+            std::unique_lock lock(state->mutex);
+            state->cv.wait(lock, [&branch] { return branch.done; });
+        }
+
+        if (branch.error)
+            std::rethrow_exception(branch.error);
+
+        std::size_t const remaining = state->remaining;
+        for (auto& entry : branch.entries)
+        {
+            if (entry.visited >= remaining)
+                break;
+            emit(std::move(entry.json));
+        }
+
+        if (branch.visited > remaining)
+        {
+            state->stop = true;
+
+            // Stop before the first entry which was not returned, walking
+            // to it from the closest entry before it whose key is known
+            auto key = start(b);
+            std::size_t visited = 0;
+            for (auto const& entry : branch.entries)
+            {
+                if (entry.visited > remaining)
+                    break;
+                key = entry.key;
+                visited = entry.visited + 1;
+            }
+            if (branch.lastVisited > visited &&
+                branch.lastVisited <= remaining + 1)
+            {
+                key = branch.last;
+                visited = branch.lastVisited;
+            }
+            for (; visited <= remaining; ++visited)
+                key = *ledger.succ(key);
+            return --key;
+        }
+
+        state->remaining -= branch.visited;
+        branch.entries.clear();
+    }
+
+    return boost::none;
+}
+
 void
 addJson(Json::Value& json, LedgerFill const& fill)
 {
@@ -0,0 +1,215 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE  OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/impl/StripeScheduler.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+
+namespace ripple {
+
+StripeScheduler::StripeScheduler(
+    clock_type& clock,
+    std::size_t minStripe,
+    std::size_t maxStripe,
+    std::chrono::milliseconds maxTimeout)
+    : clock_(clock)
+    , minStripe_(minStripe)
+    , maxStripe_(maxStripe)
+    , maxTimeout_(maxTimeout)
+{
+    assert(minStripe_ > 0 && minStripe_ <= maxStripe_);
+}
+
+std::vector<StripeScheduler::Stripe>
+StripeScheduler::assign(
+    std::vector<Node> const& nodes,
+    std::vector<Peer::id_t> const& peers)
+{
+    std::vector<Stripe> result;
+
+    expire();
+
+    std::vector<Node> todo;
+    todo.reserve(nodes.size());
+    std::copy_if(
+        nodes.begin(),
+        nodes.end(),
+        std::back_inserter(todo),
+        [this](auto const& n) { return inFlight_.count(n.second) == 0; });
+    if (todo.empty())
+        return result;
+
+    // Peers never measured are assumed to be as fast as the average
+    double known = 0;
+    std::size_t knownCount = 0;
+    for (auto const& [id, state] : peers_)
+    {
+        if (state.throughput > 0)
+        {
+            known += state.throughput;
+            ++knownCount;
+        }
+    }
+    double const average = (knownCount > 0) ? known / knownCount : 1;
+
+    std::vector<std::pair<double, Peer::id_t>> idle;
+    idle.reserve(peers.size());
+    double total = 0;
+    for (auto const id : peers)
+    {
+        auto const& state = peers_[id];
+        if (state.busy)
+            continue;
+        auto const weight =
+            (state.throughput > 0) ? state.throughput : average;
+        idle.emplace_back(weight, id);
+        total += weight;
+    }
+
+    // The fastest peers are served first
+    std::sort(idle.begin(), idle.end(), [](auto const& a, auto const& b) {
+        return a.first > b.first;
+    });
+
+    auto const now = clock_.now();
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < idle.size() && pos < todo.size(); ++i)
+    {
+        auto const [weight, id] = idle[i];
+
+        auto size = static_cast<std::size_t>(
+            std::lround(todo.size() * weight / total));
+        size = std::clamp(size, minStripe_, maxStripe_);
+
+        // Leave the slower peers a stripe each, if there are enough nodes,
+        // so that their throughput keeps being measured
+        auto const left = todo.size() - pos;
+        auto const reserved = minStripe_ * (idle.size() - i - 1);
+        if (left >= reserved + minStripe_)
+            size = std::min(size, left - reserved);
+        size = std::min(size, left);
+
+        auto& state = peers_[id];
+        state.busy = true;
+        state.sent = now;
+        state.deadline = now + timeout(state, size);
+        state.stripe.clear();
+        state.ids.clear();
+
+        std::vector<Node> stripe(
+            todo.begin() + pos, todo.begin() + pos + size);
+        for (auto const& n : stripe)
+        {
+            state.stripe.push_back(n.second);
+            state.ids.insert(n.first);
+            inFlight_.insert(n.second);
+        }
+        pos += size;
+        result.emplace_back(id, std::move(stripe));
+    }
+
+    return result;
+}
+
+bool
+StripeScheduler::onReply(
+    Peer::id_t peer,
+    std::vector<SHAMapNodeID> const& nodes,
+    std::size_t useful)
+{
+    auto const it = peers_.find(peer);
+    if (it == peers_.end() || !it->second.busy)
+        return false;
+
+    auto& state = it->second;
+    if (std::none_of(nodes.begin(), nodes.end(), [&state](auto const& id) {
+            return state.ids.count(id) != 0;
+        }))
+    {
+        return false;
+    }
+
+    using seconds = std::chrono::duration<double>;
+    auto const elapsed = std::max(
+        std::chrono::duration_cast<seconds>(clock_.now() - state.sent),
+        seconds{0.001});
+    auto const sample = useful / elapsed.count();
+
+    // An exponentially weighted average, quick to follow a slowdown
+    state.throughput = (state.throughput > 0)
+        ? 0.75 * state.throughput + 0.25 * sample
+        : sample;
+    release(state);
+    return true;
+}
+
+void
+StripeScheduler::expire()
+{
+    auto const now = clock_.now();
+    for (auto& [id, state] : peers_)
+    {
+        if (!state.busy || state.deadline > now)
+            continue;
+
+        using seconds = std::chrono::duration<double>;
+        state.throughput = (state.throughput > 0)
+            ? state.throughput / 2
+            : minStripe_ /
+                std::chrono::duration_cast<seconds>(maxTimeout_).count();
+        release(state);
+        ++timeouts_;
+    }
+}
+
+double
+StripeScheduler::throughput(Peer::id_t peer) const
+{
+    auto const it = peers_.find(peer);
+    return (it == peers_.end()) ? 0 : it->second.throughput;
+}
+
+void
+StripeScheduler::release(PeerState& state)
+{
+    for (auto const& hash : state.stripe)
+        inFlight_.erase(hash);
+    state.stripe.clear();
+    state.ids.clear();
+    state.busy = false;
+}
+
+// Twice the time the stripe should take at the peer's throughput
+StripeScheduler::clock_type::duration
+StripeScheduler::timeout(PeerState const& state, std::size_t size) const
+{
+    if (state.throughput <= 0)
+        return maxTimeout_;
+
+    using seconds = std::chrono::duration<double>;
+    auto const expected = std::chrono::duration_cast<clock_type::duration>(
+        seconds{2 * size / state.throughput});
+    return std::clamp<clock_type::duration>(
+        expected, maxTimeout_ / 10, maxTimeout_);
+}
+
+}  // namespace ripple
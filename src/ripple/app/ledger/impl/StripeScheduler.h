@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE  OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_STRIPESCHEDULER_H_INCLUDED
+#define RIPPLE_APP_LEDGER_STRIPESCHEDULER_H_INCLUDED
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/clock/abstract_clock.h>
+#include <ripple/overlay/Peer.h>
+#include <ripple/shamap/SHAMapNodeID.h>
+#include <chrono>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** Splits the nodes an acquisition needs among the peers serving it.
+
+    The missing nodes, in the order the map traversal found them, are cut
+    into contiguous stripes, so that each stripe mostly covers neighbouring
+    subtrees. Each idle peer is given a stripe while nodes remain, sized in
+    proportion to the throughput it has shown: the useful nodes it returned
+    per second, measured over the whole round trip of its earlier stripes.
+
+    A stripe which is not answered by its deadline is dropped: its nodes
+    are free to be given to other peers and the peer's throughput estimate
+    is halved, so one slow peer cannot hold up the others.
+
+    This class is not thread safe, the caller provides the locking.
+*/
+class StripeScheduler
+{
+public:
+    using clock_type = beast::abstract_clock<std::chrono::steady_clock>;
+    using Node = std::pair<SHAMapNodeID, uint256>;
+    using Stripe = std::pair<Peer::id_t, std::vector<Node>>;
+
+    /**
+        @param minStripe The fewest nodes requested from a peer at once
+        @param maxStripe The most nodes requested from a peer at once
+        @param maxTimeout How long a stripe may take, at most
+    */
+    StripeScheduler(
+        clock_type& clock,
+        std::size_t minStripe,
+        std::size_t maxStripe,
+        std::chrono::milliseconds maxTimeout);
+
+    /** Divide nodes among the idle peers.
+
+        Nodes already requested from a peer, and not overdue, are skipped.
+
+        @return The nodes to request from each peer.
+    */
+    std::vector<Stripe>
+    assign(
+        std::vector<Node> const& nodes,
+        std::vector<Peer::id_t> const& peers);
+
+    /** Record a peer's reply to its stripe.
+
+        A reply answers the stripe if it holds a node the stripe asked for.
+        Other replies, to requests sent on a timeout or to every peer, do
+        not measure the stripe's round trip and are ignored.
+
+        @param nodes The IDs of the nodes in the reply
+        @param useful The number of useful nodes in the reply
+        @return true if the reply answered the peer's stripe
+    */
+    bool
+    onReply(
+        Peer::id_t peer,
+        std::vector<SHAMapNodeID> const& nodes,
+        std::size_t useful);
+
+    /** Drop the stripes which are past their deadline. */
+    void
+    expire();
+
+    /** Returns the estimated throughput of a peer in nodes per second,
+        zero if unknown.
+    */
+    double
+    throughput(Peer::id_t peer) const;
+
+    /** Returns the number of stripes which were dropped. */
+    std::size_t
+    timeouts() const
+    {
+        return timeouts_;
+    }
+
+private:
+    struct PeerState
+    {
+        // Useful nodes per second, zero until measured
+        double throughput = 0;
+
+        // The hashes and IDs of the nodes in the stripe in flight, if any
+        std::vector<uint256> stripe;
+        std::set<SHAMapNodeID> ids;
+        bool busy = false;
+        clock_type::time_point sent;
+        clock_type::time_point deadline;
+    };
+
+    void
+    release(PeerState& state);
+
+    clock_type::duration
+    timeout(PeerState const& state, std::size_t size) const;
+
+    clock_type& clock_;
+    std::size_t const minStripe_;
+    std::size_t const maxStripe_;
+    std::chrono::milliseconds const maxTimeout_;
+
+    std::map<Peer::id_t, PeerState> peers_;
+
+    // Nodes in a stripe in flight
+    std::set<uint256> inFlight_;
+
+    std::size_t timeouts_ = 0;
+};
+
+}  // namespace ripple
+
+#endif
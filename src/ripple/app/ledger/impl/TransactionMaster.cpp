@@ -107,7 +107,7 @@ TransactionMaster::fetch(
 
 std::shared_ptr<STTx const>
 TransactionMaster::fetch(
-    std::shared_ptr<SHAMapItem> const& item,
+    boost::intrusive_ptr<SHAMapItem const> const& item,
     SHAMapNodeType type,
     std::uint32_t uCommitLedger)
 {
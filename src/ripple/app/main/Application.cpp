@@ -70,6 +70,7 @@
 #include <ripple/rpc/ShardArchiveHandler.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
 #include <ripple/shamap/NodeFamily.h>
+#include <ripple/shamap/SHAMapItem.h>
 #include <ripple/shamap/ShardFamily.h>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -1387,6 +1388,9 @@ ApplicationImp::setup()
     m_jobQueue->setThreadCount(
         config_->WORKERS, config_->standalone() && !config_->reporting());
 
+    setSHAMapItemSlabLimit(
+        megabytes(config_->getValueFor(SizedItem::itemSlabs)));
+
     if (!config_->standalone())
         timeKeeper_->run(config_->SNTP_SERVERS);
 
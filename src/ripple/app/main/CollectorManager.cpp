@@ -27,6 +27,7 @@ class CollectorManagerImp : public CollectorManager
 public:
     beast::Journal m_journal;
     beast::insight::Collector::ptr m_collector;
+    std::shared_ptr<beast::insight::TextCollector> m_textCollector;
     std::unique_ptr<beast::insight::Groups> m_groups;
 
     CollectorManagerImp(Section const& params, beast::Journal journal)
@@ -39,9 +40,16 @@ public:
             beast::IP::Endpoint const address(beast::IP::Endpoint::from_string(
                 get<std::string>(params, "address")));
             std::string const& prefix(get<std::string>(params, "prefix"));
+            bool const aggregate(get<bool>(params, "aggregate", false));
 
-            m_collector =
-                beast::insight::StatsDCollector::New(address, prefix, journal);
+            m_collector = beast::insight::StatsDCollector::New(
+                address, prefix, aggregate, journal);
+        }
+        else if (server == "prometheus")
+        {
+            m_textCollector = beast::insight::TextCollector::New(
+                get<std::string>(params, "prefix"));
+            m_collector = m_textCollector;
         }
         else
         {
@@ -64,6 +72,12 @@ public:
     {
         return m_groups->get(name);
     }
+
+    std::shared_ptr<beast::insight::TextCollector> const&
+    textCollector() override
+    {
+        return m_textCollector;
+    }
 };
 
 //------------------------------------------------------------------------------
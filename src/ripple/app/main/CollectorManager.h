@@ -37,6 +37,12 @@ public:
     collector() = 0;
     virtual beast::insight::Group::ptr const&
     group(std::string const& name) = 0;
+
+    /** Returns the collector metrics are pulled from.
+        @return nullptr unless metrics are pulled.
+    */
+    virtual std::shared_ptr<beast::insight::TextCollector> const&
+    textCollector() = 0;
 };
 
 }  // namespace ripple
@@ -327,6 +327,31 @@ SHAMapStoreImp::copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node)
     return true;
 }
 
+bool
+SHAMapStoreImp::copyAhead(std::shared_ptr<Ledger const> const& ledger)
+{
+    LedgerIndex const seq = ledger->info().seq;
+    JLOG(journal_.debug()) << "copying ahead ledger " << seq;
+
+    // Pace the reads, this runs while the server is serving requests
+    auto const stateMap = ledger->stateMap().snapShot(false);
+    std::uint64_t nodeCount = 0;
+    stateMap->visitNodes([&](SHAMapTreeNode& node) {
+        if (!copyNode(nodeCount, node))
+            return false;
+        if (!(nodeCount % checkHealthInterval_))
+            std::this_thread::sleep_for(backOff_);
+        return true;
+    });
+    if (health())
+        return false;
+
+    JLOG(journal_.debug()) << "copied ahead ledger " << seq << " nodecount "
+                           << nodeCount;
+    copiedState_ = stateMap;
+    return true;
+}
+
 void
 SHAMapStoreImp::run()
 {
@@ -404,11 +429,16 @@ SHAMapStoreImp::run()
 
             JLOG(journal_.debug()) << "copying ledger " << validatedSeq;
             std::uint64_t nodeCount = 0;
-            validatedLedger->stateMap().snapShot(false)->visitNodes(std::bind(
-                &SHAMapStoreImp::copyNode,
-                this,
-                std::ref(nodeCount),
-                std::placeholders::_1));
+            auto const copy = [&](SHAMapTreeNode const& node) {
+                return copyNode(nodeCount, node);
+            };
+            auto const stateMap = validatedLedger->stateMap().snapShot(false);
+            // Nodes shared with a ledger copied ahead are already in the
+            // writable backend
+            if (copiedState_)
+                stateMap->visitDifferences(copiedState_.get(), copy);
+            else
+                stateMap->visitNodes(copy);
             switch (health())
             {
                 case Health::stopping:
@@ -469,9 +499,19 @@ SHAMapStoreImp::run()
 
                     return std::move(newBackend);
                 });
+            copiedState_.reset();
 
             JLOG(journal_.warn()) << "finished rotation " << validatedSeq;
         }
+        else if (!copiedState_ && validatedSeq > lastRotated && !health())
+        {
+            // Spread most of the copying over the rotation interval
+            if (!copyAhead(validatedLedger) && health() == Health::stopping)
+            {
+                stopped();
+                return;
+            }
+        }
     }
 }
 
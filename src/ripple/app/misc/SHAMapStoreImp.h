@@ -101,6 +101,9 @@ private:
     mutable std::condition_variable rendezvous_;
     mutable std::mutex mutex_;
     std::shared_ptr<Ledger const> newLedger_;
+    // State map of a ledger whose nodes were all copied into the writable
+    // backend since the last rotation. Rotating only copies what differs.
+    std::shared_ptr<SHAMap const> copiedState_;
     std::atomic<bool> working_;
     std::atomic<LedgerIndex> canDelete_;
     int fdRequired_ = 0;
@@ -196,6 +199,9 @@ private:
     // callback for visitNodes
     bool
     copyNode(std::uint64_t& nodeCount, SHAMapTreeNode const& node);
+    // Copy a ledger's state into the writable backend ahead of rotation
+    bool
+    copyAhead(std::shared_ptr<Ledger const> const& ledger);
     void
     run();
     void
@@ -21,6 +21,7 @@
 #define RIPPLE_TXQ_H_INCLUDED
 
 #include <ripple/app/tx/applySteps.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/ledger/ApplyView.h>
 #include <ripple/ledger/OpenView.h>
 #include <ripple/protocol/STTx.h>
@@ -723,7 +724,15 @@ private:
     using FeeMultiSet = boost::intrusive::
         multiset<MaybeTx, FeeHook, boost::intrusive::compare<GreaterFee>>;
 
-    using AccountMap = std::map<AccountID, TxQAccount>;
+    /** Lookup of queued accounts.
+
+        Every admission, and every candidate visited by accept(), looks
+        up the submitting account here, so a hash map keeps that O(1)
+        regardless of how many accounts are queued. The hash is seeded
+        per process because the keys are chosen by whoever submits
+        transactions. Nothing depends on the iteration order.
+    */
+    using AccountMap = hardened_hash_map<AccountID, TxQAccount>;
 
     /// Setup parameters used to control the behavior of the queue
     Setup const setup_;
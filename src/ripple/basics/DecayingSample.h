@@ -20,8 +20,11 @@
 #ifndef RIPPLE_BASICS_DECAYINGSAMPLE_H_INCLUDED
 #define RIPPLE_BASICS_DECAYINGSAMPLE_H_INCLUDED
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 
 namespace ripple {
 
@@ -105,6 +108,119 @@ private:
 
 //------------------------------------------------------------------------------
 
+/** A DecayingSample which may be shared between threads without a lock.
+
+    The value and the second it was last aged at are packed in one word and
+    updated together, so concurrent samples are never lost. Time is kept in
+    whole seconds from construction. The value saturates at the largest
+    value a word holds and never drops below zero.
+
+    @tparam The number of seconds in the decay window.
+*/
+template <int Window, typename Clock>
+class AtomicDecayingSample
+{
+public:
+    using value_type = typename Clock::duration::rep;
+    using time_point = typename Clock::time_point;
+
+    AtomicDecayingSample() = delete;
+    AtomicDecayingSample(AtomicDecayingSample const&) = delete;
+    AtomicDecayingSample&
+    operator=(AtomicDecayingSample const&) = delete;
+
+    /**
+        @param now Start time of AtomicDecayingSample.
+    */
+    explicit AtomicDecayingSample(time_point now) : start_(now), state_(0)
+    {
+    }
+
+    /** Add a new sample.
+        The value is first aged according to the specified time.
+    */
+    value_type
+    add(value_type value, time_point now)
+    {
+        auto const when{seconds(now)};
+        auto state{state_.load(std::memory_order_relaxed)};
+        std::uint64_t next;
+        do
+        {
+            std::uint64_t v{decay(state, when)};
+            if (value < 0)
+                v -= std::min<std::uint64_t>(v, -value);
+            else
+                v = std::min<std::uint64_t>(v + value, valueMask);
+            next = (std::max(when, state >> 32) << 32) | v;
+        } while (!state_.compare_exchange_weak(
+            state, next, std::memory_order_relaxed));
+
+        return (next & valueMask) / Window;
+    }
+
+    /** Retrieve the current value in normalized units.
+        The samples are aged according to the specified time.
+    */
+    value_type
+    value(time_point now) const
+    {
+        return decay(state_.load(std::memory_order_relaxed), seconds(now)) /
+            Window;
+    }
+
+    /** Discard all samples. */
+    void
+    clear()
+    {
+        state_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::uint64_t valueMask = 0xffffffff;
+
+    // Whole seconds from construction to the specified time.
+    std::uint64_t
+    seconds(time_point now) const
+    {
+        if (now <= start_)
+            return 0;
+        return std::min<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(now - start_)
+                .count(),
+            valueMask);
+    }
+
+    // Value of a state aged to the specified second.
+    static std::uint64_t
+    decay(std::uint64_t state, std::uint64_t when)
+    {
+        std::uint64_t value{state & valueMask};
+        auto const last{state >> 32};
+        if (value == 0 || when <= last)
+            return value;
+
+        // A span larger than four times the window decays the
+        // value to an insignificant amount so just reset it.
+        //
+        auto elapsed{when - last};
+        if (elapsed > 4 * Window)
+            return 0;
+
+        while (elapsed--)
+            value -= (value + Window - 1) / Window;
+        return value;
+    }
+
+    time_point const start_;
+
+    // Second last aged at in the high word, value in exponential units
+    // in the low word
+    std::atomic<std::uint64_t> state_;
+};
+
+//------------------------------------------------------------------------------
+
 /** Sampling function using exponential decay to provide a continuous value.
     @tparam HalfLife The half life of a sample, in seconds.
 */
@@ -36,6 +36,60 @@ class Journal;
 namespace ripple {
 namespace perf {
 
+/**
+ * Phases of closing a ledger that are timed separately.
+ */
+enum class LedgerPhase {
+    // Acquiring a transaction set proposed by a peer.
+    acquire,
+    // Applying the consensus transactions to the parent ledger.
+    apply,
+    // Hashing modified SHAMap nodes and handing them to the NodeStore.
+    flush,
+    // Signing and sending our validation.
+    validate,
+    // Building the new open ledger from the queue and local transactions.
+    open,
+    // Everything done once consensus is reached, including the above
+    // phases except acquire.
+    accept,
+    // Saving a validated ledger's header and transactions.
+    store,
+    // Publishing a validated ledger to subscribers.
+    publish,
+    count
+};
+
+/**
+ * Name used for a ledger close phase in reports.
+ */
+inline char const*
+ledgerPhaseName(LedgerPhase phase)
+{
+    switch (phase)
+    {
+        case LedgerPhase::acquire:
+            return "acquire";
+        case LedgerPhase::apply:
+            return "apply";
+        case LedgerPhase::flush:
+            return "flush";
+        case LedgerPhase::validate:
+            return "validate";
+        case LedgerPhase::open:
+            return "open";
+        case LedgerPhase::accept:
+            return "accept";
+        case LedgerPhase::store:
+            return "store";
+        case LedgerPhase::publish:
+            return "publish";
+        default:
+            break;
+    }
+    return "invalid";
+}
+
 /**
  * Singleton class that maintains performance counters and optionally
  * writes Json-formatted data to a distinct log. It should exist prior
@@ -126,6 +180,15 @@ public:
     virtual void
     jobFinish(JobType const type, microseconds dur, int instance) = 0;
 
+    /**
+     * Log the duration of one phase of closing a ledger
+     *
+     * @param phase Ledger close phase
+     * @param dur Duration of the phase in microseconds
+     */
+    virtual void
+    ledgerPhase(LedgerPhase const phase, microseconds dur) = 0;
+
     /**
      * Render performance counters in Json
      *
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_SLABALLOCATOR_H_INCLUDED
+#define RIPPLE_BASICS_SLABALLOCATOR_H_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace ripple {
+
+/** Allocates fixed size chunks of memory from large slabs.
+
+    Many small objects of similar size, allocated one at a time from the
+    heap, each pay for the allocator's bookkeeping and alignment. Carving
+    them from slabs packs them together instead.
+
+    Slabs are reserved as they are needed, up to a maximum, and released
+    once none of their chunks are allocated. One empty slab is kept, so
+    allocating and freeing around a slab boundary does not reserve and
+    release it over and over. Once every slab is reserved and no chunk
+    is free, allocate returns nullptr and the caller is expected to use the
+    heap.
+
+    Threads allocate from one of several shards, each with its own lock
+    and slabs, so they rarely contend. A chunk is returned to the shard
+    whose slab holds it.
+*/
+class SlabAllocator
+{
+public:
+    struct Stats
+    {
+        /** Bytes reserved for slabs. */
+        std::size_t reserved = 0;
+
+        /** Bytes in chunks which are allocated. */
+        std::size_t used = 0;
+    };
+
+    /** Create an allocator.
+
+        @param chunkSize  The size of each chunk. It is rounded up to keep
+                          every chunk aligned like the heap does.
+        @param slabSize  The size of each slab. It is rounded up to a power
+                         of two.
+        @param maxSize  The largest number of bytes to reserve for slabs.
+        @param shards  The number of shards, or 0 for one per hardware
+                       thread.
+    */
+    SlabAllocator(
+        std::size_t chunkSize,
+        std::size_t slabSize,
+        std::size_t maxSize,
+        std::size_t shards = 0);
+
+    SlabAllocator(SlabAllocator const&) = delete;
+    SlabAllocator&
+    operator=(SlabAllocator const&) = delete;
+
+    /** Release every slab.
+
+        @note Chunks still allocated must not be used or returned after.
+    */
+    ~SlabAllocator();
+
+    std::size_t
+    chunkSize() const
+    {
+        return chunkSize_;
+    }
+
+    /** Returns a chunk, or nullptr if the allocator is exhausted. */
+    void*
+    allocate() noexcept;
+
+    /** Return a chunk obtained from allocate. */
+    void
+    deallocate(void* p) noexcept;
+
+    /** Change the largest number of bytes to reserve for slabs.
+
+        Slabs already reserved beyond the new maximum are released as they
+        empty.
+    */
+    void
+    setMaxSize(std::size_t maxSize);
+
+    Stats
+    stats() const;
+
+private:
+    struct Slab;
+    struct Shard;
+
+    void*
+    allocate(Shard& shard, bool reserve) noexcept;
+
+    void
+    release(Shard& shard, Slab* slab) noexcept;
+
+    std::size_t const chunkSize_;
+    std::size_t const slabSize_;
+
+    // Where the first chunk starts in a slab, after its header
+    std::size_t const offset_;
+
+    std::size_t const shardCount_;
+    std::unique_ptr<Shard[]> shards_;
+
+    std::atomic<std::size_t> maxSlabs_;
+    std::atomic<std::size_t> slabs_{0};
+
+    // Empty slabs kept for reuse
+    std::atomic<std::size_t> empty_{0};
+};
+
+}  // namespace ripple
+
+#endif
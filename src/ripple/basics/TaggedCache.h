@@ -147,6 +147,22 @@ public:
         return m_hits * (100.0f / std::max(1.0f, total));
     }
 
+    /** Returns the number of lookups which found an object. */
+    std::uint64_t
+    getHits()
+    {
+        std::lock_guard lock(m_mutex);
+        return m_hits;
+    }
+
+    /** Returns the number of lookups which did not find an object. */
+    std::uint64_t
+    getMisses()
+    {
+        std::lock_guard lock(m_mutex);
+        return m_misses;
+    }
+
     void
     clear()
     {
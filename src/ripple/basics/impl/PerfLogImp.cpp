@@ -25,6 +25,7 @@
 #include <ripple/json/json_writer.h>
 #include <ripple/json/to_string.h>
 #include <boost/optional.hpp>
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <cstdlib>
@@ -159,11 +160,42 @@ PerfLogImp::Counters::countersJson() const
         jqobj[jss::total] = totalJqJson;
     }
 
+    Json::Value phaseobj(Json::objectValue);
+    for (std::size_t i = 0; i < phases_.size(); ++i)
+    {
+        Phase value;
+        {
+            std::lock_guard lock(phases_[i].mutex);
+            if (!phases_[i].value.count)
+                continue;
+            value = phases_[i].value;
+        }
+
+        Json::Value histogram(Json::objectValue);
+        for (std::size_t b = 0; b < value.histogram.size(); ++b)
+        {
+            if (!value.histogram[b])
+                continue;
+            auto const bound = b + 1 < value.histogram.size()
+                ? std::to_string(std::uint64_t{1} << b)
+                : std::string("inf");
+            histogram[bound] = std::to_string(value.histogram[b]);
+        }
+
+        Json::Value p(Json::objectValue);
+        p[jss::count] = std::to_string(value.count);
+        p[jss::duration_us] = std::to_string(value.duration.count());
+        p[jss::max_us] = std::to_string(value.max.count());
+        p[jss::histogram_ms] = histogram;
+        phaseobj[ledgerPhaseName(static_cast<LedgerPhase>(i))] = p;
+    }
+
     Json::Value counters(Json::objectValue);
-    // Be kind to reporting tools and let them expect rpc and jq objects
-    // even if empty.
+    // Be kind to reporting tools and let them expect rpc, jq and
+    // ledger_close objects even if empty.
     counters[jss::rpc] = rpcobj;
     counters[jss::job_queue] = jqobj;
+    counters[jss::ledger_close] = phaseobj;
     return counters;
 }
 
@@ -428,6 +460,36 @@ PerfLogImp::jobFinish(JobType const type, microseconds dur, int instance)
         counters_.jobs_[instance] = {jtINVALID, steady_time_point()};
 }
 
+void
+PerfLogImp::ledgerPhase(LedgerPhase const phase, microseconds dur)
+{
+    auto const i = static_cast<std::size_t>(phase);
+    if (i >= counters_.phases_.size())
+    {
+        assert(false);
+        return;
+    }
+
+    // Find the histogram bucket: the smallest power of two
+    // milliseconds that exceeds the duration.
+    using Phase = Counters::Phase;
+    std::size_t bucket = 0;
+    for (auto bound = std::chrono::duration_cast<microseconds>(
+             std::chrono::milliseconds{1});
+         bucket + 1 < Phase::buckets && dur >= bound;
+         bound *= 2)
+    {
+        ++bucket;
+    }
+
+    auto& counter = counters_.phases_[i];
+    std::lock_guard lock(counter.mutex);
+    ++counter.value.count;
+    counter.value.duration += dur;
+    counter.value.max = std::max(counter.value.max, dur);
+    ++counter.value.histogram[bucket];
+}
+
 void
 PerfLogImp::resizeJobs(int const resize)
 {
@@ -27,6 +27,7 @@
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/impl/Handler.h>
 #include <boost/asio/ip/host_name.hpp>
+#include <array>
 #include <condition_variable>
 #include <cstdint>
 #include <fstream>
@@ -105,10 +106,30 @@ class PerfLogImp : public PerfLog, Stoppable
             microseconds runningDuration{0};
         };
 
+        /**
+         * Ledger close phase performance counters.
+         */
+        struct Phase
+        {
+            // Bucket i counts durations under 2^i milliseconds that did
+            // not fit a lower bucket. The last bucket is unbounded.
+            static constexpr std::size_t buckets = 14;
+
+            std::uint64_t count{0};
+            // Cumulative and longest duration of the phase.
+            microseconds duration{0};
+            microseconds max{0};
+            std::array<std::uint64_t, buckets> histogram{};
+        };
+
         // rpc_ and jq_ do not need mutex protection because all
         // keys and values are created before more threads are started.
         std::unordered_map<std::string, Locked<Rpc>> rpc_;
         std::unordered_map<JobType, Locked<Jq>> jq_;
+        std::array<
+            Locked<Phase>,
+            static_cast<std::size_t>(LedgerPhase::count)>
+            phases_;
         std::vector<std::pair<JobType, steady_time_point>> jobs_;
         mutable std::mutex jobsMutex_;
         std::unordered_map<std::uint64_t, MethodStart> methods_;
@@ -182,6 +203,8 @@ public:
         int instance) override;
     void
     jobFinish(JobType const type, microseconds dur, int instance) override;
+    void
+    ledgerPhase(LedgerPhase const phase, microseconds dur) override;
 
     Json::Value
     countersJson() const override
@@ -0,0 +1,319 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/SlabAllocator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <thread>
+
+namespace ripple {
+
+// The header at the start of every slab. Slabs are aligned to their size,
+// so the slab holding a chunk is found from the chunk's address.
+struct SlabAllocator::Slab
+{
+    Shard* const shard;
+
+    // Links in the shard's list of every slab
+    Slab* prev = nullptr;
+    Slab* next = nullptr;
+
+    // Links in the shard's list of slabs with chunks to hand out
+    Slab* prevAvailable = nullptr;
+    Slab* nextAvailable = nullptr;
+
+    // Freed chunks, each holding a pointer to the next
+    void* free = nullptr;
+
+    // The part of the slab which was never handed out
+    std::uint8_t* unused;
+    std::uint8_t* const end;
+
+    // The number of chunks allocated
+    std::size_t used = 0;
+
+    Slab(Shard* s, std::uint8_t* first, std::uint8_t* last)
+        : shard(s), unused(first), end(last)
+    {
+    }
+
+    bool
+    full() const
+    {
+        return !free && unused == end;
+    }
+};
+
+struct alignas(64) SlabAllocator::Shard
+{
+    std::mutex mutex;
+    Slab* slabs = nullptr;
+    Slab* available = nullptr;
+    std::size_t used = 0;
+};
+
+namespace {
+
+std::size_t
+roundChunkSize(std::size_t size)
+{
+    constexpr std::size_t align = alignof(std::max_align_t);
+    size = std::max(size, sizeof(void*));
+    return (size + align - 1) / align * align;
+}
+
+std::size_t
+roundSlabSize(std::size_t size)
+{
+    std::size_t s = 1;
+    while (s < size)
+        s <<= 1;
+    return s;
+}
+
+std::size_t
+shardCount(std::size_t shards)
+{
+    if (shards != 0)
+        return shards;
+    return std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 16);
+}
+
+// Spreads threads over the shards in the order they first allocate
+std::size_t
+threadIndex()
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t const index =
+        next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+template <class Slab>
+void
+link(Slab*& head, Slab* slab, Slab* Slab::*prev, Slab* Slab::*next)
+{
+    slab->*prev = nullptr;
+    slab->*next = head;
+    if (head)
+        head->*prev = slab;
+    head = slab;
+}
+
+template <class Slab>
+void
+unlink(Slab*& head, Slab* slab, Slab* Slab::*prev, Slab* Slab::*next)
+{
+    if (slab->*prev)
+        slab->*prev->*next = slab->*next;
+    else
+        head = slab->*next;
+    if (slab->*next)
+        slab->*next->*prev = slab->*prev;
+    slab->*prev = slab->*next = nullptr;
+}
+
+}  // namespace
+
+SlabAllocator::SlabAllocator(
+    std::size_t chunkSize,
+    std::size_t slabSize,
+    std::size_t maxSize,
+    std::size_t shards)
+    : chunkSize_(roundChunkSize(chunkSize))
+    , slabSize_(roundSlabSize(std::max(
+          slabSize,
+          roundChunkSize(sizeof(Slab)) + chunkSize_)))
+    , offset_(roundChunkSize(sizeof(Slab)))
+    , shardCount_(shardCount(shards))
+    , shards_(std::make_unique<Shard[]>(shardCount_))
+    , maxSlabs_(maxSize / slabSize_)
+{
+}
+
+SlabAllocator::~SlabAllocator()
+{
+    for (std::size_t i = 0; i < shardCount_; ++i)
+    {
+        while (auto slab = shards_[i].slabs)
+        {
+            shards_[i].slabs = slab->next;
+            slab->~Slab();
+            ::operator delete(slab, std::align_val_t(slabSize_));
+        }
+    }
+}
+
+void*
+SlabAllocator::allocate() noexcept
+{
+    // Reserve a slab for this thread's shard before taking chunks from
+    // slabs the other shards have reserved
+    auto const home = threadIndex() % shardCount_;
+    if (void* p = allocate(shards_[home], true))
+        return p;
+
+    for (std::size_t i = 1; i < shardCount_; ++i)
+    {
+        if (void* p = allocate(shards_[(home + i) % shardCount_], false))
+            return p;
+    }
+
+    return nullptr;
+}
+
+void*
+SlabAllocator::allocate(Shard& shard, bool reserve) noexcept
+{
+    std::lock_guard lock(shard.mutex);
+
+    Slab* slab = shard.available;
+    bool const fresh = !slab;
+    if (fresh)
+    {
+        if (!reserve)
+            return nullptr;
+
+        auto count = slabs_.load(std::memory_order_relaxed);
+        do
+        {
+            if (count >= maxSlabs_.load(std::memory_order_relaxed))
+                return nullptr;
+        } while (!slabs_.compare_exchange_weak(
+            count, count + 1, std::memory_order_relaxed));
+
+        // Chunks are handed out from the front of a new slab as they are
+        // needed, so pages the slab never uses are never touched.
+        void* mem = ::operator new(
+            slabSize_, std::align_val_t(slabSize_), std::nothrow);
+        if (!mem)
+        {
+            --slabs_;
+            return nullptr;
+        }
+
+        auto const base = static_cast<std::uint8_t*>(mem);
+        auto const chunks = (slabSize_ - offset_) / chunkSize_;
+        slab = new (mem) Slab(
+            &shard, base + offset_, base + offset_ + chunks * chunkSize_);
+        link(shard.slabs, slab, &Slab::prev, &Slab::next);
+        link(
+            shard.available,
+            slab,
+            &Slab::prevAvailable,
+            &Slab::nextAvailable);
+    }
+
+    void* p;
+    if (slab->free)
+    {
+        p = slab->free;
+        slab->free = *static_cast<void**>(p);
+    }
+    else
+    {
+        p = slab->unused;
+        slab->unused += chunkSize_;
+    }
+
+    if (slab->used++ == 0 && !fresh)
+        --empty_;
+    shard.used += chunkSize_;
+
+    if (slab->full())
+        unlink(
+            shard.available,
+            slab,
+            &Slab::prevAvailable,
+            &Slab::nextAvailable);
+
+    return p;
+}
+
+void
+SlabAllocator::deallocate(void* p) noexcept
+{
+    assert(p);
+
+    auto const slab = reinterpret_cast<Slab*>(
+        reinterpret_cast<std::uintptr_t>(p) & ~(slabSize_ - 1));
+    auto& shard = *slab->shard;
+
+    std::lock_guard lock(shard.mutex);
+
+    if (slab->full())
+        link(
+            shard.available,
+            slab,
+            &Slab::prevAvailable,
+            &Slab::nextAvailable);
+
+    *static_cast<void**>(p) = slab->free;
+    slab->free = p;
+    --slab->used;
+    shard.used -= chunkSize_;
+
+    if (slab->used != 0)
+        return;
+
+    // Keep one empty slab for the next allocations, unless the allocator
+    // is over its maximum
+    if (slabs_.load(std::memory_order_relaxed) <=
+        maxSlabs_.load(std::memory_order_relaxed))
+    {
+        std::size_t none = 0;
+        if (empty_.compare_exchange_strong(none, 1))
+            return;
+    }
+
+    release(shard, slab);
+}
+
+void
+SlabAllocator::release(Shard& shard, Slab* slab) noexcept
+{
+    unlink(shard.available, slab, &Slab::prevAvailable, &Slab::nextAvailable);
+    unlink(shard.slabs, slab, &Slab::prev, &Slab::next);
+    slab->~Slab();
+    ::operator delete(slab, std::align_val_t(slabSize_));
+    --slabs_;
+}
+
+void
+SlabAllocator::setMaxSize(std::size_t maxSize)
+{
+    maxSlabs_ = maxSize / slabSize_;
+}
+
+SlabAllocator::Stats
+SlabAllocator::stats() const
+{
+    Stats s;
+    s.reserved = slabs_.load() * slabSize_;
+    for (std::size_t i = 0; i < shardCount_; ++i)
+    {
+        std::lock_guard lock(shards_[i].mutex);
+        s.used += shards_[i].used;
+    }
+    return s;
+}
+
+}  // namespace ripple
@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_INSIGHT_HISTOGRAM_H_INCLUDED
+#define BEAST_INSIGHT_HISTOGRAM_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace beast {
+namespace insight {
+
+/** A histogram of event values which may be recorded into without a lock.
+
+    Buckets are log-linear: values below 2^subBits each have a bucket, and
+    every power of two above is split into 2^(subBits - 1) equal buckets.
+    A recorded value is off by less than 1 / 2^(subBits - 1) of itself.
+    Values past the last bucket are counted in it.
+*/
+class Histogram
+{
+public:
+    /** Sub-bucket resolution, buckets are within 6.25% of their values. */
+    static constexpr int subBits = 5;
+
+    /** Largest power of two with its own buckets. */
+    static constexpr int maxBits = 40;
+
+    static constexpr std::size_t bucketCount =
+        (std::size_t{1} << subBits) +
+        (maxBits - subBits) * (std::size_t{1} << (subBits - 1));
+
+    /** The recorded values at one point in time. */
+    struct Snapshot
+    {
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        std::uint64_t max = 0;
+        std::vector<std::uint64_t> buckets;
+
+        /** Returns the value at or below which the fraction q of the
+            recorded values lie, zero if nothing was recorded.
+        */
+        std::uint64_t
+        percentile(double q) const
+        {
+            if (count == 0)
+                return 0;
+            auto const rank = static_cast<std::uint64_t>(q * (count - 1)) + 1;
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < buckets.size(); ++i)
+            {
+                seen += buckets[i];
+                if (seen >= rank)
+                    return std::min(upperBound(i), max);
+            }
+            return max;
+        }
+    };
+
+    Histogram()
+    {
+        for (auto& bucket : buckets_)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+
+    Histogram(Histogram const&) = delete;
+    Histogram&
+    operator=(Histogram const&) = delete;
+
+    /** Record a value. */
+    void
+    record(std::uint64_t value)
+    {
+        buckets_[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        auto max = max_.load(std::memory_order_relaxed);
+        while (value > max &&
+               !max_.compare_exchange_weak(
+                   max, value, std::memory_order_relaxed))
+            ;
+    }
+
+    /** Returns the recorded values.
+        @param reset `true` to start recording afresh.
+    */
+    Snapshot
+    snapshot(bool reset)
+    {
+        Snapshot s;
+        s.buckets.reserve(bucketCount);
+        auto read = [reset](std::atomic<std::uint64_t>& v) {
+            return reset ? v.exchange(0, std::memory_order_relaxed)
+                         : v.load(std::memory_order_relaxed);
+        };
+        for (auto& bucket : buckets_)
+            s.buckets.push_back(read(bucket));
+        s.count = read(count_);
+        s.sum = read(sum_);
+        s.max = read(max_);
+        return s;
+    }
+
+    /** Returns the index of the bucket holding a value. */
+    static std::size_t
+    bucket(std::uint64_t value)
+    {
+        if (value < (std::uint64_t{1} << subBits))
+            return static_cast<std::size_t>(value);
+
+        int bits = subBits + 1;
+        while (bits < maxBits && (value >> bits) != 0)
+            ++bits;
+        if ((value >> bits) != 0)
+            return bucketCount - 1;
+
+        // The top subBits bits of the value, the leading one excluded
+        auto const sub = static_cast<std::size_t>(
+            (value >> (bits - subBits)) -
+            (std::size_t{1} << (subBits - 1)));
+        return (std::size_t{1} << subBits) +
+            (bits - subBits - 1) * (std::size_t{1} << (subBits - 1)) + sub;
+    }
+
+    /** Returns the largest value counted in a bucket. */
+    static std::uint64_t
+    upperBound(std::size_t index)
+    {
+        if (index < (std::size_t{1} << subBits))
+            return index;
+
+        index -= std::size_t{1} << subBits;
+        auto const shift = static_cast<int>(index >> (subBits - 1)) + 1;
+        auto const sub = (index & ((std::size_t{1} << (subBits - 1)) - 1)) +
+            (std::size_t{1} << (subBits - 1));
+        return ((std::uint64_t{sub} + 1) << shift) - 1;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, bucketCount> buckets_;
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+}  // namespace insight
+}  // namespace beast
+
+#endif
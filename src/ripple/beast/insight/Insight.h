@@ -33,5 +33,6 @@
 #include <ripple/beast/insight/HookImpl.h>
 #include <ripple/beast/insight/NullCollector.h>
 #include <ripple/beast/insight/StatsDCollector.h>
+#include <ripple/beast/insight/TextCollector.h>
 
 #endif
@@ -40,11 +40,14 @@ public:
     /** Create a StatsD collector.
         @param address The IP address and port of the StatsD server.
         @param prefix A string pre-pended before each metric name.
+        @param aggregate Send each event as a count and percentiles once
+                         per interval, instead of every sample.
         @param journal Destination for logging output.
     */
     static std::shared_ptr<StatsDCollector>
     New(IP::Endpoint const& address,
         std::string const& prefix,
+        bool aggregate,
         Journal journal);
 };
 
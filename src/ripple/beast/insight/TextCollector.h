@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef BEAST_INSIGHT_TEXTCOLLECTOR_H_INCLUDED
+#define BEAST_INSIGHT_TEXTCOLLECTOR_H_INCLUDED
+
+#include <ripple/beast/insight/Collector.h>
+
+#include <string>
+
+namespace beast {
+namespace insight {
+
+/** A Collector whose metrics are pulled rather than pushed.
+
+    Metrics are aggregated in process and formatted on request in the
+    Prometheus text exposition format. Counters and meters are reported as
+    running totals, gauges as their current value and events as histograms.
+    Metrics with the same name are summed.
+
+    Reference:
+        https://prometheus.io/docs/instrumenting/exposition_formats/
+*/
+class TextCollector : public Collector
+{
+public:
+    explicit TextCollector() = default;
+
+    /** Create a text collector.
+        @param prefix A string pre-pended before each metric name.
+    */
+    static std::shared_ptr<TextCollector>
+    New(std::string const& prefix);
+
+    /** Returns the current value of every metric.
+        Hooks are called first, so the metrics they update are current.
+    */
+    virtual std::string
+    format() = 0;
+};
+
+}  // namespace insight
+}  // namespace beast
+
+#endif
@@ -21,12 +21,15 @@
 #include <ripple/beast/insight/CounterImpl.h>
 #include <ripple/beast/insight/EventImpl.h>
 #include <ripple/beast/insight/GaugeImpl.h>
+#include <ripple/beast/insight/Histogram.h>
 #include <ripple/beast/insight/HookImpl.h>
 #include <ripple/beast/insight/MeterImpl.h>
 #include <ripple/beast/insight/StatsDCollector.h>
 #include <ripple/beast/net/IPAddressConversion.h>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <deque>
@@ -100,8 +103,6 @@ public:
     void
     flush();
     void
-    do_increment(CounterImpl::value_type amount);
-    void
     do_process() override;
 
 private:
@@ -110,20 +111,19 @@ private:
 
     std::shared_ptr<StatsDCollectorImp> m_impl;
     std::string m_name;
-    CounterImpl::value_type m_value;
-    bool m_dirty;
+    std::atomic<CounterImpl::value_type> m_value;
 };
 
 //------------------------------------------------------------------------------
 
-class StatsDEventImpl : public EventImpl
+class StatsDEventImpl : public EventImpl, public StatsDMetricBase
 {
 public:
     StatsDEventImpl(
         std::string const& name,
         std::shared_ptr<StatsDCollectorImp> const& impl);
 
-    ~StatsDEventImpl() = default;
+    ~StatsDEventImpl() override;
 
     void
     notify(EventImpl::value_type const& value) override;
@@ -131,7 +131,9 @@ public:
     void
     do_notify(EventImpl::value_type const& value);
     void
-    do_process();
+    flush();
+    void
+    do_process() override;
 
 private:
     StatsDEventImpl&
@@ -139,6 +141,8 @@ private:
 
     std::shared_ptr<StatsDCollectorImp> m_impl;
     std::string m_name;
+    bool const m_aggregate;
+    Histogram m_histogram;
 };
 
 //------------------------------------------------------------------------------
@@ -160,10 +164,6 @@ public:
     void
     flush();
     void
-    do_set(GaugeImpl::value_type value);
-    void
-    do_increment(GaugeImpl::difference_type amount);
-    void
     do_process() override;
 
 private:
@@ -173,8 +173,7 @@ private:
     std::shared_ptr<StatsDCollectorImp> m_impl;
     std::string m_name;
     GaugeImpl::value_type m_last_value;
-    GaugeImpl::value_type m_value;
-    bool m_dirty;
+    std::atomic<GaugeImpl::value_type> m_value;
 };
 
 //------------------------------------------------------------------------------
@@ -194,8 +193,6 @@ public:
     void
     flush();
     void
-    do_increment(MeterImpl::value_type amount);
-    void
     do_process() override;
 
 private:
@@ -204,8 +201,7 @@ private:
 
     std::shared_ptr<StatsDCollectorImp> m_impl;
     std::string m_name;
-    MeterImpl::value_type m_value;
-    bool m_dirty;
+    std::atomic<MeterImpl::value_type> m_value;
 };
 
 //------------------------------------------------------------------------------
@@ -223,6 +219,7 @@ private:
     Journal m_journal;
     IP::Endpoint m_address;
     std::string m_prefix;
+    bool const m_aggregate;
     boost::asio::io_service m_io_service;
     boost::optional<boost::asio::io_service::work> m_work;
     boost::asio::io_service::strand m_strand;
@@ -245,10 +242,12 @@ public:
     StatsDCollectorImp(
         IP::Endpoint const& address,
         std::string const& prefix,
+        bool aggregate,
         Journal journal)
         : m_journal(journal)
         , m_address(address)
         , m_prefix(prefix)
+        , m_aggregate(aggregate)
         , m_work(std::ref(m_io_service))
         , m_strand(m_io_service)
         , m_timer(m_io_service)
@@ -331,6 +330,12 @@ public:
         return m_prefix;
     }
 
+    bool
+    aggregate() const
+    {
+        return m_aggregate;
+    }
+
     void
     do_post_buffer(std::string const& buffer)
     {
@@ -516,7 +521,7 @@ StatsDHookImpl::do_process()
 StatsDCounterImpl::StatsDCounterImpl(
     std::string const& name,
     std::shared_ptr<StatsDCollectorImp> const& impl)
-    : m_impl(impl), m_name(name), m_value(0), m_dirty(false)
+    : m_impl(impl), m_name(name), m_value(0)
 {
     m_impl->add(*this);
 }
@@ -529,33 +534,21 @@ StatsDCounterImpl::~StatsDCounterImpl()
 void
 StatsDCounterImpl::increment(CounterImpl::value_type amount)
 {
-    m_impl->get_io_service().dispatch(std::bind(
-        &StatsDCounterImpl::do_increment,
-        std::static_pointer_cast<StatsDCounterImpl>(shared_from_this()),
-        amount));
+    m_value.fetch_add(amount, std::memory_order_relaxed);
 }
 
 void
 StatsDCounterImpl::flush()
 {
-    if (m_dirty)
+    if (auto const value = m_value.exchange(0, std::memory_order_relaxed))
     {
-        m_dirty = false;
         std::stringstream ss;
-        ss << m_impl->prefix() << "." << m_name << ":" << m_value << "|c"
+        ss << m_impl->prefix() << "." << m_name << ":" << value << "|c"
            << "\n";
-        m_value = 0;
         m_impl->post_buffer(ss.str());
     }
 }
 
-void
-StatsDCounterImpl::do_increment(CounterImpl::value_type amount)
-{
-    m_value += amount;
-    m_dirty = true;
-}
-
 void
 StatsDCounterImpl::do_process()
 {
@@ -567,13 +560,26 @@ StatsDCounterImpl::do_process()
 StatsDEventImpl::StatsDEventImpl(
     std::string const& name,
     std::shared_ptr<StatsDCollectorImp> const& impl)
-    : m_impl(impl), m_name(name)
+    : m_impl(impl), m_name(name), m_aggregate(impl->aggregate())
 {
+    m_impl->add(*this);
+}
+
+StatsDEventImpl::~StatsDEventImpl()
+{
+    m_impl->remove(*this);
 }
 
 void
 StatsDEventImpl::notify(EventImpl::value_type const& value)
 {
+    if (m_aggregate)
+    {
+        m_histogram.record(
+            std::max<EventImpl::value_type::rep>(value.count(), 0));
+        return;
+    }
+
     m_impl->get_io_service().dispatch(std::bind(
         &StatsDEventImpl::do_notify,
         std::static_pointer_cast<StatsDEventImpl>(shared_from_this()),
@@ -589,12 +595,40 @@ StatsDEventImpl::do_notify(EventImpl::value_type const& value)
     m_impl->post_buffer(ss.str());
 }
 
+// When aggregating, events are summarized once per interval instead of
+// sent one by one
+void
+StatsDEventImpl::flush()
+{
+    if (!m_aggregate)
+        return;
+
+    auto const s = m_histogram.snapshot(true);
+    if (s.count == 0)
+        return;
+
+    std::stringstream ss;
+    auto const name = m_impl->prefix() + "." + m_name;
+    ss << name << ".count:" << s.count << "|c\n"
+       << name << ".p50:" << s.percentile(0.50) << "|g\n"
+       << name << ".p90:" << s.percentile(0.90) << "|g\n"
+       << name << ".p99:" << s.percentile(0.99) << "|g\n"
+       << name << ".max:" << s.max << "|g\n";
+    m_impl->post_buffer(ss.str());
+}
+
+void
+StatsDEventImpl::do_process()
+{
+    flush();
+}
+
 //------------------------------------------------------------------------------
 
 StatsDGaugeImpl::StatsDGaugeImpl(
     std::string const& name,
     std::shared_ptr<StatsDCollectorImp> const& impl)
-    : m_impl(impl), m_name(name), m_last_value(0), m_value(0), m_dirty(false)
+    : m_impl(impl), m_name(name), m_last_value(0), m_value(0)
 {
     m_impl->add(*this);
 }
@@ -607,70 +641,51 @@ StatsDGaugeImpl::~StatsDGaugeImpl()
 void
 StatsDGaugeImpl::set(GaugeImpl::value_type value)
 {
-    m_impl->get_io_service().dispatch(std::bind(
-        &StatsDGaugeImpl::do_set,
-        std::static_pointer_cast<StatsDGaugeImpl>(shared_from_this()),
-        value));
+    m_value.store(value, std::memory_order_relaxed);
 }
 
 void
 StatsDGaugeImpl::increment(GaugeImpl::difference_type amount)
 {
-    m_impl->get_io_service().dispatch(std::bind(
-        &StatsDGaugeImpl::do_increment,
-        std::static_pointer_cast<StatsDGaugeImpl>(shared_from_this()),
-        amount));
+    GaugeImpl::value_type value(m_value.load(std::memory_order_relaxed));
+    GaugeImpl::value_type next;
+    do
+    {
+        next = value;
+        if (amount > 0)
+        {
+            GaugeImpl::value_type const d(
+                static_cast<GaugeImpl::value_type>(amount));
+            next +=
+                (d >= std::numeric_limits<GaugeImpl::value_type>::max() - value)
+                ? std::numeric_limits<GaugeImpl::value_type>::max() - value
+                : d;
+        }
+        else if (amount < 0)
+        {
+            GaugeImpl::value_type const d(
+                static_cast<GaugeImpl::value_type>(-amount));
+            next = (d >= value) ? 0 : value - d;
+        }
+    } while (!m_value.compare_exchange_weak(
+        value, next, std::memory_order_relaxed));
 }
 
+// Only changes since the last flush are sent
 void
 StatsDGaugeImpl::flush()
 {
-    if (m_dirty)
+    auto const value = m_value.load(std::memory_order_relaxed);
+    if (value != m_last_value)
     {
-        m_dirty = false;
+        m_last_value = value;
         std::stringstream ss;
-        ss << m_impl->prefix() << "." << m_name << ":" << m_value << "|g"
+        ss << m_impl->prefix() << "." << m_name << ":" << value << "|g"
            << "\n";
         m_impl->post_buffer(ss.str());
     }
 }
 
-void
-StatsDGaugeImpl::do_set(GaugeImpl::value_type value)
-{
-    m_value = value;
-
-    if (m_value != m_last_value)
-    {
-        m_last_value = m_value;
-        m_dirty = true;
-    }
-}
-
-void
-StatsDGaugeImpl::do_increment(GaugeImpl::difference_type amount)
-{
-    GaugeImpl::value_type value(m_value);
-
-    if (amount > 0)
-    {
-        GaugeImpl::value_type const d(
-            static_cast<GaugeImpl::value_type>(amount));
-        value +=
-            (d >= std::numeric_limits<GaugeImpl::value_type>::max() - m_value)
-            ? std::numeric_limits<GaugeImpl::value_type>::max() - m_value
-            : d;
-    }
-    else if (amount < 0)
-    {
-        GaugeImpl::value_type const d(
-            static_cast<GaugeImpl::value_type>(-amount));
-        value = (d >= value) ? 0 : value - d;
-    }
-
-    do_set(value);
-}
-
 void
 StatsDGaugeImpl::do_process()
 {
@@ -682,7 +697,7 @@ StatsDGaugeImpl::do_process()
 StatsDMeterImpl::StatsDMeterImpl(
     std::string const& name,
     std::shared_ptr<StatsDCollectorImp> const& impl)
-    : m_impl(impl), m_name(name), m_value(0), m_dirty(false)
+    : m_impl(impl), m_name(name), m_value(0)
 {
     m_impl->add(*this);
 }
@@ -695,33 +710,21 @@ StatsDMeterImpl::~StatsDMeterImpl()
 void
 StatsDMeterImpl::increment(MeterImpl::value_type amount)
 {
-    m_impl->get_io_service().dispatch(std::bind(
-        &StatsDMeterImpl::do_increment,
-        std::static_pointer_cast<StatsDMeterImpl>(shared_from_this()),
-        amount));
+    m_value.fetch_add(amount, std::memory_order_relaxed);
 }
 
 void
 StatsDMeterImpl::flush()
 {
-    if (m_dirty)
+    if (auto const value = m_value.exchange(0, std::memory_order_relaxed))
     {
-        m_dirty = false;
         std::stringstream ss;
-        ss << m_impl->prefix() << "." << m_name << ":" << m_value << "|m"
+        ss << m_impl->prefix() << "." << m_name << ":" << value << "|m"
            << "\n";
-        m_value = 0;
         m_impl->post_buffer(ss.str());
     }
 }
 
-void
-StatsDMeterImpl::do_increment(MeterImpl::value_type amount)
-{
-    m_value += amount;
-    m_dirty = true;
-}
-
 void
 StatsDMeterImpl::do_process()
 {
@@ -736,10 +739,11 @@ std::shared_ptr<StatsDCollector>
 StatsDCollector::New(
     IP::Endpoint const& address,
     std::string const& prefix,
+    bool aggregate,
     Journal journal)
 {
     return std::make_shared<detail::StatsDCollectorImp>(
-        address, prefix, journal);
+        address, prefix, aggregate, journal);
 }
 
 }  // namespace insight
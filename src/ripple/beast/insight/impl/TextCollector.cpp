@@ -0,0 +1,484 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/core/List.h>
+#include <ripple/beast/insight/CounterImpl.h>
+#include <ripple/beast/insight/EventImpl.h>
+#include <ripple/beast/insight/GaugeImpl.h>
+#include <ripple/beast/insight/Histogram.h>
+#include <ripple/beast/insight/HookImpl.h>
+#include <ripple/beast/insight/MeterImpl.h>
+#include <ripple/beast/insight/TextCollector.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace beast {
+namespace insight {
+
+namespace detail {
+
+class TextCollectorImp;
+
+//------------------------------------------------------------------------------
+
+// Metric values gathered for one exposition, by metric name
+struct TextExposition
+{
+    std::map<std::string, CounterImpl::value_type> counters;
+    std::map<std::string, GaugeImpl::value_type> gauges;
+    std::map<std::string, Histogram::Snapshot> histograms;
+};
+
+class TextMetricBase : public List<TextMetricBase>::Node
+{
+public:
+    // Called on every metric before any is collected
+    virtual void
+    do_hook()
+    {
+    }
+
+    virtual void
+    do_collect(TextExposition&)
+    {
+    }
+
+    virtual ~TextMetricBase() = default;
+    TextMetricBase() = default;
+    TextMetricBase(TextMetricBase const&) = delete;
+    TextMetricBase&
+    operator=(TextMetricBase const&) = delete;
+};
+
+//------------------------------------------------------------------------------
+
+class TextHookImpl : public HookImpl, public TextMetricBase
+{
+public:
+    TextHookImpl(
+        HandlerType const& handler,
+        std::shared_ptr<TextCollectorImp> const& impl);
+
+    ~TextHookImpl() override;
+
+    void
+    do_hook() override;
+
+private:
+    std::shared_ptr<TextCollectorImp> m_impl;
+    HandlerType m_handler;
+};
+
+//------------------------------------------------------------------------------
+
+class TextCounterImpl : public CounterImpl, public TextMetricBase
+{
+public:
+    TextCounterImpl(
+        std::string const& name,
+        std::shared_ptr<TextCollectorImp> const& impl);
+
+    ~TextCounterImpl() override;
+
+    void
+    increment(CounterImpl::value_type amount) override;
+
+    void
+    do_collect(TextExposition& e) override;
+
+private:
+    std::shared_ptr<TextCollectorImp> m_impl;
+    std::string m_name;
+    std::atomic<CounterImpl::value_type> m_value;
+};
+
+//------------------------------------------------------------------------------
+
+class TextEventImpl : public EventImpl, public TextMetricBase
+{
+public:
+    TextEventImpl(
+        std::string const& name,
+        std::shared_ptr<TextCollectorImp> const& impl);
+
+    ~TextEventImpl() override;
+
+    void
+    notify(EventImpl::value_type const& value) override;
+
+    void
+    do_collect(TextExposition& e) override;
+
+private:
+    std::shared_ptr<TextCollectorImp> m_impl;
+    std::string m_name;
+    Histogram m_histogram;
+};
+
+//------------------------------------------------------------------------------
+
+class TextGaugeImpl : public GaugeImpl, public TextMetricBase
+{
+public:
+    TextGaugeImpl(
+        std::string const& name,
+        std::shared_ptr<TextCollectorImp> const& impl);
+
+    ~TextGaugeImpl() override;
+
+    void
+    set(GaugeImpl::value_type value) override;
+    void
+    increment(GaugeImpl::difference_type amount) override;
+
+    void
+    do_collect(TextExposition& e) override;
+
+private:
+    std::shared_ptr<TextCollectorImp> m_impl;
+    std::string m_name;
+    std::atomic<GaugeImpl::value_type> m_value;
+};
+
+//------------------------------------------------------------------------------
+
+class TextMeterImpl : public MeterImpl, public TextMetricBase
+{
+public:
+    TextMeterImpl(
+        std::string const& name,
+        std::shared_ptr<TextCollectorImp> const& impl);
+
+    ~TextMeterImpl() override;
+
+    void
+    increment(MeterImpl::value_type amount) override;
+
+    void
+    do_collect(TextExposition& e) override;
+
+private:
+    std::shared_ptr<TextCollectorImp> m_impl;
+    std::string m_name;
+    std::atomic<MeterImpl::value_type> m_value;
+};
+
+//------------------------------------------------------------------------------
+
+class TextCollectorImp
+    : public TextCollector,
+      public std::enable_shared_from_this<TextCollectorImp>
+{
+private:
+    std::string m_prefix;
+    std::recursive_mutex metricsLock_;
+    List<TextMetricBase> metrics_;
+
+public:
+    explicit TextCollectorImp(std::string const& prefix) : m_prefix(prefix)
+    {
+    }
+
+    Hook
+    make_hook(HookImpl::HandlerType const& handler) override
+    {
+        return Hook(
+            std::make_shared<TextHookImpl>(handler, shared_from_this()));
+    }
+
+    Counter
+    make_counter(std::string const& name) override
+    {
+        return Counter(
+            std::make_shared<TextCounterImpl>(name, shared_from_this()));
+    }
+
+    Event
+    make_event(std::string const& name) override
+    {
+        return Event(std::make_shared<TextEventImpl>(name, shared_from_this()));
+    }
+
+    Gauge
+    make_gauge(std::string const& name) override
+    {
+        return Gauge(std::make_shared<TextGaugeImpl>(name, shared_from_this()));
+    }
+
+    Meter
+    make_meter(std::string const& name) override
+    {
+        return Meter(std::make_shared<TextMeterImpl>(name, shared_from_this()));
+    }
+
+    //--------------------------------------------------------------------------
+
+    void
+    add(TextMetricBase& metric)
+    {
+        std::lock_guard _(metricsLock_);
+        metrics_.push_back(metric);
+    }
+
+    void
+    remove(TextMetricBase& metric)
+    {
+        std::lock_guard _(metricsLock_);
+        metrics_.erase(metrics_.iterator_to(metric));
+    }
+
+    // Exposed name of a metric, characters a name may not hold are replaced
+    std::string
+    name(std::string const& metric) const
+    {
+        auto result = m_prefix.empty() ? metric : m_prefix + "_" + metric;
+        for (auto& c : result)
+        {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' &&
+                c != ':')
+                c = '_';
+        }
+        if (result.empty() ||
+            std::isdigit(static_cast<unsigned char>(result.front())))
+            result.insert(0, 1, '_');
+        return result;
+    }
+
+    std::string
+    format() override
+    {
+        TextExposition e;
+        {
+            std::lock_guard _(metricsLock_);
+            for (auto& m : metrics_)
+                m.do_hook();
+            for (auto& m : metrics_)
+                m.do_collect(e);
+        }
+
+        std::stringstream ss;
+        for (auto const& [name, value] : e.counters)
+        {
+            ss << "# TYPE " << name << " counter\n"
+               << name << " " << value << "\n";
+        }
+        for (auto const& [name, value] : e.gauges)
+        {
+            ss << "# TYPE " << name << " gauge\n"
+               << name << " " << value << "\n";
+        }
+        for (auto const& [name, s] : e.histograms)
+        {
+            ss << "# TYPE " << name << " histogram\n";
+            // Buckets are cumulative and every one is listed, so a bucket
+            // keeps its series from one exposition to the next
+            std::uint64_t count = 0;
+            for (std::size_t i = 0; i < s.buckets.size(); ++i)
+            {
+                count += s.buckets[i];
+                ss << name << "_bucket{le=\"" << Histogram::upperBound(i)
+                   << "\"} " << count << "\n";
+            }
+            ss << name << "_bucket{le=\"+Inf\"} " << count << "\n"
+               << name << "_sum " << s.sum << "\n"
+               << name << "_count " << count << "\n";
+        }
+        return ss.str();
+    }
+};
+
+//------------------------------------------------------------------------------
+
+TextHookImpl::TextHookImpl(
+    HandlerType const& handler,
+    std::shared_ptr<TextCollectorImp> const& impl)
+    : m_impl(impl), m_handler(handler)
+{
+    m_impl->add(*this);
+}
+
+TextHookImpl::~TextHookImpl()
+{
+    m_impl->remove(*this);
+}
+
+void
+TextHookImpl::do_hook()
+{
+    m_handler();
+}
+
+//------------------------------------------------------------------------------
+
+TextCounterImpl::TextCounterImpl(
+    std::string const& name,
+    std::shared_ptr<TextCollectorImp> const& impl)
+    : m_impl(impl), m_name(impl->name(name)), m_value(0)
+{
+    m_impl->add(*this);
+}
+
+TextCounterImpl::~TextCounterImpl()
+{
+    m_impl->remove(*this);
+}
+
+void
+TextCounterImpl::increment(CounterImpl::value_type amount)
+{
+    m_value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+void
+TextCounterImpl::do_collect(TextExposition& e)
+{
+    e.counters[m_name] += m_value.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+
+TextEventImpl::TextEventImpl(
+    std::string const& name,
+    std::shared_ptr<TextCollectorImp> const& impl)
+    : m_impl(impl), m_name(impl->name(name))
+{
+    m_impl->add(*this);
+}
+
+TextEventImpl::~TextEventImpl()
+{
+    m_impl->remove(*this);
+}
+
+void
+TextEventImpl::notify(EventImpl::value_type const& value)
+{
+    m_histogram.record(std::max<EventImpl::value_type::rep>(value.count(), 0));
+}
+
+void
+TextEventImpl::do_collect(TextExposition& e)
+{
+    auto s = m_histogram.snapshot(false);
+    auto const [it, inserted] = e.histograms.emplace(m_name, s);
+    if (inserted)
+        return;
+
+    auto& total = it->second;
+    for (std::size_t i = 0; i < s.buckets.size(); ++i)
+        total.buckets[i] += s.buckets[i];
+    total.count += s.count;
+    total.sum += s.sum;
+    total.max = std::max(total.max, s.max);
+}
+
+//------------------------------------------------------------------------------
+
+TextGaugeImpl::TextGaugeImpl(
+    std::string const& name,
+    std::shared_ptr<TextCollectorImp> const& impl)
+    : m_impl(impl), m_name(impl->name(name)), m_value(0)
+{
+    m_impl->add(*this);
+}
+
+TextGaugeImpl::~TextGaugeImpl()
+{
+    m_impl->remove(*this);
+}
+
+void
+TextGaugeImpl::set(GaugeImpl::value_type value)
+{
+    m_value.store(value, std::memory_order_relaxed);
+}
+
+void
+TextGaugeImpl::increment(GaugeImpl::difference_type amount)
+{
+    GaugeImpl::value_type value(m_value.load(std::memory_order_relaxed));
+    GaugeImpl::value_type next;
+    do
+    {
+        if (amount >= 0)
+        {
+            auto const room =
+                std::numeric_limits<GaugeImpl::value_type>::max() - value;
+            next = value +
+                std::min(room, static_cast<GaugeImpl::value_type>(amount));
+        }
+        else
+        {
+            auto const d = static_cast<GaugeImpl::value_type>(-amount);
+            next = (d >= value) ? 0 : value - d;
+        }
+    } while (!m_value.compare_exchange_weak(
+        value, next, std::memory_order_relaxed));
+}
+
+void
+TextGaugeImpl::do_collect(TextExposition& e)
+{
+    e.gauges[m_name] += m_value.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+
+TextMeterImpl::TextMeterImpl(
+    std::string const& name,
+    std::shared_ptr<TextCollectorImp> const& impl)
+    : m_impl(impl), m_name(impl->name(name)), m_value(0)
+{
+    m_impl->add(*this);
+}
+
+TextMeterImpl::~TextMeterImpl()
+{
+    m_impl->remove(*this);
+}
+
+void
+TextMeterImpl::increment(MeterImpl::value_type amount)
+{
+    m_value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+void
+TextMeterImpl::do_collect(TextExposition& e)
+{
+    e.counters[m_name] += m_value.load(std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+//------------------------------------------------------------------------------
+
+std::shared_ptr<TextCollector>
+TextCollector::New(std::string const& prefix)
+{
+    return std::make_shared<detail::TextCollectorImp>(prefix);
+}
+
+}  // namespace insight
+}  // namespace beast
@@ -28,6 +28,8 @@
 #include <ripple/consensus/LedgerTrie.h>
 #include <ripple/protocol/PublicKey.h>
 #include <boost/optional.hpp>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <utility>
 #include <vector>
@@ -325,6 +327,16 @@ class Validations
     // Sequence of the earliest validation to keep from expire
     boost::optional<Seq> toKeep_;
 
+    // Number of trusted full validations for each ledger in byLedger_,
+    // published atomically so that numTrustedForLedger never waits behind
+    // ingestion. Each count is updated in place under mutex_; the map itself
+    // is only copied when a ledger gets its first trusted validation, and
+    // rebuilt when trust changes or sets expire.
+    using TrustedCounts =
+        hash_map<ID, std::shared_ptr<std::atomic<std::size_t>>>;
+    std::shared_ptr<TrustedCounts const> trustedCounts_ =
+        std::make_shared<TrustedCounts const>();
+
     // Represents the ancestry of validated ledgers
     LedgerTrie<Ledger> trie_;
 
@@ -343,6 +355,61 @@ class Validations
     Adaptor adaptor_;
 
 private:
+    // Count the trusted full validations stored for a ledger
+    static std::size_t
+    countTrusted(hash_map<NodeID, Validation> const& vals)
+    {
+        return std::count_if(vals.begin(), vals.end(), [](auto const& v) {
+            return v.second.trusted() && v.second.full();
+        });
+    }
+
+    // Adjust the published count for a single ledger
+    void
+    publishTrusted(
+        std::lock_guard<Mutex> const&,
+        ID const& ledgerID,
+        bool wasCounted,
+        bool isCounted)
+    {
+        if (wasCounted == isCounted)
+            return;
+
+        auto const counts = std::atomic_load(&trustedCounts_);
+        if (auto it = counts->find(ledgerID); it != counts->end())
+        {
+            if (isCounted)
+                ++*it->second;
+            else
+                --*it->second;
+            return;
+        }
+
+        // A count can only be missing for a ledger with no trusted
+        // validations, so this is the first one.
+        assert(isCounted);
+        auto next = std::make_shared<TrustedCounts>(*counts);
+        next->emplace(
+            ledgerID, std::make_shared<std::atomic<std::size_t>>(1));
+        std::atomic_store(
+            &trustedCounts_, std::shared_ptr<TrustedCounts const>{next});
+    }
+
+    // Rebuild and publish the counts for every ledger
+    void
+    publishTrusted(std::lock_guard<Mutex> const&)
+    {
+        auto next = std::make_shared<TrustedCounts>();
+        for (auto const& [id, vals] : byLedger_)
+        {
+            if (auto const count = countTrusted(vals))
+                next->emplace(
+                    id, std::make_shared<std::atomic<std::size_t>>(count));
+        }
+        std::atomic_store(
+            &trustedCounts_, std::shared_ptr<TrustedCounts const>{next});
+    }
+
     // Remove support of a validated ledger
     void
     removeTrie(
@@ -663,7 +730,18 @@ public:
                 return ValStatus::badSeq;
             }
 
-            byLedger_[val.ledgerID()].insert_or_assign(nodeID, val);
+            {
+                auto& vals = byLedger_[val.ledgerID()];
+                auto const it = vals.find(nodeID);
+                bool const wasCounted = it != vals.end() &&
+                    it->second.trusted() && it->second.full();
+                vals.insert_or_assign(nodeID, val);
+                publishTrusted(
+                    lock,
+                    val.ledgerID(),
+                    wasCounted,
+                    val.trusted() && val.full());
+            }
 
             auto const [it, inserted] = current_.emplace(nodeID, val);
             if (!inserted)
@@ -732,6 +810,7 @@ public:
 
         beast::expire(byLedger_, parms_.validationSET_EXPIRES);
         beast::expire(bySequence_, parms_.validationSET_EXPIRES);
+        publishTrusted(lock);
     }
 
     /** Update trust status of validations
@@ -777,6 +856,7 @@ public:
                 }
             }
         }
+        publishTrusted(lock);
     }
 
     Json::Value
@@ -982,23 +1062,20 @@ public:
 
     /** Count the number of trusted full validations for the given ledger
 
+        This reads the most recently published counts and does not acquire
+        mutex_, so it is safe to call frequently while validations are
+        being added from other threads.
+
         @param ledgerID The identifier of ledger of interest
         @return The number of trusted validations
     */
     std::size_t
-    numTrustedForLedger(ID const& ledgerID)
+    numTrustedForLedger(ID const& ledgerID) const
     {
-        std::size_t count = 0;
-        std::lock_guard lock{mutex_};
-        byLedger(
-            lock,
-            ledgerID,
-            [&](std::size_t) {},  // nothing to reserve
-            [&](NodeID const&, Validation const& v) {
-                if (v.trusted() && v.full())
-                    ++count;
-            });
-        return count;
+        auto const counts = std::atomic_load(&trustedCounts_);
+        if (auto it = counts->find(ledgerID); it != counts->end())
+            return it->second->load();
+        return 0;
     }
 
     /**  Get trusted full validations for a specific ledger
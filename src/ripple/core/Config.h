@@ -56,7 +56,8 @@ enum class SizedItem : std::size_t {
     txnDBCache,
     lgrDBCache,
     openFinalLimit,
-    burstSize
+    burstSize,
+    itemSlabs
 };
 
 //  This entire derived class is deprecated.
@@ -188,6 +189,12 @@ public:
     // Enable the experimental Ledger Replay functionality
     bool LEDGER_REPLAY = false;
 
+    // How many ledgers a history backfill fetches ahead of the one it is
+    // building, and how much transaction data (in megabytes) it may hold
+    // while doing so. A depth of 0 disables the backfill.
+    std::uint32_t LEDGER_REPLAY_BACKFILL_DEPTH = 512;
+    std::size_t LEDGER_REPLAY_BACKFILL_MEMORY = 256;
+
     // Work queue limits
     int MAX_TRANSACTIONS = 250;
     static constexpr int MAX_JOB_QUEUE_TX = 1000;
@@ -97,6 +97,7 @@ struct ConfigSection
 #define SECTION_VETO_AMENDMENTS "veto_amendments"
 #define SECTION_WORKERS "workers"
 #define SECTION_LEDGER_REPLAY "ledger_replay"
+#define SECTION_LEDGER_REPLAY_BACKFILL "ledger_replay_backfill"
 
 }  // namespace ripple
 
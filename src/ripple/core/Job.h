@@ -47,6 +47,7 @@ enum JobType {
     jtPROPOSAL_ut,    // A proposal from an untrusted source
     jtREPLAY_TASK,    // A Ledger replay task/subtask
     jtLEDGER_DATA,    // Received data for a ledger we're acquiring
+    jtSTATE_JSON,     // Convert ledger state to JSON for a client
     jtCLIENT,         // A websocket command from the client
     jtRPC,            // A websocket command from the client
     jtUPDATE_PF,      // Update pathfinding requests
@@ -62,6 +62,7 @@ private:
         add(jtPROPOSAL_ut, "untrustedProposal", maxLimit, false, 500ms, 1250ms);
         add(jtREPLAY_TASK, "ledgerReplayTask", maxLimit, false, 0ms, 0ms);
         add(jtLEDGER_DATA, "ledgerData", 2, false, 0ms, 0ms);
+        add(jtSTATE_JSON, "stateJson", 8, false, 0ms, 0ms);
         add(jtCLIENT, "clientCommand", maxLimit, false, 2000ms, 5000ms);
         add(jtRPC, "RPC", maxLimit, false, 0ms, 0ms);
         add(jtUPDATE_PF, "updatePaths", maxLimit, false, 0ms, 0ms);
@@ -41,7 +41,7 @@
 namespace ripple {
 
 // The configurable node sizes are "tiny", "small", "medium", "large", "huge"
-inline constexpr std::array<std::pair<SizedItem, std::array<int, 5>>, 11>
+inline constexpr std::array<std::pair<SizedItem, std::array<int, 5>>, 12>
     sizedItems{{
         // FIXME: We should document each of these items, explaining exactly
         // what
@@ -58,6 +58,7 @@ inline constexpr std::array<std::pair<SizedItem, std::array<int, 5>>, 11>
         {SizedItem::lgrDBCache, {{4, 8, 16, 32, 128}}},
         {SizedItem::openFinalLimit, {{8, 16, 32, 64, 128}}},
         {SizedItem::burstSize, {{4, 8, 16, 32, 48}}},
+        {SizedItem::itemSlabs, {{64, 128, 256, 512, 1024}}},
     }};
 
 // Ensure that the order of entries in the table corresponds to the
@@ -532,6 +533,22 @@ Config::loadFromString(std::string const& fileContents)
     if (getSingleSection(secConfig, SECTION_LEDGER_REPLAY, strTemp, j_))
         LEDGER_REPLAY = beast::lexicalCastThrow<bool>(strTemp);
 
+    if (exists(SECTION_LEDGER_REPLAY_BACKFILL))
+    {
+        auto const sec = section(SECTION_LEDGER_REPLAY_BACKFILL);
+        LEDGER_REPLAY_BACKFILL_DEPTH =
+            sec.value_or("depth", LEDGER_REPLAY_BACKFILL_DEPTH);
+        LEDGER_REPLAY_BACKFILL_MEMORY =
+            sec.value_or("memory", LEDGER_REPLAY_BACKFILL_MEMORY);
+        if (LEDGER_REPLAY_BACKFILL_DEPTH > 0 &&
+            LEDGER_REPLAY_BACKFILL_MEMORY == 0)
+        {
+            Throw<std::runtime_error>(
+                "Invalid " SECTION_LEDGER_REPLAY_BACKFILL
+                ": memory must be at least 1");
+        }
+    }
+
     if (exists(SECTION_REDUCE_RELAY))
     {
         auto sec = section(SECTION_REDUCE_RELAY);
@@ -64,6 +64,12 @@ public:
     std::shared_ptr<SLE const>
     read(Keylet const& k) const override;
 
+    std::shared_ptr<STLedgerEntryView const>
+    readLazy(Keylet const& k) const override
+    {
+        return base_.readLazy(k);
+    }
+
     bool
     open() const override
     {
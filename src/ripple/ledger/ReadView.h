@@ -31,6 +31,7 @@
 #include <ripple/protocol/Protocol.h>
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STLedgerEntryView.h>
 #include <ripple/protocol/STTx.h>
 #include <boost/optional.hpp>
 #include <cassert>
@@ -311,6 +312,19 @@ public:
     virtual std::shared_ptr<SLE const>
     read(Keylet const& k) const = 0;
 
+    /** Return a lazily decoded view of the state item associated with a key.
+
+        This is cheaper than read() for callers which only look at a few
+        fields of the item. The default implementation serializes the
+        item returned by read(); views backed by a SHAMap return a view of
+        the map's data without copying it.
+
+        @return `nullptr` if the key is not present or
+                if the type does not match.
+    */
+    virtual std::shared_ptr<STLedgerEntryView const>
+    readLazy(Keylet const& k) const;
+
     // Accounts in a payment are not allowed to use assets acquired during that
     // payment. The PaymentSandbox tracks the debits, credits, and owner count
     // changes that accounts make during a payment. `balanceHook` adjusts
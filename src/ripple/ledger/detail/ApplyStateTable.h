@@ -46,7 +46,29 @@ private:
         modify,
     };
 
-    using items_t = std::map<key_type, std::pair<Action, std::shared_ptr<SLE>>>;
+    struct Item
+    {
+        Action action;
+        std::shared_ptr<SLE> sle;
+
+        // The entry as it was read from the base view, kept so visiting
+        // the changes and building metadata need not read it again. It is
+        // null for inserted entries and for entries which were replaced or
+        // erased without first being read.
+        std::shared_ptr<SLE const> original;
+
+        Item(
+            Action action_,
+            std::shared_ptr<SLE> sle_,
+            std::shared_ptr<SLE const> original_ = nullptr)
+            : action(action_)
+            , sle(std::move(sle_))
+            , original(std::move(original_))
+        {
+        }
+    };
+
+    using items_t = std::map<key_type, Item>;
 
     items_t items_;
     XRPAmount dropsDestroyed_{0};
@@ -64,6 +86,10 @@ public:
     void
     apply(RawView& to) const;
 
+    /** Apply the changes and the transaction, with metadata, to a view.
+
+        The view must be the one the changes were made against.
+    */
     void
     apply(
         OpenView& to,
@@ -90,6 +116,10 @@ public:
     std::size_t
     size() const;
 
+    /** Call a function for each entry which was inserted, modified or erased.
+
+        The base view must be the one the changes were made against.
+    */
     void
     visit(
         ReadView const& base,
@@ -127,6 +157,9 @@ public:
 private:
     using Mods = hash_map<key_type, std::shared_ptr<SLE>>;
 
+    static std::shared_ptr<SLE const>
+    original(ReadView const& base, items_t::value_type const& item);
+
     static void
     threadItem(TxMeta& meta, std::shared_ptr<SLE> const& to);
 
@@ -33,8 +33,8 @@ ApplyStateTable::apply(RawView& to) const
     to.rawDestroyXRP(dropsDestroyed_);
     for (auto const& item : items_)
     {
-        auto const& sle = item.second.second;
-        switch (item.second.first)
+        auto const& sle = item.second.sle;
+        switch (item.second.action)
         {
             case Action::cache:
                 break;
@@ -57,7 +57,7 @@ ApplyStateTable::size() const
     std::size_t ret = 0;
     for (auto& item : items_)
     {
-        switch (item.second.first)
+        switch (item.second.action)
         {
             case Action::erase:
             case Action::insert:
@@ -81,26 +81,26 @@ ApplyStateTable::visit(
 {
     for (auto& item : items_)
     {
-        switch (item.second.first)
+        switch (item.second.action)
         {
             case Action::erase:
                 func(
                     item.first,
                     true,
-                    to.read(keylet::unchecked(item.first)),
-                    item.second.second);
+                    original(to, item),
+                    item.second.sle);
                 break;
 
             case Action::insert:
-                func(item.first, false, nullptr, item.second.second);
+                func(item.first, false, nullptr, item.second.sle);
                 break;
 
             case Action::modify:
                 func(
                     item.first,
                     false,
-                    to.read(keylet::unchecked(item.first)),
-                    item.second.second);
+                    original(to, item),
+                    item.second.sle);
                 break;
 
             default:
@@ -130,7 +130,7 @@ ApplyStateTable::apply(
         for (auto& item : items_)
         {
             SField const* type;
-            switch (item.second.first)
+            switch (item.second.action)
             {
                 default:
                 case Action::cache:
@@ -145,8 +145,8 @@ ApplyStateTable::apply(
                     type = &sfModifiedNode;
                     break;
             }
-            auto const origNode = to.read(keylet::unchecked(item.first));
-            auto curNode = item.second.second;
+            auto const origNode = original(to, item);
+            auto curNode = item.second.sle;
             if ((type == &sfModifiedNode) && (*curNode == *origNode))
                 continue;
             std::uint16_t nodeType = curNode
@@ -271,8 +271,8 @@ ApplyStateTable::exists(ReadView const& base, Keylet const& k) const
     if (iter == items_.end())
         return base.exists(k);
     auto const& item = iter->second;
-    auto const& sle = item.second;
-    switch (item.first)
+    auto const& sle = item.sle;
+    switch (item.action)
     {
         case Action::erase:
             return false;
@@ -302,11 +302,11 @@ ApplyStateTable::succ(
         if (!next)
             break;
         iter = items_.find(*next);
-    } while (iter != items_.end() && iter->second.first == Action::erase);
+    } while (iter != items_.end() && iter->second.action == Action::erase);
     // Find non-deleted successor in our list
     for (iter = items_.upper_bound(key); iter != items_.end(); ++iter)
     {
-        if (iter->second.first != Action::erase)
+        if (iter->second.action != Action::erase)
         {
             // Found both, return the lower key
             if (!next || next > iter->first)
@@ -328,8 +328,8 @@ ApplyStateTable::read(ReadView const& base, Keylet const& k) const
     if (iter == items_.end())
         return base.read(k);
     auto const& item = iter->second;
-    auto const& sle = item.second;
-    switch (item.first)
+    auto const& sle = item.sle;
+    switch (item.action)
     {
         case Action::erase:
             return nullptr;
@@ -358,12 +358,12 @@ ApplyStateTable::peek(ReadView const& base, Keylet const& k)
             iter,
             piecewise_construct,
             forward_as_tuple(sle->key()),
-            forward_as_tuple(Action::cache, make_shared<SLE>(*sle)));
-        return iter->second.second;
+            forward_as_tuple(Action::cache, make_shared<SLE>(*sle), sle));
+        return iter->second.sle;
     }
     auto const& item = iter->second;
-    auto const& sle = item.second;
-    switch (item.first)
+    auto const& sle = item.sle;
+    switch (item.action)
     {
         case Action::erase:
             return nullptr;
@@ -384,9 +384,9 @@ ApplyStateTable::erase(ReadView const& base, std::shared_ptr<SLE> const& sle)
     if (iter == items_.end())
         LogicError("ApplyStateTable::erase: missing key");
     auto& item = iter->second;
-    if (item.second != sle)
+    if (item.sle != sle)
         LogicError("ApplyStateTable::erase: unknown SLE");
-    switch (item.first)
+    switch (item.action)
     {
         case Action::erase:
             LogicError("ApplyStateTable::erase: double erase");
@@ -396,7 +396,7 @@ ApplyStateTable::erase(ReadView const& base, std::shared_ptr<SLE> const& sle)
             break;
         case Action::cache:
         case Action::modify:
-            item.first = Action::erase;
+            item.action = Action::erase;
             break;
     }
 }
@@ -412,7 +412,7 @@ ApplyStateTable::rawErase(ReadView const& base, std::shared_ptr<SLE> const& sle)
     if (result.second)
         return;
     auto& item = result.first->second;
-    switch (item.first)
+    switch (item.action)
     {
         case Action::erase:
             LogicError("ApplyStateTable::rawErase: double erase");
@@ -422,8 +422,8 @@ ApplyStateTable::rawErase(ReadView const& base, std::shared_ptr<SLE> const& sle)
             break;
         case Action::cache:
         case Action::modify:
-            item.first = Action::erase;
-            item.second = sle;
+            item.action = Action::erase;
+            item.sle = sle;
             break;
     }
 }
@@ -443,7 +443,7 @@ ApplyStateTable::insert(ReadView const& base, std::shared_ptr<SLE> const& sle)
         return;
     }
     auto& item = iter->second;
-    switch (item.first)
+    switch (item.action)
     {
         case Action::cache:
             LogicError("ApplyStateTable::insert: already cached");
@@ -454,8 +454,8 @@ ApplyStateTable::insert(ReadView const& base, std::shared_ptr<SLE> const& sle)
         case Action::erase:
             break;
     }
-    item.first = Action::modify;
-    item.second = sle;
+    item.action = Action::modify;
+    item.sle = sle;
 }
 
 void
@@ -473,18 +473,18 @@ ApplyStateTable::replace(ReadView const& base, std::shared_ptr<SLE> const& sle)
         return;
     }
     auto& item = iter->second;
-    switch (item.first)
+    switch (item.action)
     {
         case Action::erase:
             LogicError("ApplyStateTable::replace: already erased");
         case Action::cache:
-            item.first = Action::modify;
+            item.action = Action::modify;
             break;
         case Action::insert:
         case Action::modify:
             break;
     }
-    item.second = sle;
+    item.sle = sle;
 }
 
 void
@@ -494,15 +494,15 @@ ApplyStateTable::update(ReadView const& base, std::shared_ptr<SLE> const& sle)
     if (iter == items_.end())
         LogicError("ApplyStateTable::update: missing key");
     auto& item = iter->second;
-    if (item.second != sle)
+    if (item.sle != sle)
         LogicError("ApplyStateTable::update: unknown SLE");
-    switch (item.first)
+    switch (item.action)
     {
         case Action::erase:
             LogicError("ApplyStateTable::update: erased");
             break;
         case Action::cache:
-            item.first = Action::modify;
+            item.action = Action::modify;
             break;
         case Action::insert:
         case Action::modify:
@@ -518,6 +518,14 @@ ApplyStateTable::destroyXRP(XRPAmount const& fee)
 
 //------------------------------------------------------------------------------
 
+std::shared_ptr<SLE const>
+ApplyStateTable::original(ReadView const& base, items_t::value_type const& item)
+{
+    if (item.second.original)
+        return item.second.original;
+    return base.read(keylet::unchecked(item.first));
+}
+
 // Insert this transaction to the SLE's threading list
 void
 ApplyStateTable::threadItem(TxMeta& meta, std::shared_ptr<SLE> const& sle)
@@ -564,7 +572,7 @@ ApplyStateTable::getForMod(
         if (iter != items_.end())
         {
             auto const& item = iter->second;
-            if (item.first == Action::erase)
+            if (item.action == Action::erase)
             {
                 // The Destination of an Escrow or a PayChannel may have been
                 // deleted.  In that case the account we're threading to will
@@ -572,8 +580,8 @@ ApplyStateTable::getForMod(
                 JLOG(j.warn()) << "Trying to thread to deleted node";
                 return nullptr;
             }
-            if (item.first != Action::cache)
-                return item.second;
+            if (item.action != Action::cache)
+                return item.sle;
 
             // If it's only cached, then the node is being modified only by
             // metadata; fall through and track it in the mods table.
@@ -319,6 +319,18 @@ RawStateTable::read(ReadView const& base, Keylet const& k) const
     return sle;
 }
 
+std::shared_ptr<STLedgerEntryView const>
+RawStateTable::readLazy(ReadView const& base, Keylet const& k) const
+{
+    // Only the items modified here need to be serialized
+    if (items_.find(k.key) == items_.end())
+        return base.readLazy(k);
+    auto const sle = read(base, k);
+    if (!sle)
+        return nullptr;
+    return std::make_shared<STLedgerEntryView>(*sle);
+}
+
 void
 RawStateTable::destroyXRP(XRPAmount const& fee)
 {
@@ -124,6 +124,15 @@ Rules::operator==(Rules const& other) const
 
 //------------------------------------------------------------------------------
 
+std::shared_ptr<STLedgerEntryView const>
+ReadView::readLazy(Keylet const& k) const
+{
+    auto const sle = read(k);
+    if (!sle)
+        return nullptr;
+    return std::make_shared<STLedgerEntryView>(*sle);
+}
+
 ReadView::sles_type::sles_type(ReadView const& view) : ReadViewFwdRange(view)
 {
 }
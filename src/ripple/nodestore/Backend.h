@@ -159,8 +159,9 @@ public:
 
     /** Returns read and write stats.
 
-        @note The Counters struct is specific to and only used
-              by CassandraBackend.
+        @note Not every backend tracks every counter. Backends that batch
+              writes report how often stores were delayed waiting for a
+              batch to drain.
     */
     virtual std::optional<Counters<std::uint64_t>>
     counters() const
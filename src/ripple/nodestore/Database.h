@@ -58,6 +58,8 @@ public:
         @param parent The parent Stoppable.
         @param scheduler The scheduler to use for performing asynchronous tasks.
         @param readThreads The number of asynchronous read threads to create.
+                           If nonzero, the `read_threads` configuration
+                           setting takes precedence.
         @param config The configuration settings
         @param journal Destination for logging output.
     */
@@ -146,6 +148,23 @@ public:
         std::uint32_t ledgerSeq = 0,
         FetchType fetchType = FetchType::synchronous);
 
+    /** Fetch several node objects at once.
+
+        Backends that can service many keys in one request do so, which is
+        considerably cheaper than issuing the fetches one at a time.
+
+        @note This can be called concurrently.
+        @param hashes The keys of the objects to retrieve.
+        @param ledgerSeq The sequence of the ledger where the objects are
+                         stored.
+        @return The objects, in the same order as `hashes`. Objects that
+                could not be retrieved are `nullptr`.
+    */
+    virtual std::vector<std::shared_ptr<NodeObject>>
+    fetchNodeObjects(
+        std::vector<uint256> const& hashes,
+        std::uint32_t ledgerSeq);
+
     /** Fetch an object without waiting.
         If I/O is required to determine whether or not the object is present,
         `false` is returned. Otherwise, `true` is returned and `object` is set
@@ -269,6 +288,14 @@ protected:
         fetchDurationUs_ += duration;
     }
 
+    // Record the statistics of a batch fetch started at `begin`, the way
+    // the public fetchNodeObject does for a single object. The scheduler
+    // sees the batch as one synchronous read.
+    void
+    reportBatchFetch(
+        std::vector<std::shared_ptr<NodeObject>> const& nodeObjects,
+        std::chrono::steady_clock::time_point begin);
+
 private:
     std::atomic<std::uint64_t> storeCount_{0};
     std::atomic<std::uint64_t> storeSz_{0};
@@ -315,8 +342,7 @@ private:
 
     /** Retrieve backend read and write stats.
 
-        @note The Counters struct is specific to and only used
-              by CassandraBackend.
+        @note Not every backend tracks every counter.
     */
     virtual std::optional<Backend::Counters<std::uint64_t>>
     getCounters() const
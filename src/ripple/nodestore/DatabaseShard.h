@@ -112,6 +112,39 @@ public:
         std::uint32_t shardIndex,
         boost::filesystem::path const& srcDir) = 0;
 
+    /** Import a shard from a shard archive
+
+        The archive is streamed into a new backend beside it. Objects the
+        archive references are copied from its base shard, which must be
+        final in this database. The result is then imported as by
+        importShard.
+
+        @param shardIndex Shard index to import
+        @param archive The shard archive to import from
+        @return true If the shard was successfully imported
+    */
+    virtual bool
+    importShardArchive(
+        std::uint32_t shardIndex,
+        boost::filesystem::path const& archive) = 0;
+
+    /** Write a final shard to a shard archive
+
+        Objects the base shard also holds are only referenced, see
+        NodeStore::ShardArchiveWriter.
+
+        @param shardIndex Shard index to export, the shard must be final
+        @param archive The file to write
+        @param baseIndex Index of a final shard the archive is built
+                         against, zero for none
+        @return true If the archive was written
+    */
+    virtual bool
+    exportShardArchive(
+        std::uint32_t shardIndex,
+        boost::filesystem::path const& archive,
+        std::uint32_t baseIndex) = 0;
+
     /** Fetch a ledger from the shard store
 
         @param hash The key of the ledger to retrieve
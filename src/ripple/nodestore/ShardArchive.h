@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE  OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_SHARDARCHIVE_H_INCLUDED
+#define RIPPLE_NODESTORE_SHARDARCHIVE_H_INCLUDED
+
+#include <ripple/basics/Blob.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/nodestore/Types.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Deduplicated shard archive.
+
+    An archive carries the node objects of one shard, encoded as in the
+    backend and grouped in checksummed chunks, so it can be imported by
+    streaming it straight into a backend and verified chunk by chunk.
+
+    Consecutive shards share most of their state. An archive may name a
+    base shard, usually the previous one. Objects stored in the base shard
+    are left out and only their hashes are listed; the importer copies
+    them from its own copy of the base shard.
+
+    Layout, integers are big endian:
+
+        header      magic "RSNA", version, shard index, base shard index
+                    (zero for none), 4 bytes each
+        chunk       object count (4), payload size (4), payload hash (32),
+                    payload: per object its hash (32), size (4) and
+                    encoded data
+        ...
+        end         object count of zero
+        references  count (4), hash of the list (32), the hashes (32 each)
+*/
+class ShardArchiveWriter
+{
+public:
+    ShardArchiveWriter(
+        std::ostream& os,
+        std::uint32_t shardIndex,
+        std::uint32_t baseIndex);
+
+    ShardArchiveWriter(ShardArchiveWriter const&) = delete;
+    ShardArchiveWriter&
+    operator=(ShardArchiveWriter const&) = delete;
+
+    /** Add an object carried by the archive. */
+    void
+    add(std::shared_ptr<NodeObject> const& object);
+
+    /** Add the hash of an object to be copied from the base shard. */
+    void
+    addReference(uint256 const& hash);
+
+    /** Write the remaining objects and the references.
+
+        @throws std::runtime_error if the stream fails
+    */
+    void
+    finish();
+
+private:
+    void
+    flush();
+
+    std::ostream& os_;
+    std::uint32_t const baseIndex_;
+    Blob payload_;
+    std::uint32_t count_{0};
+    std::vector<uint256> references_;
+};
+
+/** Reads a shard archive from a stream.
+
+    Every chunk is checked against its hash, and every object against its
+    own hash, as it is read.
+*/
+class ShardArchiveReader
+{
+public:
+    /** @throws std::runtime_error if the header is invalid */
+    explicit ShardArchiveReader(std::istream& is);
+
+    ShardArchiveReader(ShardArchiveReader const&) = delete;
+    ShardArchiveReader&
+    operator=(ShardArchiveReader const&) = delete;
+
+    std::uint32_t
+    shardIndex() const
+    {
+        return shardIndex_;
+    }
+
+    /** The shard holding the referenced objects, zero if none. */
+    std::uint32_t
+    baseIndex() const
+    {
+        return baseIndex_;
+    }
+
+    /** Read the objects of the next chunk.
+
+        @return The objects, empty once all chunks were read
+        @throws std::runtime_error if the chunk is corrupt
+    */
+    Batch
+    next();
+
+    /** Read the hashes of the objects held by the base shard.
+
+        May only be called once next() returned no objects.
+
+        @throws std::runtime_error if the list is corrupt
+    */
+    std::vector<uint256>
+    references();
+
+private:
+    Blob
+    read(std::size_t size);
+
+    std::istream& is_;
+    std::uint32_t shardIndex_;
+    std::uint32_t baseIndex_;
+    bool done_{false};
+};
+
+/** Returns `true` if the file starts with a shard archive header. */
+bool
+isShardArchive(boost::filesystem::path const& path);
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
@@ -308,22 +308,43 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
     }
 
     std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
     fetchBatch(std::vector<uint256 const*> const& hashes) override
     {
+        assert(m_db);
+
+        // Let RocksDB look up all the keys in one call, which amortizes
+        // the per-read locking and can coalesce block reads
+        std::vector<rocksdb::Slice> keys;
+        keys.reserve(hashes.size());
+        for (auto const& h : hashes)
+            keys.emplace_back(
+                reinterpret_cast<char const*>(h->data()), m_keyBytes);
+
+        std::vector<std::string> values;
+        auto const statuses =
+            m_db->MultiGet(rocksdb::ReadOptions{}, keys, &values);
+
         std::vector<std::shared_ptr<NodeObject>> results;
         results.reserve(hashes.size());
-        for (auto const& h : hashes)
+        for (std::size_t i = 0; i < hashes.size(); ++i)
         {
             std::shared_ptr<NodeObject> nObj;
-            Status status = fetch(h->begin(), &nObj);
-            if (status != ok)
-                results.push_back({});
-            else
-                results.push_back(nObj);
+            if (statuses[i].ok())
+            {
+                DecodedBlob decoded(
+                    hashes[i]->data(), values[i].data(), values[i].size());
+                if (decoded.wasOk())
+                    nObj = decoded.createObject();
+            }
+            else if (!statuses[i].IsNotFound())
+            {
+                JLOG(m_journal.error()) << statuses[i].ToString();
+            }
+            results.push_back(nObj);
         }
 
         return {results, ok};
@@ -411,6 +432,12 @@ public:
         return m_batch.getWriteLoad();
     }
 
+    std::optional<Counters<std::uint64_t>>
+    counters() const override
+    {
+        return m_batch.counters();
+    }
+
     void
     setDeletePath() override
     {
@@ -41,10 +41,15 @@ BatchWriter::store(std::shared_ptr<NodeObject> const& object)
 {
     std::unique_lock<decltype(mWriteMutex)> sl(mWriteMutex);
 
-    // If the batch has reached its limit, we wait
-    // until the batch writer is finished
-    while (mWriteSet.size() >= batchWriteLimitSize)
-        mWriteCondition.wait(sl);
+    // If the batch has reached its limit, we wait until the batch writer
+    // takes it. The batch being written is not counted, so up to twice
+    // the limit can be held in memory.
+    if (mWriteSet.size() >= batchWriteLimitSize)
+    {
+        ++mWritesDelayed;
+        mWriteCondition.wait(
+            sl, [this] { return mWriteSet.size() < batchWriteLimitSize; });
+    }
 
     mWriteSet.push_back(object);
 
@@ -52,6 +57,9 @@ BatchWriter::store(std::shared_ptr<NodeObject> const& object)
     {
         mWritePending = true;
 
+        // The scheduler may write the batch on this thread before
+        // returning, which takes the lock again
+        sl.unlock();
         m_scheduler.scheduleTask(*this);
     }
 }
@@ -64,6 +72,15 @@ BatchWriter::getWriteLoad()
     return std::max(mWriteLoad, static_cast<int>(mWriteSet.size()));
 }
 
+Backend::Counters<std::uint64_t>
+BatchWriter::counters() const
+{
+    Backend::Counters<std::uint64_t> c;
+    c.writesDelayed = mWritesDelayed;
+    c.writeDurationUs = mWriteDurationUs;
+    return c;
+}
+
 void
 BatchWriter::performScheduledTask()
 {
@@ -86,10 +103,13 @@ BatchWriter::writeBatch()
             assert(mWriteSet.empty());
             mWriteLoad = set.size();
 
+            // Wake any writers waiting for room; they can fill the next
+            // batch while this one is written out
+            mWriteCondition.notify_all();
+
             if (set.empty())
             {
                 mWritePending = false;
-                mWriteCondition.notify_all();
 
                 // VFALCO NOTE Fix this function to not return from the middle
                 return;
@@ -102,8 +122,12 @@ BatchWriter::writeBatch()
 
         m_callback.writeBatch(set);
 
-        report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - before);
+        auto const elapsed = std::chrono::steady_clock::now() - before;
+        mWriteDurationUs +=
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+                .count();
+        report.elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
 
         m_scheduler.onBatchWrite(report);
     }
@@ -20,10 +20,13 @@
 #ifndef RIPPLE_NODESTORE_BATCHWRITER_H_INCLUDED
 #define RIPPLE_NODESTORE_BATCHWRITER_H_INCLUDED
 
+#include <ripple/nodestore/Backend.h>
 #include <ripple/nodestore/Scheduler.h>
 #include <ripple/nodestore/Task.h>
 #include <ripple/nodestore/Types.h>
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 
 namespace ripple {
@@ -65,7 +68,13 @@ public:
     /** Store the object.
 
         This will add to the batch and initiate a scheduled task to
-        write the batch out.
+        write the batch out. New objects accumulate while a previous batch
+        is being written; the caller only blocks if the accumulating batch
+        reaches its limit before the write in progress completes.
+
+        Up to two batches are held at once, the one being written and the
+        one accumulating, so as many as 2 * batchWriteLimitSize objects may
+        be in memory.
     */
     void
     store(std::shared_ptr<NodeObject> const& object);
@@ -74,6 +83,15 @@ public:
     int
     getWriteLoad();
 
+    /** Get write statistics.
+
+        `writesDelayed` counts the calls to store that had to wait for the
+        batch to drain and `writeDurationUs` is the total time spent
+        writing batches.
+    */
+    Backend::Counters<std::uint64_t>
+    counters() const;
+
 private:
     void
     performScheduledTask() override;
@@ -83,8 +101,8 @@ private:
     waitForWriting();
 
 private:
-    using LockType = std::recursive_mutex;
-    using CondvarType = std::condition_variable_any;
+    using LockType = std::mutex;
+    using CondvarType = std::condition_variable;
 
     Callback& m_callback;
     Scheduler& m_scheduler;
@@ -93,6 +111,9 @@ private:
     int mWriteLoad;
     bool mWritePending;
     Batch mWriteSet;
+
+    std::atomic<std::uint64_t> mWritesDelayed{0};
+    std::atomic<std::uint64_t> mWriteDurationUs{0};
 };
 
 }  // namespace NodeStore
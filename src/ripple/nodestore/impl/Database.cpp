@@ -45,6 +45,16 @@ Database::Database(
     if (earliestLedgerSeq_ < 1)
         Throw<std::runtime_error>("Invalid earliest_seq");
 
+    // Each read thread keeps one request outstanding on the backend, so the
+    // thread count bounds the device queue depth for background fetches.
+    // Databases created without read threads do not do background fetches.
+    if (readThreads > 0)
+    {
+        readThreads = get<int>(config, "read_threads", readThreads);
+        if (readThreads < 1 || readThreads > 256)
+            Throw<std::runtime_error>("Invalid read_threads");
+    }
+
     while (readThreads-- > 0)
         readThreads_.emplace_back(&Database::threadEntry, this);
 }
@@ -166,6 +176,45 @@ Database::fetchNodeObject(
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+Database::fetchNodeObjects(
+    std::vector<uint256> const& hashes,
+    std::uint32_t ledgerSeq)
+{
+    std::vector<std::shared_ptr<NodeObject>> results;
+    results.reserve(hashes.size());
+    for (auto const& hash : hashes)
+        results.push_back(fetchNodeObject(hash, ledgerSeq));
+    return results;
+}
+
+void
+Database::reportBatchFetch(
+    std::vector<std::shared_ptr<NodeObject>> const& nodeObjects,
+    std::chrono::steady_clock::time_point begin)
+{
+    using namespace std::chrono;
+    FetchReport fetchReport(FetchType::synchronous);
+
+    std::uint64_t hits{0};
+    for (auto const& nodeObject : nodeObjects)
+    {
+        if (nodeObject)
+        {
+            ++hits;
+            fetchSz_ += nodeObject->getData().size();
+        }
+    }
+    fetchReport.wasFound = hits != 0;
+
+    auto const elapsed = steady_clock::now() - begin;
+    updateFetchMetrics(
+        nodeObjects.size(), hits, duration_cast<microseconds>(elapsed).count());
+
+    fetchReport.elapsed = duration_cast<milliseconds>(elapsed);
+    scheduler_.onFetch(fetchReport);
+}
+
 bool
 Database::storeLedger(
     Ledger const& srcLedger,
@@ -104,18 +104,14 @@ std::vector<std::shared_ptr<NodeObject>>
 DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
 {
     std::vector<std::shared_ptr<NodeObject>> results{hashes.size()};
-    using namespace std::chrono;
-    auto const before = steady_clock::now();
+    auto const before = std::chrono::steady_clock::now();
     std::unordered_map<uint256 const*, size_t> indexMap;
     std::vector<uint256 const*> cacheMisses;
-    uint64_t hits = 0;
-    uint64_t fetches = 0;
     for (size_t i = 0; i < hashes.size(); ++i)
     {
         auto const& hash = hashes[i];
         // See if the object already exists in the cache
         auto nObj = cache_ ? cache_->fetch(hash) : nullptr;
-        ++fetches;
         if (!nObj)
         {
             // Try the database
@@ -124,9 +120,8 @@ DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
         }
         else
         {
-            results[i] = nObj;
             // It was in the cache.
-            ++hits;
+            results[i] = nObj;
         }
     }
 
@@ -150,17 +145,14 @@ DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
         }
         else
         {
-            JLOG(j_.error())
+            // Callers walking partial trees expect misses
+            JLOG(j_.debug())
                 << "DatabaseNodeImp::fetchBatch - "
                 << "record not found in db or cache. hash = " << strHex(hash);
         }
     }
 
-    auto fetchDurationUs =
-        std::chrono::duration_cast<std::chrono::microseconds>(
-            steady_clock::now() - before)
-            .count();
-    updateFetchMetrics(fetches, hits, fetchDurationUs);
+    reportBatchFetch(results, before);
     return results;
 }
 
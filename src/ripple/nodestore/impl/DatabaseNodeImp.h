@@ -125,6 +125,13 @@ public:
     std::vector<std::shared_ptr<NodeObject>>
     fetchBatch(std::vector<uint256> const& hashes);
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchNodeObjects(std::vector<uint256> const& hashes, std::uint32_t)
+        override
+    {
+        return fetchBatch(hashes);
+    }
+
     bool
     storeLedger(std::shared_ptr<Ledger const> const& srcLedger) override
     {
@@ -37,6 +37,31 @@ DatabaseRotatingImp::DatabaseRotatingImp(
     , writableBackend_(std::move(writableBackend))
     , archiveBackend_(std::move(archiveBackend))
 {
+    if (config.exists("hot_tier_size"))
+    {
+        auto const size = get<int>(config, "hot_tier_size");
+        if (size < 0)
+        {
+            Throw<std::runtime_error>(
+                "Specified negative value for hot_tier_size");
+        }
+
+        auto age = get<int>(config, "hot_tier_age", 0);
+        if (age < 0)
+        {
+            Throw<std::runtime_error>(
+                "Specified negative value for hot_tier_age");
+        }
+        if (age == 0)
+            age = 5;
+
+        if (size > 0)
+        {
+            hotTier_ = std::make_shared<TaggedCache<uint256, NodeObject>>(
+                name, size, std::chrono::minutes{age}, stopwatch(), j);
+        }
+    }
+
     if (writableBackend_)
         fdRequired_ += writableBackend_->fdRequired();
     if (archiveBackend_)
@@ -55,6 +80,24 @@ DatabaseRotatingImp::rotateWithLock(
     archiveBackend_->setDeletePath();
     archiveBackend_ = std::move(writableBackend_);
     writableBackend_ = std::move(newBackend);
+
+    // Everything in the hot tier now lives in the archive backend. Serving
+    // it from memory would skip the copy forward done on archive hits.
+    if (hotTier_)
+        hotTier_->clear();
+}
+
+void
+DatabaseRotatingImp::promote(
+    std::lock_guard<std::mutex> const&,
+    std::shared_ptr<Backend> const& backend,
+    std::shared_ptr<NodeObject>& nodeObject)
+{
+    if (hotTier_ && backend == writableBackend_)
+    {
+        hotTier_->canonicalize_replace_client(
+            nodeObject->getHash(), nodeObject);
+    }
 }
 
 std::string
@@ -111,6 +154,7 @@ DatabaseRotatingImp::store(
 
     auto const backend = [&] {
         std::lock_guard lock(mutex_);
+        promote(lock, writableBackend_, nObj);
         return writableBackend_;
     }();
 
@@ -121,7 +165,8 @@ DatabaseRotatingImp::store(
 void
 DatabaseRotatingImp::sweep()
 {
-    // nothing to do
+    if (hotTier_)
+        hotTier_->sweep();
 }
 
 std::shared_ptr<NodeObject>
@@ -163,17 +208,33 @@ DatabaseRotatingImp::fetchNodeObject(
         return nodeObject;
     };
 
-    // See if the node object exists in the cache
+    // See if the node object exists in the hot tier. The lookup is made
+    // under the lock, so it cannot be served an object that a rotation
+    // has just moved to the archive backend.
     std::shared_ptr<NodeObject> nodeObject;
-
-    auto [writable, archive] = [&] {
+    std::shared_ptr<Backend> writable;
+    std::shared_ptr<Backend> archive;
+    {
         std::lock_guard lock(mutex_);
-        return std::make_pair(writableBackend_, archiveBackend_);
-    }();
+        if (hotTier_)
+            nodeObject = hotTier_->fetch(hash);
+        writable = writableBackend_;
+        archive = archiveBackend_;
+    }
+    if (nodeObject)
+    {
+        fetchReport.wasFound = true;
+        return nodeObject;
+    }
 
     // Try to fetch from the writable backend
     nodeObject = fetch(writable);
-    if (!nodeObject)
+    if (nodeObject)
+    {
+        std::lock_guard lock(mutex_);
+        promote(lock, writable, nodeObject);
+    }
+    else
     {
         // Otherwise try to fetch from the archive backend
         nodeObject = fetch(archive);
@@ -183,6 +244,7 @@ DatabaseRotatingImp::fetchNodeObject(
                 // Refresh the writable backend pointer
                 std::lock_guard lock(mutex_);
                 writable = writableBackend_;
+                promote(lock, writable, nodeObject);
             }
 
             // Update writable backend with data from the archive backend
@@ -196,6 +258,105 @@ DatabaseRotatingImp::fetchNodeObject(
     return nodeObject;
 }
 
+std::vector<std::shared_ptr<NodeObject>>
+DatabaseRotatingImp::fetchNodeObjects(
+    std::vector<uint256> const& hashes,
+    std::uint32_t)
+{
+    auto const begin = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<NodeObject>> results(hashes.size());
+
+    // Indexes of the objects not found so far
+    std::vector<std::size_t> missing;
+    missing.reserve(hashes.size());
+
+    // Look in the hot tier under the lock, as fetchNodeObject does
+    std::shared_ptr<Backend> writable;
+    std::shared_ptr<Backend> archive;
+    {
+        std::lock_guard lock(mutex_);
+        for (std::size_t i = 0; i < hashes.size(); ++i)
+        {
+            if (hotTier_)
+                results[i] = hotTier_->fetch(hashes[i]);
+            if (!results[i])
+                missing.push_back(i);
+        }
+        writable = writableBackend_;
+        archive = archiveBackend_;
+    }
+
+    // Fetch the missing objects from one backend in a single request.
+    // Returns the indexes it supplied and leaves the rest in `missing`.
+    auto fetch = [&](std::shared_ptr<Backend> const& backend) {
+        std::vector<uint256 const*> keys;
+        keys.reserve(missing.size());
+        for (auto const i : missing)
+            keys.push_back(&hashes[i]);
+
+        std::vector<std::shared_ptr<NodeObject>> nodeObjects;
+        try
+        {
+            nodeObjects = backend->fetchBatch(keys).first;
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.fatal()) << "Exception, " << e.what();
+            Rethrow();
+        }
+
+        std::vector<std::size_t> found;
+        std::vector<std::size_t> stillMissing;
+        for (std::size_t j = 0; j < missing.size(); ++j)
+        {
+            if (j < nodeObjects.size() && nodeObjects[j])
+            {
+                results[missing[j]] = std::move(nodeObjects[j]);
+                found.push_back(missing[j]);
+            }
+            else
+                stillMissing.push_back(missing[j]);
+        }
+        missing = std::move(stillMissing);
+        return found;
+    };
+
+    if (!missing.empty())
+    {
+        // Try to fetch from the writable backend
+        auto const fromWritable = fetch(writable);
+        if (hotTier_ && !fromWritable.empty())
+        {
+            std::lock_guard lock(mutex_);
+            for (auto const i : fromWritable)
+                promote(lock, writable, results[i]);
+        }
+
+        // Otherwise try to fetch from the archive backend
+        if (!missing.empty())
+        {
+            auto const fromArchive = fetch(archive);
+            if (!fromArchive.empty())
+            {
+                {
+                    // Refresh the writable backend pointer
+                    std::lock_guard lock(mutex_);
+                    writable = writableBackend_;
+                    for (auto const i : fromArchive)
+                        promote(lock, writable, results[i]);
+                }
+
+                // Update writable backend with data from the archive backend
+                for (auto const i : fromArchive)
+                    writable->store(results[i]);
+            }
+        }
+    }
+
+    reportBatchFetch(results, begin);
+    return results;
+}
+
 void
 DatabaseRotatingImp::for_each(
     std::function<void(std::shared_ptr<NodeObject>)> f)
@@ -20,9 +20,14 @@
 #ifndef RIPPLE_NODESTORE_DATABASEROTATINGIMP_H_INCLUDED
 #define RIPPLE_NODESTORE_DATABASEROTATINGIMP_H_INCLUDED
 
+#include <ripple/basics/TaggedCache.h>
 #include <ripple/nodestore/DatabaseRotating.h>
 
 namespace ripple {
+namespace test {
+class SHAMapStore_test;
+}  // namespace test
+
 namespace NodeStore {
 
 class DatabaseRotatingImp : public DatabaseRotating
@@ -76,6 +81,10 @@ public:
     void
     sync() override;
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchNodeObjects(std::vector<uint256> const& hashes, std::uint32_t)
+        override;
+
     bool
     storeLedger(std::shared_ptr<Ledger const> const& srcLedger) override;
 
@@ -83,16 +92,15 @@ public:
     sweep() override;
 
 private:
+    // Hot tier holding recently stored or fetched objects. Only objects
+    // present in the current writable backend are admitted, and the tier is
+    // emptied on rotation, so a hit never needs copying forward. This cache
+    // is not always initialized. Check for null before using.
+    std::shared_ptr<TaggedCache<uint256, NodeObject>> hotTier_;
     std::shared_ptr<Backend> writableBackend_;
     std::shared_ptr<Backend> archiveBackend_;
     mutable std::mutex mutex_;
 
-    struct Backends
-    {
-        std::shared_ptr<Backend> const& writableBackend;
-        std::shared_ptr<Backend> const& archiveBackend;
-    };
-
     std::shared_ptr<NodeObject>
     fetchNodeObject(
         uint256 const& hash,
@@ -101,6 +109,16 @@ private:
 
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override;
+
+    // Admit an object to the hot tier if `backend` is still the writable
+    // backend. Must be called with mutex_ held.
+    void
+    promote(
+        std::lock_guard<std::mutex> const&,
+        std::shared_ptr<Backend> const& backend,
+        std::shared_ptr<NodeObject>& nodeObject);
+
+    friend class test::SHAMapStore_test;
 };
 
 }  // namespace NodeStore
@@ -25,12 +25,15 @@
 #include <ripple/basics/random.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/ShardArchive.h>
 #include <ripple/nodestore/impl/DatabaseShardImp.h>
 #include <ripple/overlay/Overlay.h>
 #include <ripple/overlay/predicates.h>
 #include <ripple/protocol/HashPrefix.h>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #if BOOST_OS_LINUX
 #include <sys/statvfs.h>
@@ -540,6 +543,180 @@ DatabaseShardImp::importShard(
     return true;
 }
 
+bool
+DatabaseShardImp::importShardArchive(
+    std::uint32_t shardIndex,
+    boost::filesystem::path const& archive)
+{
+    using namespace boost::filesystem;
+
+    auto const srcDir{archive.parent_path() / std::to_string(shardIndex)};
+    std::unique_ptr<Backend> backend;
+    auto fail = [&](std::string const& msg) {
+        JLOG(j_.error()) << "shard " << shardIndex << " " << msg;
+
+        backend.reset();
+        try
+        {
+            remove_all(srcDir);
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.error()) << "exception " << e.what()
+                             << " in function " << __func__;
+        }
+        return false;
+    };
+
+    {
+        std::lock_guard lock(mutex_);
+        if (preparedIndexes_.find(shardIndex) == preparedIndexes_.end())
+            return fail("was not prepared for import");
+    }
+
+    try
+    {
+        ifstream is(archive, std::ios::binary);
+        ShardArchiveReader reader(is);
+        if (reader.shardIndex() != shardIndex)
+            return fail("mismatches archive shard index");
+
+        // Referenced objects are copied from the base shard
+        std::shared_ptr<Shard> base;
+        if (auto const baseIndex{reader.baseIndex()}; baseIndex != 0)
+        {
+            std::lock_guard lock(mutex_);
+            auto const it{shards_.find(baseIndex)};
+            if (it == shards_.end() || it->second->getState() != Shard::final)
+                return fail("missing base shard " + std::to_string(baseIndex));
+            base = it->second;
+        }
+
+        auto const factory{Manager::instance().find(backendName_)};
+        if (!factory)
+            return fail("failed to find factory for " + backendName_);
+
+        Section section{app_.config().section(ConfigSection::shardDatabase())};
+        section.set("path", srcDir.string());
+        remove_all(srcDir);
+        backend = factory->createInstance(
+            NodeObject::keyBytes,
+            section,
+            megabytes(
+                app_.config().getValueFor(SizedItem::burstSize, boost::none)),
+            scheduler_,
+            *ctx_,
+            j_);
+        backend->open();
+
+        // Stream the archive into the backend, chunks are verified as read
+        for (auto batch{reader.next()}; !batch.empty(); batch = reader.next())
+            backend->storeBatch(batch);
+
+        Batch batch;
+        batch.reserve(batchWritePreallocationSize);
+        FetchReport fetchReport(FetchType::synchronous);
+        for (auto const& hash : reader.references())
+        {
+            auto nodeObject{base->fetchNodeObject(hash, fetchReport)};
+            if (!nodeObject)
+            {
+                return fail(
+                    "base shard missing node object " + to_string(hash));
+            }
+
+            batch.push_back(std::move(nodeObject));
+            if (batch.size() >= batchWritePreallocationSize)
+            {
+                backend->storeBatch(batch);
+                batch.clear();
+            }
+        }
+        if (!batch.empty())
+            backend->storeBatch(batch);
+
+        backend->close();
+        backend.reset();
+    }
+    catch (std::exception const& e)
+    {
+        return fail(
+            std::string(". Exception caught in function ") + __func__ +
+            ". Error: " + e.what());
+    }
+
+    return importShard(shardIndex, srcDir);
+}
+
+bool
+DatabaseShardImp::exportShardArchive(
+    std::uint32_t shardIndex,
+    boost::filesystem::path const& archive,
+    std::uint32_t baseIndex)
+{
+    auto fail = [&](std::string const& msg) {
+        JLOG(j_.error()) << "shard " << shardIndex << " " << msg;
+
+        boost::system::error_code ec;
+        boost::filesystem::remove(archive, ec);
+        return false;
+    };
+
+    std::shared_ptr<Shard> shard;
+    std::shared_ptr<Shard> base;
+    {
+        std::lock_guard lock(mutex_);
+        auto findFinal = [&](std::uint32_t index) -> std::shared_ptr<Shard> {
+            auto const it{shards_.find(index)};
+            if (it == shards_.end() || it->second->getState() != Shard::final)
+                return {};
+            return it->second;
+        };
+
+        shard = findFinal(shardIndex);
+        if (!shard)
+            return fail("is not final");
+
+        if (baseIndex != 0)
+        {
+            base = findFinal(baseIndex);
+            if (!base)
+                return fail("missing base shard " + std::to_string(baseIndex));
+        }
+    }
+
+    try
+    {
+        boost::filesystem::ofstream os(archive, std::ios::binary);
+        ShardArchiveWriter writer(os, shardIndex, baseIndex);
+        FetchReport fetchReport(FetchType::synchronous);
+        bool const visited{shard->forEachNodeObject(
+            [&](std::shared_ptr<NodeObject> const& nodeObject) {
+                // The final key differs between shards, always carry it
+                auto const& hash{nodeObject->getHash()};
+                if (base && hash != Shard::finalKey &&
+                    base->fetchNodeObject(hash, fetchReport))
+                {
+                    writer.addReference(hash);
+                }
+                else
+                    writer.add(nodeObject);
+            })};
+        if (!visited)
+            return fail("failed to read node objects");
+
+        writer.finish();
+    }
+    catch (std::exception const& e)
+    {
+        return fail(
+            std::string(". Exception caught in function ") + __func__ +
+            ". Error: " + e.what());
+    }
+
+    return true;
+}
+
 std::shared_ptr<Ledger>
 DatabaseShardImp::fetchLedger(uint256 const& hash, std::uint32_t ledgerSeq)
 {
@@ -1173,6 +1350,15 @@ DatabaseShardImp::initConfig(std::lock_guard<std::mutex> const&)
         }
     }
 
+    if (section.exists("finalize_threads"))
+    {
+        auto const threads{get<std::uint32_t>(section, "finalize_threads")};
+        if (threads < 1 || threads > 64)
+            return fail("'finalize_threads' must be between 1 and 64");
+        finalizeThreads_.setThreads(threads);
+        taskQueue_->setThreadCount(threads);
+    }
+
     if (section.exists("ledgers_per_shard"))
     {
         // To be set only in standalone for testing
@@ -1300,7 +1486,13 @@ DatabaseShardImp::finalizeShard(
             return;
         }
 
-        if (!shard->finalize(writeSQLite, expectedHash))
+        // Split the thread budget among the shards being finalized
+        bool const finalized = [&] {
+            auto const threads{finalizeThreads_.reserve(ledgersPerShard_)};
+            return shard->finalize(writeSQLite, expectedHash, threads.count());
+        }();
+
+        if (!finalized)
         {
             if (isStopping())
                 return;
@@ -23,6 +23,7 @@
 #include <ripple/nodestore/DatabaseShard.h>
 #include <ripple/nodestore/impl/Shard.h>
 #include <ripple/nodestore/impl/TaskQueue.h>
+#include <ripple/nodestore/impl/ThreadBudget.h>
 
 #include <boost/asio/basic_waitable_timer.hpp>
 
@@ -67,6 +68,17 @@ public:
     importShard(std::uint32_t shardIndex, boost::filesystem::path const& srcDir)
         override;
 
+    bool
+    importShardArchive(
+        std::uint32_t shardIndex,
+        boost::filesystem::path const& archive) override;
+
+    bool
+    exportShardArchive(
+        std::uint32_t shardIndex,
+        boost::filesystem::path const& archive,
+        std::uint32_t baseIndex) override;
+
     std::shared_ptr<Ledger>
     fetchLedger(uint256 const& hash, std::uint32_t ledgerSeq) override;
 
@@ -117,6 +129,13 @@ public:
         return dir_;
     }
 
+    /** The most threads that finalized shards at the same time. */
+    std::uint32_t
+    finalizeThreadsPeak() const
+    {
+        return finalizeThreads_.peak();
+    }
+
     std::string
     getName() const override
     {
@@ -178,6 +197,10 @@ private:
     // Queue of background tasks to be performed
     std::unique_ptr<TaskQueue> taskQueue_;
 
+    // Threads available for finalizing shards, shared among the shards
+    // being finalized at the same time
+    ThreadBudget finalizeThreads_;
+
     // Shards held by this server
     std::unordered_map<std::uint32_t, std::shared_ptr<Shard>> shards_;
 
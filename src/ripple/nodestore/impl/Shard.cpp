@@ -20,14 +20,22 @@
 #include <ripple/app/ledger/InboundLedger.h>
 #include <ripple/app/main/DBInit.h>
 #include <ripple/basics/StringUtilities.h>
+#include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/Shard.h>
+#include <ripple/nodestore/impl/codec.h>
 #include <ripple/protocol/digest.h>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
+
 namespace ripple {
 namespace NodeStore {
 
@@ -286,6 +294,53 @@ Shard::fetchNodeObject(uint256 const& hash, FetchReport& fetchReport)
     return nodeObject;
 }
 
+bool
+Shard::forEachNodeObject(
+    std::function<void(std::shared_ptr<NodeObject> const&)> const& f) const
+{
+    if (state_ != final)
+        return false;
+
+    nudb::error_code ec;
+    try
+    {
+        nudb::visit(
+            (dir_ / "nudb.dat").string(),
+            [&](void const* key,
+                std::size_t,
+                void const* data,
+                std::size_t size,
+                nudb::error_code& ec) {
+                nudb::detail::buffer bf;
+                auto const result{nodeobject_decompress(data, size, bf)};
+                DecodedBlob decoded(key, result.first, result.second);
+                if (!decoded.wasOk())
+                {
+                    ec = make_error_code(nudb::error::missing_value);
+                    return;
+                }
+                f(decoded.createObject());
+            },
+            nudb::no_progress{},
+            ec);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.error()) << "shard " << index_
+                         << ". Exception caught in function " << __func__
+                         << ". Error: " << e.what();
+        return false;
+    }
+
+    if (ec)
+    {
+        JLOG(j_.error()) << "shard " << index_
+                         << ". Error reading node objects: " << ec.message();
+        return false;
+    }
+    return true;
+}
+
 Shard::StoreLedgerResult
 Shard::storeLedger(
     std::shared_ptr<Ledger const> const& srcLedger,
@@ -560,7 +615,8 @@ Shard::isLegacy() const
 bool
 Shard::finalize(
     bool const writeSQLite,
-    boost::optional<uint256> const& expectedHash)
+    boost::optional<uint256> const& expectedHash,
+    std::uint32_t threads)
 {
     uint256 hash{0};
     std::uint32_t ledgerSeq{0};
@@ -667,8 +723,6 @@ Shard::finalize(
 
     // Validate every ledger stored in the backend
     Config const& config{app_.config()};
-    std::shared_ptr<Ledger> ledger;
-    std::shared_ptr<Ledger const> next;
     auto const lastLedgerHash{hash};
     auto& shardFamily{*app_.getShardFamily()};
     auto const fullBelowCache{shardFamily.getFullBelowCache(lastSeq_)};
@@ -679,7 +733,10 @@ Shard::finalize(
     treeNodeCache->reset();
 
     // Start with the last ledger in the shard and walk backwards from
-    // child to parent until we reach the first ledger
+    // child to parent until we reach the first ledger, collecting the
+    // headers. The headers chain the ledgers together so that ranges of
+    // them can then be verified independently.
+    std::vector<LedgerInfo> infos(lastSeq_ - firstSeq_ + 1);
     ledgerSeq = lastSeq_;
     while (ledgerSeq >= firstSeq_)
     {
@@ -690,44 +747,152 @@ Shard::finalize(
         if (!nodeObject)
             return fail("invalid ledger");
 
-        ledger = std::make_shared<Ledger>(
-            deserializePrefixedHeader(makeSlice(nodeObject->getData())),
-            config,
-            shardFamily);
-        if (ledger->info().seq != ledgerSeq)
+        auto& info{infos[ledgerSeq - firstSeq_]};
+        info = deserializePrefixedHeader(makeSlice(nodeObject->getData()));
+        if (info.seq != ledgerSeq)
             return fail("invalid ledger sequence");
-        if (ledger->info().hash != hash)
+        if (calculateLedgerHash(info) != hash)
             return fail("invalid ledger hash");
+        info.hash = hash;
 
-        ledger->stateMap().setLedgerSeq(ledgerSeq);
-        ledger->txMap().setLedgerSeq(ledgerSeq);
+        hash = info.parentHash;
+        --ledgerSeq;
+    }
+    hash.zero();
+    ledgerSeq = 0;
+
+    auto makeLedger = [&](std::uint32_t seq) -> std::shared_ptr<Ledger> {
+        auto ledger{std::make_shared<Ledger>(
+            infos[seq - firstSeq_], config, shardFamily)};
+        ledger->stateMap().setLedgerSeq(seq);
+        ledger->txMap().setLedgerSeq(seq);
         ledger->setImmutable(config);
         if (!ledger->stateMap().fetchRoot(
                 SHAMapHash{ledger->info().accountHash}, nullptr))
         {
-            return fail("missing root STATE node");
+            JLOG(j_.fatal()) << "shard " << index_
+                             << ". missing root STATE node. Ledger sequence "
+                             << seq;
+            return {};
         }
         if (ledger->info().txHash.isNonZero() &&
             !ledger->txMap().fetchRoot(
                 SHAMapHash{ledger->info().txHash}, nullptr))
         {
-            return fail("missing root TXN node");
+            JLOG(j_.fatal()) << "shard " << index_
+                             << ". missing root TXN node. Ledger sequence "
+                             << seq;
+            return {};
         }
+        return ledger;
+    };
 
-        if (!verifyLedger(ledger, next))
-            return fail("failed to validate ledger");
+    // Verify the ledgers in [first, last] walking backwards. Nodes shared
+    // with the following ledger are skipped, they are verified along with
+    // that ledger, possibly by another thread.
+    std::atomic<bool> valid{true};
+    auto verifyRange = [&](std::uint32_t first, std::uint32_t last) {
+        try
+        {
+            std::shared_ptr<Ledger const> next;
+            if (last < lastSeq_ && !(next = makeLedger(last + 1)))
+                return false;
 
-        if (writeSQLite && !storeSQLite(ledger))
-            return fail("failed storing to SQLite databases");
+            for (auto seq = last; seq >= first; --seq)
+            {
+                if (stop_ || !valid)
+                    return false;
 
-        hash = ledger->info().parentHash;
-        next = std::move(ledger);
-        --ledgerSeq;
+                auto ledger{makeLedger(seq)};
+                if (!ledger || !verifyLedger(ledger, next))
+                    return false;
+
+                if (writeSQLite && !storeSQLite(ledger))
+                {
+                    JLOG(j_.fatal()) << "shard " << index_
+                                     << ". failed storing to SQLite databases"
+                                     << ". Ledger sequence " << seq;
+                    return false;
+                }
+
+                next = std::move(ledger);
+
+                fullBelowCache->reset();
+                treeNodeCache->reset();
+            }
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.fatal()) << "shard " << index_
+                             << ". Exception caught in function " << __func__
+                             << ". Error: " << e.what();
+            return false;
+        }
+        return true;
+    };
+
+    {
+        threads = std::clamp(
+            threads, 1u, static_cast<std::uint32_t>(infos.size()));
+        std::uint32_t const perThread = (infos.size() + threads - 1) / threads;
+        auto const lastOf = [&](std::uint32_t first) {
+            return std::min(first + perThread - 1, lastSeq_);
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+
+        // Join the workers however this scope is left
+        struct Joiner
+        {
+            std::vector<std::thread>& workers;
+
+            ~Joiner()
+            {
+                for (auto& worker : workers)
+                    worker.join();
+            }
+        } joiner{workers};
+
+        // Ranges this thread verifies, including any a worker could not
+        // be started for
+        std::vector<std::uint32_t> firsts{firstSeq_};
+        for (auto first = firstSeq_ + perThread; first <= lastSeq_;
+             first += perThread)
+        {
+            try
+            {
+                workers.emplace_back([&, first] {
+                    beast::setCurrentThreadName(
+                        "shard verify " + std::to_string(index_));
+                    if (!verifyRange(first, lastOf(first)))
+                        valid = false;
+                });
+            }
+            catch (std::system_error const& e)
+            {
+                JLOG(j_.warn()) << "shard " << index_
+                                << ". Unable to start verify thread: "
+                                << e.what();
+                firsts.push_back(first);
+            }
+        }
 
-        fullBelowCache->reset();
-        treeNodeCache->reset();
+        for (auto const first : firsts)
+        {
+            if (!verifyRange(first, lastOf(first)))
+            {
+                valid = false;
+                break;
+            }
+        }
     }
 
+    if (stop_)
+        return false;
+    if (!valid)
+        return fail("failed to validate ledger");
+
     JLOG(j_.debug()) << "shard " << index_ << " is valid";
 
     /*
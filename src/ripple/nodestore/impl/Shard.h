@@ -114,6 +114,19 @@ public:
     [[nodiscard]] std::shared_ptr<NodeObject>
     fetchNodeObject(uint256 const& hash, FetchReport& fetchReport);
 
+    /** Visit every node object of a final shard.
+
+        The backend's data file is read directly, a final shard is never
+        written to, so fetches proceed undisturbed.
+
+        @param f Called with each object.
+        @return false if the shard is not final or could not be read.
+    */
+    [[nodiscard]] bool
+    forEachNodeObject(
+        std::function<void(std::shared_ptr<NodeObject> const&)> const& f)
+        const;
+
     /** Store a ledger.
 
         @param srcLedger The ledger to store.
@@ -182,11 +195,14 @@ public:
         verified backend data.
         @param referenceHash If present, this hash must match the hash
         of the last ledger in the shard.
+        @param threads Number of threads verifying ledgers. Each thread
+        verifies a contiguous range of ledgers.
     */
     [[nodiscard]] bool
     finalize(
         bool const writeSQLite,
-        boost::optional<uint256> const& referenceHash);
+        boost::optional<uint256> const& referenceHash,
+        std::uint32_t threads);
 
     /** Enables removal of the shard directory on destruction.
      */
@@ -0,0 +1,270 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE  OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/contract.h>
+#include <ripple/nodestore/ShardArchive.h>
+#include <ripple/nodestore/impl/DecodedBlob.h>
+#include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/nodestore/impl/codec.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/digest.h>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace ripple {
+namespace NodeStore {
+
+namespace {
+
+std::array<char, 4> constexpr magic{'R', 'S', 'N', 'A'};
+std::uint32_t constexpr version = 1;
+std::size_t constexpr headerSize = 16;
+
+// Target payload size of a chunk
+std::size_t constexpr chunkSize = 4 * 1024 * 1024;
+
+// Largest payload accepted when reading, guards against corrupt sizes
+std::size_t constexpr maxChunkSize = 16 * chunkSize;
+
+// Smallest payload of an object, its hash and size
+std::size_t constexpr minObjectSize = 36;
+
+// Largest number of references accepted when reading
+std::uint32_t constexpr maxReferences = 1 << 26;
+
+// References are read this many at a time, so a corrupt count runs into
+// the end of the archive instead of allocating for all of them up front
+std::uint32_t constexpr referenceBatch = 1 << 16;
+
+}  // namespace
+
+ShardArchiveWriter::ShardArchiveWriter(
+    std::ostream& os,
+    std::uint32_t shardIndex,
+    std::uint32_t baseIndex)
+    : os_(os), baseIndex_(baseIndex)
+{
+    Serializer s(headerSize);
+    s.addRaw(magic.data(), magic.size());
+    s.add32(version);
+    s.add32(shardIndex);
+    s.add32(baseIndex);
+    os_.write(reinterpret_cast<char const*>(s.data()), s.size());
+    payload_.reserve(chunkSize);
+}
+
+void
+ShardArchiveWriter::add(std::shared_ptr<NodeObject> const& object)
+{
+    EncodedBlob e;
+    e.prepare(object);
+    nudb::detail::buffer bf;
+    auto const [data, size] = nodeobject_compress(e.getData(), e.getSize(), bf);
+
+    auto const& hash{object->getHash()};
+    payload_.insert(payload_.end(), hash.begin(), hash.end());
+    for (int shift = 24; shift >= 0; shift -= 8)
+        payload_.push_back(static_cast<std::uint8_t>(size >> shift));
+    auto const p{static_cast<std::uint8_t const*>(data)};
+    payload_.insert(payload_.end(), p, p + size);
+    ++count_;
+
+    if (payload_.size() >= chunkSize)
+        flush();
+}
+
+void
+ShardArchiveWriter::addReference(uint256 const& hash)
+{
+    if (baseIndex_ == 0)
+        Throw<std::runtime_error>("shard archive has no base shard");
+    references_.push_back(hash);
+}
+
+void
+ShardArchiveWriter::flush()
+{
+    if (count_ == 0)
+        return;
+
+    Serializer s(40);
+    s.add32(count_);
+    s.add32(payload_.size());
+    s.addBitString(sha512Half(makeSlice(payload_)));
+    os_.write(reinterpret_cast<char const*>(s.data()), s.size());
+    os_.write(reinterpret_cast<char const*>(payload_.data()), payload_.size());
+
+    payload_.clear();
+    count_ = 0;
+}
+
+void
+ShardArchiveWriter::finish()
+{
+    flush();
+
+    Serializer s(40 + references_.size() * uint256::size());
+    s.add32(0);
+    s.add32(references_.size());
+    {
+        sha512_half_hasher h;
+        for (auto const& hash : references_)
+            hash_append(h, hash);
+        s.addBitString(static_cast<uint256>(h));
+    }
+    for (auto const& hash : references_)
+        s.addBitString(hash);
+    os_.write(reinterpret_cast<char const*>(s.data()), s.size());
+    os_.flush();
+
+    if (!os_)
+        Throw<std::runtime_error>("shard archive write failed");
+}
+
+//------------------------------------------------------------------------------
+
+ShardArchiveReader::ShardArchiveReader(std::istream& is) : is_(is)
+{
+    auto const header{read(headerSize)};
+    if (!std::equal(magic.begin(), magic.end(), header.begin()))
+        Throw<std::runtime_error>("not a shard archive");
+
+    SerialIter sit(makeSlice(header));
+    sit.skip(magic.size());
+    if (sit.get32() != version)
+        Throw<std::runtime_error>("unsupported shard archive version");
+    shardIndex_ = sit.get32();
+    baseIndex_ = sit.get32();
+}
+
+Blob
+ShardArchiveReader::read(std::size_t size)
+{
+    Blob result(size);
+    if (!is_.read(reinterpret_cast<char*>(result.data()), size))
+        Throw<std::runtime_error>("shard archive truncated");
+    return result;
+}
+
+Batch
+ShardArchiveReader::next()
+{
+    if (done_)
+        return {};
+
+    auto const count{SerialIter(makeSlice(read(4))).get32()};
+    if (count == 0)
+    {
+        done_ = true;
+        return {};
+    }
+
+    auto const prefix{read(36)};
+    SerialIter sit(makeSlice(prefix));
+    auto const size{sit.get32()};
+    auto const checksum{sit.get256()};
+    if (size > maxChunkSize)
+        Throw<std::runtime_error>("shard archive chunk too large");
+    if (count > size / minObjectSize)
+        Throw<std::runtime_error>("shard archive chunk invalid");
+
+    auto const payload{read(size)};
+    if (sha512Half(makeSlice(payload)) != checksum)
+        Throw<std::runtime_error>("shard archive chunk corrupt");
+
+    Batch batch;
+    batch.reserve(count);
+    sit = SerialIter(makeSlice(payload));
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        auto const hash{sit.get256()};
+        auto const slice{sit.getSlice(sit.get32())};
+
+        nudb::detail::buffer bf;
+        auto const [data, dataSize] =
+            nodeobject_decompress(slice.data(), slice.size(), bf);
+        DecodedBlob decoded(hash.data(), data, dataSize);
+        if (!decoded.wasOk())
+            Throw<std::runtime_error>("shard archive object corrupt");
+
+        auto object{decoded.createObject()};
+
+        // The shard's final key is the only object not keyed by its hash
+        if (hash.isNonZero() &&
+            hash != sha512Half(makeSlice(object->getData())))
+        {
+            Throw<std::runtime_error>("shard archive object hash mismatch");
+        }
+        batch.push_back(std::move(object));
+    }
+    if (!sit.empty())
+        Throw<std::runtime_error>("shard archive chunk has trailing data");
+
+    return batch;
+}
+
+std::vector<uint256>
+ShardArchiveReader::references()
+{
+    if (!done_)
+        LogicError("ShardArchiveReader::references called before all chunks");
+
+    auto const prefix{read(36)};
+    SerialIter sit(makeSlice(prefix));
+    auto const count{sit.get32()};
+    auto const checksum{sit.get256()};
+    if (count > maxReferences || (count > 0 && baseIndex_ == 0))
+        Throw<std::runtime_error>("shard archive references invalid");
+
+    std::vector<uint256> references;
+    sha512_half_hasher h;
+    while (references.size() < count)
+    {
+        auto const n{std::min<std::size_t>(
+            count - references.size(), referenceBatch)};
+        auto const hashes{read(n * uint256::size())};
+        sit = SerialIter(makeSlice(hashes));
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            references.push_back(sit.get256());
+            hash_append(h, references.back());
+        }
+    }
+    if (static_cast<uint256>(h) != checksum)
+        Throw<std::runtime_error>("shard archive references corrupt");
+
+    return references;
+}
+
+//------------------------------------------------------------------------------
+
+bool
+isShardArchive(boost::filesystem::path const& path)
+{
+    boost::filesystem::ifstream is(path, std::ios::binary);
+    std::array<char, magic.size()> buf;
+    return is.read(buf.data(), buf.size()) && buf == magic;
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
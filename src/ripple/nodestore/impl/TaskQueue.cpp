@@ -46,6 +46,12 @@ TaskQueue::addTask(std::function<void()> task)
     workers_.addTask();
 }
 
+void
+TaskQueue::setThreadCount(int count)
+{
+    workers_.setNumberOfThreads(count);
+}
+
 void
 TaskQueue::processTask(int instance)
 {
@@ -44,6 +44,13 @@ public:
     void
     addTask(std::function<void()> task);
 
+    /** Sets the number of tasks that may run at the same time
+
+        @param count The number of threads processing tasks
+    */
+    void
+    setThreadCount(int count);
+
 private:
     std::mutex mutex_;
     Workers workers_;
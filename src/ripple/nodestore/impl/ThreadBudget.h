@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_THREADBUDGET_H_INCLUDED
+#define RIPPLE_NODESTORE_THREADBUDGET_H_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A fixed number of threads shared by tasks running at the same time.
+
+    A task reserves threads before it starts and gives them back when its
+    reservation is destroyed, however the task ends. A reservation holds at
+    least one thread, the one running the task, so a task waits while every
+    thread is reserved. The threads reserved at any time never exceed the
+    budget.
+*/
+class ThreadBudget
+{
+public:
+    class Reservation
+    {
+    public:
+        Reservation(Reservation const&) = delete;
+        Reservation&
+        operator=(Reservation const&) = delete;
+
+        ~Reservation()
+        {
+            budget_.release(count_);
+        }
+
+        /** Number of threads this reservation holds. */
+        std::uint32_t
+        count() const
+        {
+            return count_;
+        }
+
+    private:
+        friend class ThreadBudget;
+
+        Reservation(ThreadBudget& budget, std::uint32_t count)
+            : budget_(budget), count_(count)
+        {
+        }
+
+        ThreadBudget& budget_;
+        std::uint32_t const count_;
+    };
+
+    explicit ThreadBudget(std::uint32_t threads = 1)
+        : threads_(threads), free_(threads)
+    {
+        assert(threads > 0);
+    }
+
+    /** Change the size of the budget.
+
+        @note Must not be called while threads are reserved.
+    */
+    void
+    setThreads(std::uint32_t threads)
+    {
+        assert(threads > 0);
+        std::lock_guard lock(mutex_);
+        assert(free_ == threads_);
+        threads_ = free_ = threads;
+    }
+
+    /** Reserve up to `wanted` threads.
+
+        Blocks until at least one thread is free. A task gets no more than
+        its share of the budget among the tasks holding reservations, so a
+        later task is not shut out until the first one finishes.
+    */
+    Reservation
+    reserve(std::uint32_t wanted)
+    {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return free_ > 0; });
+
+        auto const share{std::max(threads_ / (holders_ + 1), 1u)};
+        auto const count{std::min({std::max(wanted, 1u), share, free_})};
+        free_ -= count;
+        ++holders_;
+        peak_ = std::max(peak_, threads_ - free_);
+        return Reservation(*this, count);
+    }
+
+    /** The most threads that have been reserved at the same time. */
+    std::uint32_t
+    peak() const
+    {
+        std::lock_guard lock(mutex_);
+        return peak_;
+    }
+
+private:
+    void
+    release(std::uint32_t count)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            free_ += count;
+            --holders_;
+        }
+        cv_.notify_all();
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::uint32_t threads_;
+    std::uint32_t free_;
+    std::uint32_t holders_{0};
+    std::uint32_t peak_{0};
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
@@ -2414,6 +2414,10 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
         bool pLDo = true;
         bool progress = false;
 
+        // The objects are verified in batches once they are all collected
+        std::vector<std::pair<uint256, std::shared_ptr<Blob>>> objects;
+        objects.reserve(packet.objects_size());
+
         for (int i = 0; i < packet.objects_size(); ++i)
         {
             const protocol::TMIndexedObject& obj = packet.objects(i);
@@ -2444,10 +2448,8 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
 
                 if (pLDo)
                 {
-                    uint256 const hash{obj.hash()};
-
-                    app_.getLedgerMaster().addFetchPack(
-                        hash,
+                    objects.emplace_back(
+                        uint256{obj.hash()},
                         std::make_shared<Blob>(
                             obj.data().begin(), obj.data().end()));
                 }
@@ -2459,8 +2461,23 @@ PeerImp::onMessage(std::shared_ptr<protocol::TMGetObjectByHash> const& m)
             JLOG(p_journal_.debug())
                 << "GetObj: Partial fetch pack for " << pLSeq;
         }
-        if (packet.type() == protocol::TMGetObjectByHash::otFETCH_PACK)
-            app_.getLedgerMaster().gotFetchPack(progress, pLSeq);
+
+        bool const fetchPack =
+            packet.type() == protocol::TMGetObjectByHash::otFETCH_PACK;
+        std::weak_ptr<PeerImp> weak = shared_from_this();
+        auto const pap = &app_;
+        app_.getLedgerMaster().addFetchPack(
+            std::move(objects),
+            [weak, pap, fetchPack, progress, pLSeq](std::size_t bad) {
+                if (auto const peer = weak.lock(); peer && bad)
+                {
+                    JLOG(peer->p_journal_.debug())
+                        << "GetObj: " << bad
+                        << " objects do not match their hash";
+                }
+                if (fetchPack)
+                    pap->getLedgerMaster().gotFetchPack(progress, pLSeq);
+            });
     }
 }
 
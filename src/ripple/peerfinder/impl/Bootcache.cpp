@@ -36,7 +36,8 @@ Bootcache::Bootcache(Store& store, clock_type& clock, beast::Journal journal)
 
 Bootcache::~Bootcache()
 {
-    update();
+    if (m_needsUpdate)
+        m_store.save(snapshot());
 }
 
 bool
@@ -195,10 +196,12 @@ Bootcache::on_failure(beast::IP::Endpoint const& endpoint)
     flagForUpdate();
 }
 
-void
+boost::optional<Bootcache::Entries>
 Bootcache::periodicActivity()
 {
-    checkUpdate();
+    if (m_needsUpdate && m_whenUpdate < m_clock.now())
+        return snapshot();
+    return boost::none;
 }
 
 //--------------------------------------------------------------------------
@@ -246,13 +249,11 @@ Bootcache::prune()
                             << " entries total";
 }
 
-// Updates the Store with the current set of entries if needed.
-void
-Bootcache::update()
+// Returns the current set of entries for the Store.
+Bootcache::Entries
+Bootcache::snapshot()
 {
-    if (!m_needsUpdate)
-        return;
-    std::vector<Store::Entry> list;
+    Entries list;
     list.reserve(m_map.size());
     for (auto const& e : m_map)
     {
@@ -261,26 +262,18 @@ Bootcache::update()
         se.valence = e.get_right().valence();
         list.push_back(se);
     }
-    m_store.save(list);
     // Reset the flag and cooldown timer
     m_needsUpdate = false;
     m_whenUpdate = m_clock.now() + Tuning::bootcacheCooldownTime;
+    return list;
 }
 
-// Checks the clock and calls update if we are off the cooldown.
-void
-Bootcache::checkUpdate()
-{
-    if (m_needsUpdate && m_whenUpdate < m_clock.now())
-        update();
-}
-
-// Called when changes to an entry will affect the Store.
+// Called when changes to an entry will affect the Store. The Store is
+// updated later, from periodicActivity.
 void
 Bootcache::flagForUpdate()
 {
     m_needsUpdate = true;
-    checkUpdate();
 }
 
 }  // namespace PeerFinder
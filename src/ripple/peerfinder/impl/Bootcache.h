@@ -28,6 +28,7 @@
 #include <boost/bimap/multiset_of.hpp>
 #include <boost/bimap/unordered_set_of.hpp>
 #include <boost/iterator/transform_iterator.hpp>
+#include <boost/optional.hpp>
 
 namespace ripple {
 namespace PeerFinder {
@@ -122,6 +123,9 @@ private:
     // Set to true when a database update is needed
     bool m_needsUpdate;
 
+public:
+    using Entries = std::vector<Store::Entry>;
+
 public:
     static constexpr int staticValence = 32;
 
@@ -176,8 +180,13 @@ public:
     void
     on_failure(beast::IP::Endpoint const& endpoint);
 
-    /** Stores the cache in the persistent database on a timer. */
-    void
+    /** Returns the entries to store in the persistent database, on a timer.
+
+        Changes are batched: at most one update is returned per cooldown
+        period. The caller saves the entries to the Store, which lets it
+        do so without holding its lock.
+    */
+    boost::optional<Entries>
     periodicActivity();
 
     /** Write the cache state to the property stream. */
@@ -187,10 +196,8 @@ public:
 private:
     void
     prune();
-    void
-    update();
-    void
-    checkUpdate();
+    Entries
+    snapshot();
     void
     flagForUpdate();
 };
@@ -20,11 +20,14 @@
 #ifndef RIPPLE_PEERFINDER_HANDOUTS_H_INCLUDED
 #define RIPPLE_PEERFINDER_HANDOUTS_H_INCLUDED
 
+#include <ripple/basics/random.h>
 #include <ripple/beast/container/aged_set.h>
 #include <ripple/peerfinder/impl/SlotImp.h>
 #include <ripple/peerfinder/impl/Tuning.h>
+#include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <limits>
 #include <type_traits>
 
 namespace ripple {
@@ -33,25 +36,26 @@ namespace PeerFinder {
 namespace detail {
 
 /** Try to insert one object in the target.
-    When an item is handed out it is moved to the end of the container.
+    The container holds its items in random order. A run of at most
+    `probes` items, from a random position, is offered to the target, so
+    the cost does not grow with the size of the container.
     @return The number of objects inserted
 */
-// VFALCO TODO specialization that handles std::list for SequenceContainer
-//             using splice for optimization over erase/push_back
-//
 template <class Target, class HopContainer>
 std::size_t
-handout_one(Target& t, HopContainer& h)
+handout_one(Target& t, HopContainer const& h, std::size_t probes)
 {
     assert(!t.full());
-    for (auto it = h.begin(); it != h.end(); ++it)
+    std::size_t const size = h.size();
+    if (size == 0)
+        return 0;
+
+    std::size_t const start = (size > 1) ? rand_int(size - 1) : 0;
+    probes = std::min(size, probes);
+    for (std::size_t i = 0; i < probes; ++i)
     {
-        auto const& e = *it;
-        if (t.try_insert(e))
-        {
-            h.move_back(it);
+        if (t.try_insert(h[(start + i) % size]))
             return 1;
-        }
     }
     return 0;
 }
@@ -70,9 +74,14 @@ handout(
     SeqFwdIter seq_first,
     SeqFwdIter seq_last)
 {
+    // Rounds offer each target a few items from every container. A round
+    // which hands nothing out may have missed acceptable items, so every
+    // item is offered before giving up.
+    std::size_t probes = Tuning::handoutProbes;
     for (;;)
     {
         std::size_t n(0);
+        bool covered(true);
         for (auto si = seq_first; si != seq_last; ++si)
         {
             auto c = *si;
@@ -82,15 +91,21 @@ handout(
                 auto& t = *ti;
                 if (!t.full())
                 {
-                    n += detail::handout_one(t, c);
+                    n += detail::handout_one(t, c, probes);
                     all_full = false;
                 }
             }
             if (all_full)
                 return;
+            if (c.size() > probes)
+                covered = false;
         }
-        if (!n)
+        if (n)
+            probes = Tuning::handoutProbes;
+        else if (covered)
             break;
+        else
+            probes = std::numeric_limits<std::size_t>::max();
     }
 }
 
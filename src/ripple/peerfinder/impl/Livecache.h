@@ -27,10 +27,10 @@
 #include <ripple/peerfinder/PeerfinderManager.h>
 #include <ripple/peerfinder/impl/Tuning.h>
 #include <ripple/peerfinder/impl/iosformat.h>
-#include <boost/intrusive/list.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 
 #include <algorithm>
+#include <vector>
 
 namespace ripple {
 namespace PeerFinder {
@@ -46,22 +46,26 @@ public:
     explicit LivecacheBase() = default;
 
 protected:
-    struct Element : boost::intrusive::list_base_hook<>
+    struct Element
     {
         Element(Endpoint const& endpoint_) : endpoint(endpoint_)
         {
         }
 
         Endpoint endpoint;
+
+        // Position of the element in its hop list
+        std::size_t index = 0;
     };
 
-    using list_type = boost::intrusive::
-        make_list<Element, boost::intrusive::constant_time_size<false>>::type;
+    // The elements at the same hops, kept in random order so that any
+    // run of consecutive elements is a random sample of the list.
+    using list_type = std::vector<Element*>;
 
 public:
     /** A list of Endpoint at the same hops
         This is a lightweight wrapper around a reference to the underlying
-        container.
+        container. The endpoints are in random order.
     */
     template <bool IsConst>
     class Hop
@@ -70,20 +74,20 @@ public:
         // Iterator transformation to extract the endpoint from Element
         struct Transform
 #ifdef _LIBCPP_VERSION
-            : public std::unary_function<Element, Endpoint>
+            : public std::unary_function<Element const*, Endpoint>
 #endif
         {
 #ifndef _LIBCPP_VERSION
-            using first_argument = Element;
+            using first_argument = Element const*;
             using result_type = Endpoint;
 #endif
 
             explicit Transform() = default;
 
             Endpoint const&
-            operator()(Element const& e) const
+            operator()(Element const* e) const
             {
-                return e.endpoint;
+                return e->endpoint;
             }
         };
 
@@ -147,13 +151,22 @@ public:
             return reverse_iterator(m_list.get().crend(), Transform());
         }
 
-        // move the element to the end of the container
-        void
-        move_back(const_iterator pos)
+        std::size_t
+        size() const
+        {
+            return m_list.get().size();
+        }
+
+        bool
+        empty() const
         {
-            auto& e(const_cast<Element&>(*pos.base()));
-            m_list.get().erase(m_list.get().iterator_to(e));
-            m_list.get().push_back(e);
+            return m_list.get().empty();
+        }
+
+        Endpoint const&
+        operator[](std::size_t i) const
+        {
+            return m_list.get()[i]->endpoint;
         }
 
     private:
@@ -348,10 +361,6 @@ public:
             return const_reverse_iterator(m_lists.crend(), Transform<true>());
         }
 
-        /** Shuffle each hop list. */
-        void
-        shuffle();
-
         std::string
         histogram() const;
 
@@ -502,22 +511,6 @@ Livecache<Allocator>::onWrite(beast::PropertyStream::Map& map)
 
 //------------------------------------------------------------------------------
 
-template <class Allocator>
-void
-Livecache<Allocator>::hops_t::shuffle()
-{
-    for (auto& list : m_lists)
-    {
-        std::vector<std::reference_wrapper<Element>> v;
-        v.reserve(list.size());
-        std::copy(list.begin(), list.end(), std::back_inserter(v));
-        std::shuffle(v.begin(), v.end(), default_prng());
-        list.clear();
-        for (auto& e : v)
-            list.push_back(e);
-    }
-}
-
 template <class Allocator>
 std::string
 Livecache<Allocator>::hops_t::histogram() const
@@ -541,8 +534,14 @@ void
 Livecache<Allocator>::hops_t::insert(Element& e)
 {
     assert(e.endpoint.hops >= 0 && e.endpoint.hops <= Tuning::maxHops + 1);
-    // This has security implications without a shuffle
-    m_lists[e.endpoint.hops].push_front(e);
+    // This has security implications without a random position: swap the
+    // new element with a random one, which keeps the list shuffled.
+    list_type& list(m_lists[e.endpoint.hops]);
+    list.push_back(&e);
+    std::size_t const i = (list.size() > 1) ? rand_int(list.size() - 1) : 0;
+    std::swap(list[i], list.back());
+    list[i]->index = i;
+    list.back()->index = list.size() - 1;
     ++m_hist[e.endpoint.hops];
 }
 
@@ -551,9 +550,7 @@ void
 Livecache<Allocator>::hops_t::reinsert(Element& e, int numHops)
 {
     assert(numHops >= 0 && numHops <= Tuning::maxHops + 1);
-    list_type& list(m_lists[e.endpoint.hops]);
-    list.erase(list.iterator_to(e));
-    --m_hist[e.endpoint.hops];
+    remove(e);
 
     e.endpoint.hops = numHops;
     insert(e);
@@ -565,7 +562,10 @@ Livecache<Allocator>::hops_t::remove(Element& e)
 {
     --m_hist[e.endpoint.hops];
     list_type& list(m_lists[e.endpoint.hops]);
-    list.erase(list.iterator_to(e));
+    assert(list[e.index] == &e);
+    list[e.index] = list.back();
+    list[e.index]->index = e.index;
+    list.pop_back();
 }
 
 }  // namespace PeerFinder
@@ -452,7 +452,6 @@ public:
     {
         std::lock_guard _(lock_);
         RedirectHandouts h(slot);
-        livecache_.hops.shuffle();
         handout(&h, (&h) + 1, livecache_.hops.begin(), livecache_.hops.end());
         return std::move(h.list());
     }
@@ -523,7 +522,6 @@ public:
         //    Any outbound attempts are in progress
         //
         {
-            livecache_.hops.shuffle();
             handout(
                 &h, (&h) + 1, livecache_.hops.rbegin(), livecache_.hops.rend());
             if (!h.list().empty())
@@ -643,7 +641,6 @@ public:
             }
 
             // build sequence of endpoints by hops
-            livecache_.hops.shuffle();
             handout(
                 targets.begin(),
                 targets.end(),
@@ -671,19 +668,26 @@ public:
     void
     once_per_second()
     {
-        std::lock_guard _(lock_);
+        boost::optional<Bootcache::Entries> entries;
+        {
+            std::lock_guard _(lock_);
 
-        // Expire the Livecache
-        livecache_.expire();
+            // Expire the Livecache
+            livecache_.expire();
 
-        // Expire the recent cache in each slot
-        for (auto const& entry : slots_)
-            entry.second->expire();
+            // Expire the recent cache in each slot
+            for (auto const& entry : slots_)
+                entry.second->expire();
 
-        // Expire the recent attempts table
-        beast::expire(m_squelches, Tuning::recentAttemptDuration);
+            // Expire the recent attempts table
+            beast::expire(m_squelches, Tuning::recentAttemptDuration);
+
+            entries = bootcache_.periodicActivity();
+        }
 
-        bootcache_.periodicActivity();
+        // Writing to the Store is slow, don't hold up the other callers
+        if (entries)
+            m_store.save(*entries);
     }
 
     //--------------------------------------------------------------------------
@@ -126,6 +126,10 @@ enum {
     /** Number of addresses we provide when redirecting. */
     ,
     redirectEndpointCount = 10
+
+    /** The most endpoints at one hops offered to a target per handout. */
+    ,
+    handoutProbes = 32
 };
 
 // How often we send or accept mtENDPOINTS messages per peer
@@ -22,6 +22,7 @@
 
 #include <ripple/basics/safe_cast.h>
 #include <ripple/json/json_value.h>
+#include <array>
 #include <cstdint>
 #include <map>
 #include <utility>
@@ -272,8 +273,27 @@ public:
     compare(const SField& f1, const SField& f2);
 
 private:
+    // The fields with a common type and a binary value are also indexed
+    // directly by type and value, which is what deserialization looks up.
+    static constexpr int denseTypes = 32;
+    static constexpr int denseValues = 256;
+
+    static int
+    denseIndex(int code)
+    {
+        if (code < 0)
+            return -1;
+        int const type = code >> 16;
+        int const value = code & 0xffff;
+        if (type >= denseTypes || value >= denseValues)
+            return -1;
+        return type * denseValues + value;
+    }
+
     static int num;
     static std::map<int, SField const*> knownCodeToField;
+    static std::array<SField const*, denseTypes * denseValues>
+        knownCodeToDenseField;
 };
 
 /** A field with a type known at compile time. */
@@ -0,0 +1,232 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PROTOCOL_STLEDGERENTRYVIEW_H_INCLUDED
+#define RIPPLE_PROTOCOL_STLEDGERENTRYVIEW_H_INCLUDED
+
+#include <ripple/basics/CountedObject.h>
+#include <ripple/basics/Slice.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <boost/optional.hpp>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ripple {
+
+/** A read-only view of a serialized ledger entry.
+
+    Building the view only locates the fields in the serialized data; a
+    field is decoded when it is read, so reading a few fields of an entry
+    costs much less than deserializing it into an STLedgerEntry.
+
+    The view does not copy the data: it keeps alive whatever owns it,
+    usually the SHAMapItem the entry was read from.
+
+    Fields are read with the same typed accessors as an STObject, and a
+    field absent from the data reads as the default value if the entry's
+    template allows it to be omitted.
+*/
+class STLedgerEntryView final : public CountedObject<STLedgerEntryView>
+{
+public:
+    using pointer = std::shared_ptr<STLedgerEntryView const>;
+
+    /** Create a view of serialized data.
+
+        @param data  The serialized entry, valid as long as owner is.
+        @param key  The key of the entry.
+        @param owner  The owner of the data.
+    */
+    STLedgerEntryView(
+        Slice data,
+        uint256 const& key,
+        std::shared_ptr<void const> owner);
+
+    /** Create a view of a copy of the serialized entry. */
+    explicit STLedgerEntryView(STLedgerEntry const& sle);
+
+    static char const*
+    getCountedObjectName()
+    {
+        return "STLedgerEntryView";
+    }
+
+    uint256 const&
+    key() const
+    {
+        return key_;
+    }
+
+    LedgerEntryType
+    getType() const
+    {
+        return type_;
+    }
+
+    /** Returns the serialized entry. */
+    Slice
+    slice() const
+    {
+        return data_;
+    }
+
+    bool
+    isFieldPresent(SField const& field) const
+    {
+        return find(field) != nullptr;
+    }
+
+    /** Read a field.
+
+        @throws STObject::FieldErr if the field is missing and the template
+                does not give it a default.
+    */
+    template <class T>
+    std::decay_t<typename T::value_type>
+    operator[](TypedField<T> const& f) const
+    {
+        return at(f);
+    }
+
+    /** Read an optional field.
+
+        @return boost::none if the field is missing and the template does
+                not give it a default.
+    */
+    template <class T>
+    boost::optional<std::decay_t<typename T::value_type>>
+    operator[](OptionaledField<T> const& of) const
+    {
+        return at(of);
+    }
+
+    template <class T>
+    std::decay_t<typename T::value_type>
+    at(TypedField<T> const& f) const;
+
+    template <class T>
+    boost::optional<std::decay_t<typename T::value_type>>
+    at(OptionaledField<T> const& of) const;
+
+    /** Decode an inner object or array field.
+
+        @throws STObject::FieldErr if the field is missing.
+    */
+    STObject
+    getFieldObject(SField const& field) const;
+
+    STArray
+    getFieldArray(SField const& field) const;
+
+    /** Returns the fully deserialized entry. */
+    std::shared_ptr<STLedgerEntry const>
+    sle() const;
+
+private:
+    // Where the value of a field lies in data_, after the field's id
+    struct Field
+    {
+        int code;
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    STLedgerEntryView(std::shared_ptr<Serializer> data, uint256 const& key);
+
+    Field const*
+    find(SField const& field) const;
+
+    SerialIter
+    iter(Field const& field) const
+    {
+        return SerialIter{data_.data() + field.offset, field.size};
+    }
+
+    // Returns whether an absent field reads as its default value
+    bool
+    hasDefault(SField const& field) const;
+
+    [[noreturn]] static void
+    missing(SField const& field);
+
+    std::shared_ptr<void const> owner_;
+    Slice data_;
+    uint256 key_;
+    LedgerEntryType type_;
+    SOTemplate const* template_ = nullptr;
+
+    // Sorted by field code
+    std::vector<Field> fields_;
+};
+
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+// Variable length data is read in place, without a copy.
+template <class T>
+std::decay_t<typename T::value_type>
+viewValue(SerialIter& sit, SField const& f)
+{
+    if constexpr (std::is_same_v<T, STBlob>)
+    {
+        auto const size = sit.getVLDataLength();
+        return sit.getSlice(size);
+    }
+    else
+    {
+        return T(sit, f).value();
+    }
+}
+
+}  // namespace detail
+
+template <class T>
+std::decay_t<typename T::value_type>
+STLedgerEntryView::at(TypedField<T> const& f) const
+{
+    if (auto const field = find(f))
+    {
+        auto sit = iter(*field);
+        return detail::viewValue<T>(sit, f);
+    }
+    if (!hasDefault(f))
+        missing(f);
+    return {};
+}
+
+template <class T>
+boost::optional<std::decay_t<typename T::value_type>>
+STLedgerEntryView::at(OptionaledField<T> const& of) const
+{
+    if (auto const field = find(*of.f))
+    {
+        auto sit = iter(*field);
+        return detail::viewValue<T>(sit, *of.f);
+    }
+    if (!hasDefault(*of.f))
+        return boost::none;
+    return std::decay_t<typename T::value_type>{};
+}
+
+}  // namespace ripple
+
+#endif
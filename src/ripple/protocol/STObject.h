@@ -666,6 +666,30 @@ private:
     static std::vector<STBase const*>
     getSortedFields(STObject const& objToSort, WhichFields whichFields);
 
+    // The class of a field's value follows from the field's serialized type,
+    // so for a typed field comparing the types is enough to downcast, and is
+    // much cheaper than a dynamic_cast.  Returns nullptr if the field is not
+    // present.
+    template <class T>
+    static T const*
+    typedValue(STBase const* b, SField const& f)
+    {
+        if (!b || b->getSType() != f.fieldType)
+            return nullptr;
+        assert(dynamic_cast<T const*>(b));
+        return static_cast<T const*>(b);
+    }
+
+    template <class T>
+    static T*
+    typedValue(STBase* b, SField const& f)
+    {
+        if (!b || b->getSType() != f.fieldType)
+            return nullptr;
+        assert(dynamic_cast<T*>(b));
+        return static_cast<T*>(b);
+    }
+
     // Implementation for getting (most) fields that return by value.
     //
     // The remove_cv and remove_reference are necessitated by the STBitString
@@ -825,7 +849,7 @@ template <class T>
 inline T const*
 STObject::Proxy<T>::find() const
 {
-    return dynamic_cast<T const*>(st_->peekAtPField(*f_));
+    return typedValue<T>(st_->peekAtPField(*f_), *f_);
 }
 
 template <class T>
@@ -840,9 +864,9 @@ STObject::Proxy<T>::assign(U&& u)
     }
     T* t;
     if (style_ == soeINVALID)
-        t = dynamic_cast<T*>(st_->getPField(*f_, true));
+        t = typedValue<T>(st_->getPField(*f_, true), *f_);
     else
-        t = dynamic_cast<T*>(st_->makeFieldPresent(*f_));
+        t = typedValue<T>(st_->makeFieldPresent(*f_), *f_);
     assert(t);
     *t = std::forward<U>(u);
 }
@@ -1012,7 +1036,7 @@ STObject::at(TypedField<T> const& f) const
         // This is a free object (no constraints)
         // with no template
         Throw<STObject::FieldErr>("Missing field '" + f.getName() + "'");
-    auto const u = dynamic_cast<T const*>(b);
+    auto const u = typedValue<T>(b, f);
     if (!u)
     {
         assert(mType);
@@ -1036,7 +1060,7 @@ STObject::at(OptionaledField<T> const& of) const
     auto const b = peekAtPField(*of.f);
     if (!b)
         return boost::none;
-    auto const u = dynamic_cast<T const*>(b);
+    auto const u = typedValue<T>(b, *of.f);
     if (!u)
     {
         assert(mType);
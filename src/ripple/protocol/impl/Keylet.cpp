@@ -19,6 +19,7 @@
 
 #include <ripple/protocol/Keylet.h>
 #include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STLedgerEntryView.h>
 
 namespace ripple {
 
@@ -37,4 +38,19 @@ Keylet::check(SLE const& sle) const
     return sle.getType() == type;
 }
 
+bool
+Keylet::check(STLedgerEntryView const& view) const
+{
+    if (type == ltANY)
+        return true;
+    if (type == ltINVALID)
+        return false;
+    if (type == ltCHILD)
+    {
+        assert(view.getType() != ltDIR_NODE);
+        return view.getType() != ltDIR_NODE;
+    }
+    return view.getType() == type;
+}
+
 }  // namespace ripple
@@ -29,6 +29,8 @@ namespace ripple {
 SField::IsSigning const SField::notSigning;
 int SField::num = 0;
 std::map<int, SField const*> SField::knownCodeToField;
+std::array<SField const*, SField::denseTypes * SField::denseValues>
+    SField::knownCodeToDenseField{};
 
 // Give only this translation unit permission to construct SFields
 struct SField::private_access_tag_t
@@ -303,6 +305,8 @@ SField::SField(
     , jsonName(fieldName.c_str())
 {
     knownCodeToField[fieldCode] = this;
+    if (auto const i = denseIndex(fieldCode); i >= 0)
+        knownCodeToDenseField[i] = this;
 }
 
 SField::SField(private_access_tag_t, int fc)
@@ -315,11 +319,20 @@ SField::SField(private_access_tag_t, int fc)
     , jsonName(fieldName.c_str())
 {
     knownCodeToField[fieldCode] = this;
+    if (auto const i = denseIndex(fieldCode); i >= 0)
+        knownCodeToDenseField[i] = this;
 }
 
 SField const&
 SField::getField(int code)
 {
+    if (auto const i = denseIndex(code); i >= 0)
+    {
+        if (auto const f = knownCodeToDenseField[i])
+            return *f;
+        return sfInvalid;
+    }
+
     auto it = knownCodeToField.find(code);
 
     if (it != knownCodeToField.end())
@@ -0,0 +1,300 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/contract.h>
+#include <ripple/basics/safe_cast.h>
+#include <ripple/protocol/LedgerFormats.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STLedgerEntryView.h>
+#include <ripple/protocol/STPathSet.h>
+#include <algorithm>
+
+namespace ripple {
+
+namespace {
+
+void
+skipValue(SerialIter& sit, SField const& field, int depth);
+
+SField const&
+nextField(SerialIter& sit, int& type, int& value)
+{
+    sit.getFieldID(type, value);
+    if ((type == STI_OBJECT || type == STI_ARRAY) && value == 1)
+        return sfInvalid;
+
+    auto const& field = SField::getField(type, value);
+    if (field.isInvalid())
+        Throw<std::runtime_error>("Unknown field");
+    return field;
+}
+
+// Skips the fields of an inner object, up to and including its end marker.
+void
+skipObject(SerialIter& sit, int depth)
+{
+    if (depth > 10)
+        Throw<std::runtime_error>("Maximum nesting depth of STObject exceeded");
+
+    while (!sit.empty())
+    {
+        int type;
+        int value;
+        auto const& field = nextField(sit, type, value);
+        if (field.isInvalid())
+        {
+            if (type == STI_ARRAY)
+                Throw<std::runtime_error>(
+                    "Illegal end-of-array marker in object");
+            return;
+        }
+        skipValue(sit, field, depth + 1);
+    }
+}
+
+void
+skipArray(SerialIter& sit, int depth)
+{
+    while (!sit.empty())
+    {
+        int type;
+        int value;
+        auto const& field = nextField(sit, type, value);
+        if (field.isInvalid())
+        {
+            if (type == STI_OBJECT)
+                Throw<std::runtime_error>("Illegal terminator in array");
+            return;
+        }
+        if (field.fieldType != STI_OBJECT)
+            Throw<std::runtime_error>("Non-object in array");
+        skipObject(sit, depth + 1);
+    }
+}
+
+void
+skipPathSet(SerialIter& sit)
+{
+    for (;;)
+    {
+        int const type = sit.get8();
+        if (type == STPathElement::typeNone)
+            return;
+        if (type == STPathElement::typeBoundary)
+            continue;
+        if (type & ~STPathElement::typeAll)
+            Throw<std::runtime_error>("bad path element");
+
+        for (int const part :
+             {STPathElement::typeAccount,
+              STPathElement::typeCurrency,
+              STPathElement::typeIssuer})
+        {
+            if (type & part)
+                sit.skip(160 / 8);
+        }
+    }
+}
+
+// Skips the value of a field, checking only its framing
+void
+skipValue(SerialIter& sit, SField const& field, int depth)
+{
+    if (depth > 10)
+        Throw<std::runtime_error>("Maximum nesting depth of STVar exceeded");
+
+    switch (field.fieldType)
+    {
+        case STI_UINT8:
+            sit.skip(1);
+            return;
+        case STI_UINT16:
+            sit.skip(2);
+            return;
+        case STI_UINT32:
+            sit.skip(4);
+            return;
+        case STI_UINT64:
+            sit.skip(8);
+            return;
+        case STI_HASH128:
+            sit.skip(128 / 8);
+            return;
+        case STI_HASH160:
+            sit.skip(160 / 8);
+            return;
+        case STI_HASH256:
+            sit.skip(256 / 8);
+            return;
+        case STI_AMOUNT:
+            // An issued amount is followed by its currency and issuer
+            if (sit.get64() & STAmount::cNotNative)
+                sit.skip(2 * 160 / 8);
+            return;
+        case STI_VL:
+        case STI_ACCOUNT:
+        case STI_VECTOR256:
+            sit.skip(sit.getVLDataLength());
+            return;
+        case STI_PATHSET:
+            skipPathSet(sit);
+            return;
+        case STI_OBJECT:
+            skipObject(sit, depth);
+            return;
+        case STI_ARRAY:
+            skipArray(sit, depth);
+            return;
+        default:
+            Throw<std::runtime_error>("Unknown object type");
+    }
+}
+
+}  // namespace
+
+STLedgerEntryView::STLedgerEntryView(
+    Slice data,
+    uint256 const& key,
+    std::shared_ptr<void const> owner)
+    : owner_(std::move(owner)), data_(data), key_(key)
+{
+    SerialIter sit(data_);
+    while (!sit.empty())
+    {
+        int type;
+        int value;
+        sit.getFieldID(type, value);
+        if (type == STI_OBJECT && value == 1)
+            break;
+        if (type == STI_ARRAY && value == 1)
+            Throw<std::runtime_error>("Illegal end-of-array marker in object");
+
+        auto const& field = SField::getField(type, value);
+        if (field.isInvalid())
+            Throw<std::runtime_error>("Unknown field");
+
+        auto const offset = data_.size() - sit.getBytesLeft();
+        skipValue(sit, field, 1);
+        fields_.push_back(
+            {field.fieldCode,
+             static_cast<std::uint32_t>(offset),
+             static_cast<std::uint32_t>(
+                 data_.size() - sit.getBytesLeft() - offset)});
+    }
+
+    // Canonical entries are sorted already
+    auto const byCode = [](Field const& a, Field const& b) {
+        return a.code < b.code;
+    };
+    if (!std::is_sorted(fields_.begin(), fields_.end(), byCode))
+        std::sort(fields_.begin(), fields_.end(), byCode);
+    if (std::adjacent_find(
+            fields_.begin(),
+            fields_.end(),
+            [](Field const& a, Field const& b) { return a.code == b.code; }) !=
+        fields_.end())
+        Throw<std::runtime_error>("Duplicate field detected");
+
+    auto const format = LedgerFormats::getInstance().findByType(
+        safe_cast<LedgerEntryType>(at(sfLedgerEntryType)));
+    if (format == nullptr)
+        Throw<std::runtime_error>("invalid ledger entry type");
+    type_ = format->getType();
+    template_ = &format->getSOTemplate();
+}
+
+namespace {
+
+std::shared_ptr<Serializer>
+serialize(STLedgerEntry const& sle)
+{
+    auto s = std::make_shared<Serializer>();
+    sle.add(*s);
+    return s;
+}
+
+}  // namespace
+
+STLedgerEntryView::STLedgerEntryView(STLedgerEntry const& sle)
+    : STLedgerEntryView(serialize(sle), sle.key())
+{
+}
+
+STLedgerEntryView::STLedgerEntryView(
+    std::shared_ptr<Serializer> data,
+    uint256 const& key)
+    : STLedgerEntryView(data->slice(), key, data)
+{
+}
+
+STObject
+STLedgerEntryView::getFieldObject(SField const& field) const
+{
+    auto const f = find(field);
+    if (!f || field.fieldType != STI_OBJECT)
+        missing(field);
+    auto sit = iter(*f);
+    STObject obj(sit, field, 1);
+    obj.applyTemplateFromSField(field);
+    return obj;
+}
+
+STArray
+STLedgerEntryView::getFieldArray(SField const& field) const
+{
+    auto const f = find(field);
+    if (!f || field.fieldType != STI_ARRAY)
+        missing(field);
+    auto sit = iter(*f);
+    return STArray(sit, field, 1);
+}
+
+std::shared_ptr<STLedgerEntry const>
+STLedgerEntryView::sle() const
+{
+    return std::make_shared<STLedgerEntry>(SerialIter{data_}, key_);
+}
+
+auto
+STLedgerEntryView::find(SField const& field) const -> Field const*
+{
+    auto const it = std::lower_bound(
+        fields_.begin(),
+        fields_.end(),
+        field.fieldCode,
+        [](Field const& f, int code) { return f.code < code; });
+    if (it == fields_.end() || it->code != field.fieldCode)
+        return nullptr;
+    return &*it;
+}
+
+bool
+STLedgerEntryView::hasDefault(SField const& field) const
+{
+    return template_ && template_->getIndex(field) >= 0 &&
+        template_->style(field) == soeDEFAULT;
+}
+
+void
+STLedgerEntryView::missing(SField const& field)
+{
+    Throw<STObject::FieldErr>("Missing field '" + field.getName() + "'");
+}
+
+}  // namespace ripple
@@ -20,7 +20,11 @@
 #include <ripple/protocol/digest.h>
 #include <openssl/ripemd.h>
 #include <openssl/sha.h>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
 #include <type_traits>
+#include <vector>
 
 namespace ripple {
 
@@ -103,4 +107,275 @@ openssl_sha256_hasher::operator result_type() noexcept
     return digest;
 }
 
+//------------------------------------------------------------------------------
+
+namespace {
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+// The messages are hashed with the portable vector extensions of GCC and
+// clang, which compile to AVX2 or AVX-512 inside functions targeting them.
+#define RIPPLE_SHA512_LANES 1
+
+std::uint64_t constexpr sha512K[80] = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f,
+    0xe9b5dba58189dbbc, 0x3956c25bf348b538, 0x59f111f1b605d019,
+    0x923f82a4af194f9b, 0xab1c5ed5da6d8118, 0xd807aa98a3030242,
+    0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+    0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235,
+    0xc19bf174cf692694, 0xe49b69c19ef14ad2, 0xefbe4786384f25e3,
+    0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65, 0x2de92c6f592b0275,
+    0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f,
+    0xbf597fc7beef0ee4, 0xc6e00bf33da88fc2, 0xd5a79147930aa725,
+    0x06ca6351e003826f, 0x142929670a0e6e70, 0x27b70a8546d22ffc,
+    0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+    0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6,
+    0x92722c851482353b, 0xa2bfe8a14cf10364, 0xa81a664bbc423001,
+    0xc24b8b70d0f89791, 0xc76c51a30654be30, 0xd192e819d6ef5218,
+    0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99,
+    0x34b0bcb5e19b48a8, 0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb,
+    0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3, 0x748f82ee5defb2fc,
+    0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915,
+    0xc67178f2e372532b, 0xca273eceea26619c, 0xd186b8c721c0c207,
+    0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178, 0x06f067aa72176fba,
+    0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc,
+    0x431d67c49c100d4c, 0x4cc5d4becb3e42b6, 0x597f299cfc657e2a,
+    0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+
+std::uint64_t constexpr sha512H[8] = {
+    0x6a09e667f3bcc908,
+    0xbb67ae8584caa73b,
+    0x3c6ef372fe94f82b,
+    0xa54ff53a5f1d36f1,
+    0x510e527fade682d1,
+    0x9b05688c2b3e6c1f,
+    0x1f83d9abfb41bd6b,
+    0x5be0cd19137e2179};
+
+// A message with its padding. The blocks before `full` are read in place,
+// the padded tail of the message is copied.
+struct PaddedMessage
+{
+    std::uint8_t const* data;
+    std::size_t full;
+    std::uint8_t tail[256];
+
+    std::uint8_t const*
+    block(std::size_t b) const
+    {
+        return b < full ? data + 128 * b : tail + 128 * (b - full);
+    }
+};
+
+// Returns the number of blocks in the padded message
+std::size_t
+paddedBlocks(std::size_t size)
+{
+    return (size + 17 + 127) / 128;
+}
+
+void
+pad(Slice message, PaddedMessage& padded)
+{
+    auto const blocks = paddedBlocks(message.size());
+    padded.data = message.data();
+    padded.full = message.size() / 128;
+
+    auto const rest = message.size() - 128 * padded.full;
+    auto const tail = 128 * (blocks - padded.full);
+    std::memset(padded.tail, 0, tail);
+    if (rest != 0)
+        std::memcpy(padded.tail, message.data() + 128 * padded.full, rest);
+    padded.tail[rest] = 0x80;
+
+    auto const bits = boost::endian::native_to_big(
+        static_cast<std::uint64_t>(message.size()) * 8);
+    std::memcpy(padded.tail + tail - 8, &bits, 8);
+}
+
+template <std::size_t Lanes>
+struct LaneVector
+{
+    using type __attribute__((vector_size(8 * Lanes))) = std::uint64_t;
+};
+
+// Rotates each lane right. A macro rather than a function, since outside
+// of the functions targeting AVX a function returning a vector would have
+// an ABI of its own.
+#define RIPPLE_ROTR(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+// Hashes one message in each lane. The messages have the same number of
+// blocks.
+template <std::size_t Lanes>
+[[gnu::always_inline]] inline void
+hashLanes(PaddedMessage const* messages, std::size_t blocks, uint256** digests)
+{
+    using V = typename LaneVector<Lanes>::type;
+
+    V h[8];
+    for (int i = 0; i < 8; ++i)
+        h[i] = V{} + sha512H[i];
+
+    for (std::size_t b = 0; b < blocks; ++b)
+    {
+        V w[80];
+        for (std::size_t l = 0; l < Lanes; ++l)
+        {
+            auto const block = messages[l].block(b);
+            for (int t = 0; t < 16; ++t)
+            {
+                std::uint64_t x;
+                std::memcpy(&x, block + 8 * t, 8);
+                w[t][l] = boost::endian::big_to_native(x);
+            }
+        }
+
+        for (int t = 16; t < 80; ++t)
+        {
+            V const s0 = RIPPLE_ROTR(w[t - 15], 1) ^
+                RIPPLE_ROTR(w[t - 15], 8) ^ (w[t - 15] >> 7);
+            V const s1 = RIPPLE_ROTR(w[t - 2], 19) ^
+                RIPPLE_ROTR(w[t - 2], 61) ^ (w[t - 2] >> 6);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        V a = h[0], bb = h[1], c = h[2], d = h[3];
+        V e = h[4], f = h[5], g = h[6], hh = h[7];
+        for (int t = 0; t < 80; ++t)
+        {
+            V const t1 = hh +
+                (RIPPLE_ROTR(e, 14) ^ RIPPLE_ROTR(e, 18) ^ RIPPLE_ROTR(e, 41)) +
+                ((e & f) ^ (~e & g)) + sha512K[t] + w[t];
+            V const t2 =
+                (RIPPLE_ROTR(a, 28) ^ RIPPLE_ROTR(a, 34) ^ RIPPLE_ROTR(a, 39)) +
+                ((a & bb) ^ (a & c) ^ (bb & c));
+            hh = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = bb;
+            bb = a;
+            a = t1 + t2;
+        }
+
+        h[0] += a;
+        h[1] += bb;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+        h[5] += f;
+        h[6] += g;
+        h[7] += hh;
+    }
+
+    // The digest is the first half of the state, big-endian
+    for (std::size_t l = 0; l < Lanes; ++l)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            auto const x = boost::endian::native_to_big(
+                static_cast<std::uint64_t>(h[i][l]));
+            std::memcpy(digests[l]->data() + 8 * i, &x, 8);
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void
+hashLanesAVX2(
+    PaddedMessage const* messages,
+    std::size_t blocks,
+    uint256** digests)
+{
+    hashLanes<4>(messages, blocks, digests);
+}
+
+__attribute__((target("avx512f"))) void
+hashLanesAVX512(
+    PaddedMessage const* messages,
+    std::size_t blocks,
+    uint256** digests)
+{
+    hashLanes<8>(messages, blocks, digests);
+}
+
+#undef RIPPLE_ROTR
+
+// The number of messages hashed at once, or 1 without vector support
+std::size_t
+maxLanes()
+{
+    static std::size_t const lanes = []() -> std::size_t {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return 8;
+        if (__builtin_cpu_supports("avx2"))
+            return 4;
+        return 1;
+    }();
+    return lanes;
+}
+
+#endif
+
+}  // namespace
+
+void
+sha512HalfBatch(Slice const* messages, uint256* digests, std::size_t count)
+{
+#ifdef RIPPLE_SHA512_LANES
+    auto const lanes = maxLanes();
+    if (lanes > 1 && count >= 4)
+    {
+        // Group the messages by their number of blocks
+        std::vector<std::size_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(
+            order.begin(), order.end(), [messages](auto a, auto b) {
+                return paddedBlocks(messages[a].size()) <
+                    paddedBlocks(messages[b].size());
+            });
+
+        PaddedMessage padded[8];
+        uint256* out[8];
+        for (auto first = order.begin(); first != order.end();)
+        {
+            auto const blocks = paddedBlocks(messages[*first].size());
+            auto last = first;
+            while (last != order.end() &&
+                   paddedBlocks(messages[*last].size()) == blocks)
+                ++last;
+
+            for (std::size_t const n : {std::size_t{8}, std::size_t{4}})
+            {
+                while (n <= lanes &&
+                       static_cast<std::size_t>(last - first) >= n)
+                {
+                    for (std::size_t l = 0; l < n; ++l, ++first)
+                    {
+                        pad(messages[*first], padded[l]);
+                        out[l] = &digests[*first];
+                    }
+                    if (n == 8)
+                        hashLanesAVX512(padded, blocks, out);
+                    else
+                        hashLanesAVX2(padded, blocks, out);
+                }
+            }
+
+            for (; first != last; ++first)
+                digests[*first] = sha512Half(messages[*first]);
+        }
+        return;
+    }
+#endif
+
+    for (std::size_t i = 0; i < count; ++i)
+        digests[i] = sha512Half(messages[i]);
+}
+
 }  // namespace ripple
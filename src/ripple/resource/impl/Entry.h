@@ -25,6 +25,7 @@
 #include <ripple/beast/core/List.h>
 #include <ripple/resource/impl/Key.h>
 #include <ripple/resource/impl/Tuning.h>
+#include <atomic>
 #include <cassert>
 
 namespace ripple {
@@ -69,7 +70,7 @@ struct Entry : public beast::List<Entry>::Node
 
     // Balance including remote contributions
     int
-    balance(clock_type::time_point const now)
+    balance(clock_type::time_point const now) const
     {
         return local_balance.value(now) + remote_balance;
     }
@@ -88,11 +89,12 @@ struct Entry : public beast::List<Entry>::Node
     // Number of Consumer references
     int refcount;
 
-    // Exponentially decaying balance of resource consumption
-    DecayingSample<decayWindowSeconds, clock_type> local_balance;
+    // Exponentially decaying balance of resource consumption, charged
+    // without holding the Logic lock
+    AtomicDecayingSample<decayWindowSeconds, clock_type> local_balance;
 
     // Normalized balance contribution from imports
-    int remote_balance;
+    std::atomic<int> remote_balance;
 
     // Time of the last warning
     clock_type::time_point lastWarningTime;
@@ -215,36 +215,39 @@ public:
         for (auto& inboundEntry : inbound_)
         {
             int localBalance = inboundEntry.local_balance.value(now);
-            if ((localBalance + inboundEntry.remote_balance) >= threshold)
+            int remoteBalance = inboundEntry.remote_balance;
+            if ((localBalance + remoteBalance) >= threshold)
             {
                 Json::Value& entry =
                     (ret[inboundEntry.to_string()] = Json::objectValue);
                 entry[jss::local] = localBalance;
-                entry[jss::remote] = inboundEntry.remote_balance;
+                entry[jss::remote] = remoteBalance;
                 entry[jss::type] = "inbound";
             }
         }
         for (auto& outboundEntry : outbound_)
         {
             int localBalance = outboundEntry.local_balance.value(now);
-            if ((localBalance + outboundEntry.remote_balance) >= threshold)
+            int remoteBalance = outboundEntry.remote_balance;
+            if ((localBalance + remoteBalance) >= threshold)
             {
                 Json::Value& entry =
                     (ret[outboundEntry.to_string()] = Json::objectValue);
                 entry[jss::local] = localBalance;
-                entry[jss::remote] = outboundEntry.remote_balance;
+                entry[jss::remote] = remoteBalance;
                 entry[jss::type] = "outbound";
             }
         }
         for (auto& adminEntry : admin_)
         {
             int localBalance = adminEntry.local_balance.value(now);
-            if ((localBalance + adminEntry.remote_balance) >= threshold)
+            int remoteBalance = adminEntry.remote_balance;
+            if ((localBalance + remoteBalance) >= threshold)
             {
                 Json::Value& entry =
                     (ret[adminEntry.to_string()] = Json::objectValue);
                 entry[jss::local] = localBalance;
-                entry[jss::remote] = adminEntry.remote_balance;
+                entry[jss::remote] = remoteBalance;
                 entry[jss::type] = "admin";
             }
         }
@@ -441,10 +444,11 @@ public:
         }
     }
 
+    // Charging is lock free, the balances are atomic and a Consumer's
+    // reference keeps its Entry alive
     Disposition
     charge(Entry& entry, Charge const& fee)
     {
-        std::lock_guard _(lock_);
         clock_type::time_point const now(m_clock.now());
         int const balance(entry.add(fee.cost(), now));
         JLOG(m_journal.trace()) << "Charging " << entry << " for " << fee;
@@ -457,6 +461,10 @@ public:
         if (entry.isUnlimited())
             return false;
 
+        // Most consumers are below the threshold, skip the lock for them
+        if (entry.balance(m_clock.now()) < warningThreshold)
+            return false;
+
         std::lock_guard _(lock_);
         bool notify(false);
         auto const elapsed = m_clock.now();
@@ -481,6 +489,9 @@ public:
         if (entry.isUnlimited())
             return false;
 
+        if (entry.balance(m_clock.now()) < dropThreshold)
+            return false;
+
         std::lock_guard _(lock_);
         bool drop(false);
         clock_type::time_point const now(m_clock.now());
@@ -504,7 +515,6 @@ public:
     int
     balance(Entry& entry)
     {
-        std::lock_guard _(lock_);
         return entry.balance(m_clock.now());
     }
 
@@ -523,8 +533,8 @@ public:
                 item["count"] = entry.refcount;
             item["name"] = entry.to_string();
             item["balance"] = entry.balance(now);
-            if (entry.remote_balance != 0)
-                item["remote_balance"] = entry.remote_balance;
+            if (auto const remote = entry.remote_balance.load(); remote != 0)
+                item["remote_balance"] = remote;
         }
     }
 
@@ -44,6 +44,9 @@ namespace ripple {
         {"index": 5, "url": "https://domain.com/5.tar.lz4"}
       ]
     }
+
+    A URL ending in '.shard' names a shard archive, see
+    NodeStore::ShardArchiveWriter, which is imported without extraction.
 */
 Json::Value
 doDownloadShard(RPC::JsonContext& context)
@@ -79,6 +82,7 @@ doDownloadShard(RPC::JsonContext& context)
 
     // Validate shards
     static const std::string ext{".tar.lz4"};
+    static const std::string archiveExt{".shard"};
     std::map<std::uint32_t, std::pair<parsedURL, std::string>> archives;
     for (auto& it : context.params[jss::shards])
     {
@@ -107,14 +111,17 @@ doDownloadShard(RPC::JsonContext& context)
                 std::string(jss::url), "HTTPS or HTTP");
 
         // URL must point to an lz4 compressed tar archive '.tar.lz4'
+        // or a shard archive '.shard'
         auto archiveName{url.path.substr(url.path.find_last_of("/\\") + 1)};
-        if (archiveName.empty() || archiveName.size() <= ext.size())
+        if (archiveName.empty() ||
+            archiveName.size() <= std::min(ext.size(), archiveExt.size()))
         {
             return RPC::make_param_error(
                 "Invalid field '" + std::string(jss::url) +
                 "', invalid archive name");
         }
-        if (!boost::iends_with(archiveName, ext))
+        if (!boost::iends_with(archiveName, ext) &&
+            !boost::iends_with(archiveName, archiveExt))
         {
             return RPC::make_param_error(
                 "Invalid field '" + std::string(jss::url) +
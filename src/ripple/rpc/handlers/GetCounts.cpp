@@ -22,6 +22,7 @@
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/basics/PerfLog.h>
 #include <ripple/basics/UptimeClock.h>
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/json/json_value.h>
@@ -32,6 +33,7 @@
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/rpc/Context.h>
+#include <ripple/shamap/SHAMapItem.h>
 #include <ripple/shamap/ShardFamily.h>
 
 namespace ripple {
@@ -112,6 +114,15 @@ getCountsJson(Application& app, int minObjectCount)
     ret[jss::treenode_track_size] =
         app.getNodeFamily().getTreeNodeCache(0)->getTrackSize();
 
+    {
+        auto const m = getSHAMapItemMemory();
+        Json::Value& jv = (ret[jss::shamap_items] = Json::objectValue);
+        jv[jss::slab_reserved_bytes] = std::to_string(m.slabReserved);
+        jv[jss::slab_used_bytes] = std::to_string(m.slabUsed);
+        jv[jss::heap_items] = std::to_string(m.heapItems);
+        jv[jss::heap_bytes] = std::to_string(m.heapBytes);
+    }
+
     std::string uptime;
     auto s = UptimeClock::now();
     using namespace std::chrono_literals;
@@ -122,6 +133,9 @@ getCountsJson(Application& app, int minObjectCount)
     textTime(uptime, s, "second", 1s);
     ret[jss::uptime] = uptime;
 
+    ret[jss::ledger_close] =
+        app.getPerfLog().countersJson()[jss::ledger_close];
+
     if (auto shardStore = app.getShardStore())
     {
         auto shardFamily{dynamic_cast<ShardFamily*>(app.getShardFamily())};
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/ledger/LedgerToJson.h>
+#include <ripple/app/main/Application.h>
 #include <ripple/ledger/ReadView.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/LedgerFormats.h>
@@ -96,34 +97,34 @@ doLedgerData(RPC::JsonContext& context)
     }
     Json::Value& nodes = jvResult[jss::state];
 
-    auto e = lpLedger->sles.end();
-    for (auto i = lpLedger->sles.upper_bound(key); i != e; ++i)
-    {
-        auto sle = lpLedger->read(keylet::unchecked((*i)->key()));
-        if (limit-- <= 0)
-        {
-            // Stop processing before the current key.
-            auto k = sle->key();
-            jvResult[jss::marker] = to_string(--k);
-            break;
-        }
-
-        if (type == ltINVALID || sle->getType() == type)
-        {
+    // Pages larger than a regular page are converted with several threads
+    auto const threads = !lpLedger->open() && limit > maxLimit
+        ? RPC::Tuning::stateThreads()
+        : 1;
+
+    auto const marker = forEachStateJson(
+        *lpLedger,
+        key,
+        limit,
+        type,
+        &context.app.getJobQueue(),
+        threads,
+        [isBinary](SLE const& sle) {
             if (isBinary)
             {
-                Json::Value& entry = nodes.append(Json::objectValue);
-                entry[jss::data] = serializeHex(*sle);
-                entry[jss::index] = to_string(sle->key());
-            }
-            else
-            {
-                Json::Value& entry =
-                    nodes.append(sle->getJson(JsonOptions::none));
-                entry[jss::index] = to_string(sle->key());
+                Json::Value entry{Json::objectValue};
+                entry[jss::data] = serializeHex(sle);
+                entry[jss::index] = to_string(sle.key());
+                return entry;
             }
-        }
-    }
+            auto entry = sle.getJson(JsonOptions::none);
+            entry[jss::index] = to_string(sle.key());
+            return entry;
+        },
+        [&nodes](Json::Value&& entry) { nodes.append(std::move(entry)); });
+
+    if (marker)
+        jvResult[jss::marker] = to_string(*marker);
 
     return jvResult;
 }
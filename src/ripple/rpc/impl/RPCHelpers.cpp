@@ -107,7 +107,8 @@ getAccountObjects(
         found = true;
     }
 
-    auto dir = ledger.read({ltDIR_NODE, dirIndex});
+    // Only the entries which pass the filter are fully deserialized
+    auto dir = ledger.readLazy({ltDIR_NODE, dirIndex});
     if (!dir)
         return false;
 
@@ -115,7 +116,7 @@ getAccountObjects(
     auto& jvObjects = (jvResult[jss::account_objects] = Json::arrayValue);
     for (;;)
     {
-        auto const& entries = dir->getFieldV256(sfIndexes);
+        auto const entries = (*dir)[sfIndexes];
         auto iter = entries.begin();
 
         if (!found)
@@ -129,7 +130,7 @@ getAccountObjects(
 
         for (; iter != entries.end(); ++iter)
         {
-            auto const sleNode = ledger.read(keylet::child(*iter));
+            auto const node = ledger.readLazy(keylet::child(*iter));
 
             auto typeMatchesFilter =
                 [](std::vector<LedgerEntryType> const& typeFilter,
@@ -140,9 +141,9 @@ getAccountObjects(
                 };
 
             if (!typeFilter.has_value() ||
-                typeMatchesFilter(typeFilter.value(), sleNode->getType()))
+                typeMatchesFilter(typeFilter.value(), node->getType()))
             {
-                jvObjects.append(sleNode->getJson(JsonOptions::none));
+                jvObjects.append(node->sle()->getJson(JsonOptions::none));
 
                 if (++i == limit)
                 {
@@ -159,18 +160,18 @@ getAccountObjects(
             }
         }
 
-        auto const nodeIndex = dir->getFieldU64(sfIndexNext);
+        auto const nodeIndex = (*dir)[~sfIndexNext].value_or(0);
         if (nodeIndex == 0)
             return true;
 
         dirIndex = keylet::page(root, nodeIndex).key;
-        dir = ledger.read({ltDIR_NODE, dirIndex});
+        dir = ledger.readLazy({ltDIR_NODE, dirIndex});
         if (!dir)
             return true;
 
         if (i == limit)
         {
-            auto const& e = dir->getFieldV256(sfIndexes);
+            auto const e = (*dir)[sfIndexes];
             if (!e.empty())
             {
                 jvResult[jss::limit] = limit;
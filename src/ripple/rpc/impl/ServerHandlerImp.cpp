@@ -61,6 +61,13 @@ isStatusRequest(http_request_type const& request)
         request.method() == boost::beast::http::verb::get;
 }
 
+static bool
+isMetricsRequest(http_request_type const& request)
+{
+    return request.target() == "/metrics" &&
+        request.method() == boost::beast::http::verb::get;
+}
+
 static Handoff
 statusRequestResponse(
     http_request_type const& request,
@@ -116,6 +123,7 @@ ServerHandlerImp::ServerHandlerImp(
     , m_networkOPs(networkOPs)
     , m_server(make_Server(*this, io_service, app_.journal("Server")))
     , m_jobQueue(jobQueue)
+    , collectorManager_(cm)
 {
     auto const& group(cm.group("rpc"));
     rpc_requests_ = group->make_counter("requests");
@@ -217,6 +225,17 @@ ServerHandlerImp::onHandoff(
         return handoff;
     }
 
+    // Metrics are pulled from any port by an admin, when so configured
+    if (isMetricsRequest(request))
+    {
+        if (auto const& collector = collectorManager_.textCollector())
+        {
+            if (!ipAllowed(remote_address.address(), session.port().admin_ip))
+                return statusRequestResponse(request, http::status::forbidden);
+            return metricsResponse(session, request, collector);
+        }
+    }
+
     if (bundle && p.count("peer") > 0)
         return app_.overlay().onHandoff(
             std::move(bundle), std::move(request), remote_address);
@@ -962,6 +981,39 @@ ServerHandlerImp::statusResponse(http_request_type const& request) const
     return handoff;
 }
 
+// Formatting the metrics runs the collector's hooks, so the response is
+// written from a job rather than the server's I/O thread.
+Handoff
+ServerHandlerImp::metricsResponse(
+    Session& session,
+    http_request_type const& request,
+    std::shared_ptr<beast::insight::TextCollector> const& collector)
+{
+    auto const detached = session.detach();
+    auto const version = request.version();
+    if (!m_jobQueue.addJob(
+            jtCLIENT, "Metrics", [detached, version, collector](Job&) {
+                using namespace boost::beast::http;
+                response<string_body> msg;
+                msg.version(version);
+                msg.result(status::ok);
+                msg.insert("Server", BuildInfo::getFullVersionString());
+                msg.insert("Content-Type", "text/plain; version=0.0.4");
+                msg.insert("Connection", "close");
+                msg.body() = collector->format();
+                msg.prepare_payload();
+                detached->write(std::make_shared<SimpleWriter>(msg), false);
+            }))
+    {
+        return statusRequestResponse(
+            request, boost::beast::http::status::service_unavailable);
+    }
+
+    Handoff handoff;
+    handoff.moved = true;
+    return handoff;
+}
+
 //------------------------------------------------------------------------------
 
 void
@@ -95,6 +95,7 @@ private:
     std::unique_ptr<Server> m_server;
     Setup setup_;
     JobQueue& m_jobQueue;
+    CollectorManager& collectorManager_;
     beast::insight::Counter rpc_requests_;
     beast::insight::Event rpc_size_;
     beast::insight::Event rpc_time_;
@@ -196,6 +197,12 @@ private:
 
     Handoff
     statusResponse(http_request_type const& request) const;
+
+    Handoff
+    metricsResponse(
+        Session& session,
+        http_request_type const& request,
+        std::shared_ptr<beast::insight::TextCollector> const& collector);
 };
 
 }  // namespace ripple
@@ -22,6 +22,7 @@
 #include <ripple/basics/BasicConfig.h>
 #include <ripple/core/ConfigSections.h>
 #include <ripple/nodestore/DatabaseShard.h>
+#include <ripple/nodestore/ShardArchive.h>
 #include <ripple/rpc/ShardArchiveHandler.h>
 #include <ripple/rpc/impl/Handler.h>
 
@@ -498,6 +499,20 @@ ShardArchiveHandler::process(path const& dstPath)
         shardIndex = archives_.begin()->first;
     }
 
+    // Shard archives are streamed into the shard store without extracting
+    if (NodeStore::isShardArchive(dstPath))
+    {
+        if (!app_.getShardStore()->importShardArchive(shardIndex, dstPath))
+        {
+            JLOG(j_.error()) << "Importing shard archive " << shardIndex;
+            return;
+        }
+
+        JLOG(j_.debug()) << "Shard " << shardIndex
+                         << " downloaded and imported";
+        return;
+    }
+
     auto const shardDir{dstPath.parent_path() / std::to_string(shardIndex)};
     try
     {
@@ -20,6 +20,9 @@
 #ifndef RIPPLE_RPC_TUNING_H_INCLUDED
 #define RIPPLE_RPC_TUNING_H_INCLUDED
 
+#include <algorithm>
+#include <thread>
+
 namespace ripple {
 namespace RPC {
 
@@ -71,6 +74,19 @@ inline int constexpr pageLength(bool isBinary)
     return isBinary ? binaryPageLength : jsonPageLength;
 }
 
+/** Maximum number of threads converting the state of a closed ledger,
+    counting the calling thread. The jobs helping every conversion share the
+    limit of the jtSTATE_JSON job type.
+*/
+static unsigned int constexpr maxStateThreads = 8;
+
+/** Number of threads converting the state of a closed ledger. */
+inline unsigned int
+stateThreads()
+{
+    return std::clamp(std::thread::hardware_concurrency(), 1u, maxStateThreads);
+}
+
 /** Maximum number of source currencies allowed in a path find request. */
 static int constexpr max_src_cur = 18;
 
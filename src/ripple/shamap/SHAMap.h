@@ -33,6 +33,7 @@
 #include <ripple/shamap/SHAMapMissingNode.h>
 #include <ripple/shamap/SHAMapTreeNode.h>
 #include <ripple/shamap/TreeNodeCache.h>
+#include <array>
 #include <cassert>
 #include <stack>
 #include <vector>
@@ -120,8 +121,8 @@ public:
     static inline constexpr unsigned int leafDepth = 64;
 
     using DeltaItem = std::pair<
-        std::shared_ptr<SHAMapItem const>,
-        std::shared_ptr<SHAMapItem const>>;
+        boost::intrusive_ptr<SHAMapItem const>,
+        boost::intrusive_ptr<SHAMapItem const>>;
     using Delta = std::map<uint256, DeltaItem>;
 
     SHAMap(SHAMap const&) = delete;
@@ -190,23 +191,27 @@ public:
     delItem(uint256 const& id);
 
     bool
-    addItem(SHAMapNodeType type, SHAMapItem&& i);
+    addItem(SHAMapNodeType type, boost::intrusive_ptr<SHAMapItem const> item);
 
     SHAMapHash
     getHash() const;
 
     // save a copy if you have a temporary anyway
     bool
-    updateGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const>);
+    updateGiveItem(
+        SHAMapNodeType type,
+        boost::intrusive_ptr<SHAMapItem const> item);
 
     bool
-    addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item);
+    addGiveItem(
+        SHAMapNodeType type,
+        boost::intrusive_ptr<SHAMapItem const> item);
 
     // Save a copy if you need to extend the life
     // of the SHAMapItem beyond this SHAMap
-    std::shared_ptr<SHAMapItem const> const&
+    boost::intrusive_ptr<SHAMapItem const> const&
     peekItem(uint256 const& id) const;
-    std::shared_ptr<SHAMapItem const> const&
+    boost::intrusive_ptr<SHAMapItem const> const&
     peekItem(uint256 const& id, SHAMapHash& hash) const;
 
     // traverse functions
@@ -238,7 +243,8 @@ public:
     */
     void
     visitLeaves(
-        std::function<void(std::shared_ptr<SHAMapItem const> const&)> const&)
+        std::function<
+            void(boost::intrusive_ptr<SHAMapItem const> const&)> const&)
         const;
 
     // comparison/sync functions
@@ -295,12 +301,26 @@ public:
         SHAMapHash const& hash,
         Slice const& rootNode,
         SHAMapSyncFilter* filter);
+
+    /** Add a root deserialized by SHAMapTreeNode::makeFromWire. */
+    SHAMapAddNode
+    addRootNode(
+        SHAMapHash const& hash,
+        std::shared_ptr<SHAMapTreeNode> node,
+        SHAMapSyncFilter* filter);
     SHAMapAddNode
     addKnownNode(
         SHAMapNodeID const& nodeID,
         Slice const& rawNode,
         SHAMapSyncFilter* filter);
 
+    /** Add a node deserialized by SHAMapTreeNode::makeFromWire. */
+    SHAMapAddNode
+    addKnownNode(
+        SHAMapNodeID const& nodeID,
+        std::shared_ptr<SHAMapTreeNode> newNode,
+        SHAMapSyncFilter* filter);
+
     // status functions
     void
     setImmutable();
@@ -343,8 +363,8 @@ private:
     using SharedPtrNodeStack =
         std::stack<std::pair<std::shared_ptr<SHAMapTreeNode>, SHAMapNodeID>>;
     using DeltaRef = std::pair<
-        std::shared_ptr<SHAMapItem const> const&,
-        std::shared_ptr<SHAMapItem const> const&>;
+        boost::intrusive_ptr<SHAMapItem const> const&,
+        boost::intrusive_ptr<SHAMapItem const> const&>;
 
     // tree node cache operations
     std::shared_ptr<SHAMapTreeNode>
@@ -437,8 +457,22 @@ private:
     std::shared_ptr<SHAMapTreeNode>
     descendNoStore(std::shared_ptr<SHAMapInnerNode> const&, int branch) const;
 
+    // Batched descent
+    // Get every child of the specified node, fetching all of the children
+    // that are not already in memory from the node store in one request.
+    // The children are hooked to the parent only if `store` is set.
+    // Throws if a child is missing.
+    using Children = std::array<std::shared_ptr<SHAMapTreeNode>, branchFactor>;
+    Children
+    descendAll(SHAMapInnerNode* parent, bool store) const;
+
+    // As descendAll, but never hooks the children to the parent and leaves
+    // missing children null instead of throwing.
+    Children
+    fetchChildren(SHAMapInnerNode* parent) const;
+
     /** If there is only one leaf below this node, get its contents */
-    std::shared_ptr<SHAMapItem const> const&
+    boost::intrusive_ptr<SHAMapItem const> const&
     onlyBelow(SHAMapTreeNode*) const;
 
     bool
@@ -453,7 +487,7 @@ private:
     bool
     walkBranch(
         SHAMapTreeNode* node,
-        std::shared_ptr<SHAMapItem const> const& otherMapItem,
+        boost::intrusive_ptr<SHAMapItem const> const& otherMapItem,
         bool isFirstMap,
         Delta& differences,
         int& maxCount) const;
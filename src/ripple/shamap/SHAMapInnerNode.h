@@ -187,8 +187,9 @@ public:
     static std::shared_ptr<SHAMapTreeNode>
     makeFullInner(Slice data, SHAMapHash const& hash, bool hashValid);
 
+    // If deferHash is set, the hash is left empty for the caller to compute
     static std::shared_ptr<SHAMapTreeNode>
-    makeCompressedInner(Slice data);
+    makeCompressedInner(Slice data, bool deferHash = false);
 };
 
 inline bool
@@ -20,28 +20,48 @@
 #ifndef RIPPLE_SHAMAP_SHAMAPITEM_H_INCLUDED
 #define RIPPLE_SHAMAP_SHAMAPITEM_H_INCLUDED
 
-#include <ripple/basics/Blob.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/Slice.h>
 #include <ripple/basics/base_uint.h>
-#include <ripple/beast/utility/Journal.h>
-#include <ripple/protocol/Serializer.h>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 
 namespace ripple {
 
 // an item stored in a SHAMap
+//
+// A map of the ledger state holds millions of items, so an item is one
+// allocation: the data is stored right after the object, the reference
+// count is part of the object, and items of common sizes are carved from
+// slabs. Items are immutable and are created with make_shamapitem.
 class SHAMapItem : public CountedObject<SHAMapItem>
 {
 private:
-    uint256 tag_;
-    Blob data_;
+    uint256 const tag_;
+    std::uint32_t const size_;
+    mutable std::atomic<std::uint32_t> refcount_{1};
+
+    // Where the item was allocated from
+    std::uint8_t const sizeClass_;
+
+    SHAMapItem(uint256 const& tag, Slice data, std::uint8_t sizeClass);
+
+    friend boost::intrusive_ptr<SHAMapItem const>
+    make_shamapitem(uint256 const& tag, Slice data);
+
+    friend void
+    intrusive_ptr_add_ref(SHAMapItem const* x);
+
+    friend void
+    intrusive_ptr_release(SHAMapItem const* x);
 
 public:
-    SHAMapItem(uint256 const& tag, Blob const& data);
-    SHAMapItem(uint256 const& tag, Serializer const& s);
-    SHAMapItem(uint256 const& tag, Serializer&& s);
+    SHAMapItem(SHAMapItem const&) = delete;
+    SHAMapItem&
+    operator=(SHAMapItem const&) = delete;
 
     Slice
     slice() const;
@@ -49,33 +69,76 @@ public:
     uint256 const&
     key() const;
 
-    Blob const&
-    peekData() const;
-
     std::size_t
     size() const;
     void const*
     data() const;
 };
 
+/** Create an item holding a copy of the data. */
+boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem(uint256 const& tag, Slice data);
+
+/** Create an item holding a copy of another item's key and data. */
+boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem(SHAMapItem const& other);
+
+inline void
+intrusive_ptr_add_ref(SHAMapItem const* x)
+{
+    x->refcount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+intrusive_ptr_release(SHAMapItem const* x);
+
+/** Memory held by SHAMapItems, for reporting. */
+struct SHAMapItemMemory
+{
+    /** Bytes reserved for slabs of items. */
+    std::size_t slabReserved = 0;
+
+    /** Bytes of slabs holding live items. */
+    std::size_t slabUsed = 0;
+
+    /** Items too large for a slab, or allocated when the slabs were full. */
+    std::size_t heapItems = 0;
+
+    /** Bytes of those items. */
+    std::size_t heapBytes = 0;
+};
+
+SHAMapItemMemory
+getSHAMapItemMemory();
+
+/** Set the bytes which may be reserved for slabs of items.
+
+    Items created once the slabs for their size are full come from the
+    heap.
+
+    @return The previous limit.
+*/
+std::size_t
+setSHAMapItemSlabLimit(std::size_t bytes);
+
 //------------------------------------------------------------------------------
 
 inline Slice
 SHAMapItem::slice() const
 {
-    return {data_.data(), data_.size()};
+    return {data(), size_};
 }
 
 inline std::size_t
 SHAMapItem::size() const
 {
-    return data_.size();
+    return size_;
 }
 
 inline void const*
 SHAMapItem::data() const
 {
-    return data_.data();
+    return reinterpret_cast<std::uint8_t const*>(this) + sizeof(*this);
 }
 
 inline uint256 const&
@@ -84,12 +147,6 @@ SHAMapItem::key() const
     return tag_;
 }
 
-inline Blob const&
-SHAMapItem::peekData() const
-{
-    return data_;
-}
-
 }  // namespace ripple
 
 #endif
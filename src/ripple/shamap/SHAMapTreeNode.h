@@ -23,6 +23,7 @@
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/TaggedCache.h>
 #include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/Serializer.h>
 #include <ripple/shamap/SHAMapItem.h>
 #include <ripple/shamap/SHAMapNodeID.h>
 
@@ -30,6 +31,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace ripple {
 
@@ -257,7 +259,27 @@ public:
     static std::shared_ptr<SHAMapTreeNode>
     makeFromWire(Slice rawNode);
 
+    /** Deserialize several nodes received over the wire.
+
+        The hashes of the nodes are computed together, which is faster than
+        computing them one at a time. An empty node yields nullptr.
+    */
+    static std::vector<std::shared_ptr<SHAMapTreeNode>>
+    makeFromWire(std::vector<Slice> const& rawNodes);
+
+    /** Recalculate the hashes of several nodes at once.
+
+        This is equivalent to calling updateHash on each node.
+    */
+    static void
+    updateHashes(std::vector<SHAMapTreeNode*> const& nodes);
+
 private:
+    // If deferHash is set, the hash of the node is left empty for the
+    // caller to compute.
+    static std::shared_ptr<SHAMapTreeNode>
+    makeFromWire(Slice rawNode, bool deferHash);
+
     static std::shared_ptr<SHAMapTreeNode>
     makeTransaction(Slice data, SHAMapHash const& hash, bool hashValid);
 
@@ -30,7 +30,7 @@ namespace ripple {
 [[nodiscard]] std::shared_ptr<SHAMapLeafNode>
 makeTypedLeaf(
     SHAMapNodeType type,
-    std::shared_ptr<SHAMapItem const> item,
+    boost::intrusive_ptr<SHAMapItem const> item,
     std::uint32_t owner)
 {
     if (type == SHAMapNodeType::tnTRANSACTION_NM)
@@ -347,6 +347,66 @@ SHAMap::descendNoStore(
     return ret;
 }
 
+SHAMap::Children
+SHAMap::fetchChildren(SHAMapInnerNode* parent) const
+{
+    Children children;
+    std::vector<int> branches;
+    std::vector<uint256> hashes;
+
+    for (int branch = 0; branch < branchFactor; ++branch)
+    {
+        if (parent->isEmptyBranch(branch))
+            continue;
+
+        children[branch] = parent->getChild(branch);
+        if (!children[branch] && backed_)
+        {
+            auto const& hash = parent->getChildHash(branch);
+            children[branch] = cacheLookup(hash);
+            if (!children[branch])
+            {
+                branches.push_back(branch);
+                hashes.push_back(hash.as_uint256());
+            }
+        }
+    }
+
+    if (!hashes.empty())
+    {
+        auto const objects = f_.db().fetchNodeObjects(hashes, ledgerSeq_);
+        for (std::size_t i = 0; i < branches.size(); ++i)
+        {
+            children[branches[i]] = finishFetch(
+                parent->getChildHash(branches[i]),
+                i < objects.size() ? objects[i] : nullptr);
+        }
+    }
+
+    return children;
+}
+
+SHAMap::Children
+SHAMap::descendAll(SHAMapInnerNode* parent, bool store) const
+{
+    auto children = fetchChildren(parent);
+
+    for (int branch = 0; branch < branchFactor; ++branch)
+    {
+        if (parent->isEmptyBranch(branch))
+            continue;
+
+        if (!children[branch])
+            Throw<SHAMapMissingNode>(type_, parent->getChildHash(branch));
+
+        if (store)
+            children[branch] =
+                parent->canonicalizeChild(branch, std::move(children[branch]));
+    }
+
+    return children;
+}
+
 std::pair<SHAMapTreeNode*, SHAMapNodeID>
 SHAMap::descend(
     SHAMapInnerNode* parent,
@@ -476,9 +536,9 @@ SHAMap::firstBelow(
     return nullptr;
 }
 
-static const std::shared_ptr<SHAMapItem const> no_item;
+static const boost::intrusive_ptr<SHAMapItem const> no_item;
 
-std::shared_ptr<SHAMapItem const> const&
+boost::intrusive_ptr<SHAMapItem const> const&
 SHAMap::onlyBelow(SHAMapTreeNode* node) const
 {
     // If there is only one item below this node, return it
@@ -557,7 +617,7 @@ SHAMap::peekNextItem(uint256 const& id, SharedPtrNodeStack& stack) const
     return nullptr;
 }
 
-std::shared_ptr<SHAMapItem const> const&
+boost::intrusive_ptr<SHAMapItem const> const&
 SHAMap::peekItem(uint256 const& id) const
 {
     SHAMapLeafNode* leaf = findKey(id);
@@ -568,7 +628,7 @@ SHAMap::peekItem(uint256 const& id) const
     return leaf->peekItem();
 }
 
-std::shared_ptr<SHAMapItem const> const&
+boost::intrusive_ptr<SHAMapItem const> const&
 SHAMap::peekItem(uint256 const& id, SHAMapHash& hash) const
 {
     SHAMapLeafNode* leaf = findKey(id);
@@ -705,7 +765,9 @@ SHAMap::delItem(uint256 const& id)
 }
 
 bool
-SHAMap::addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item)
+SHAMap::addGiveItem(
+    SHAMapNodeType type,
+    boost::intrusive_ptr<SHAMapItem const> item)
 {
     assert(state_ != SHAMapState::Immutable);
     assert(type != SHAMapNodeType::tnINNER);
@@ -743,7 +805,7 @@ SHAMap::addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item)
         // this is a leaf node that has to be made an inner node holding two
         // items
         auto leaf = std::static_pointer_cast<SHAMapLeafNode>(node);
-        std::shared_ptr<SHAMapItem const> otherItem = leaf->peekItem();
+        boost::intrusive_ptr<SHAMapItem const> otherItem = leaf->peekItem();
         assert(otherItem && (tag != otherItem->key()));
 
         node = std::make_shared<SHAMapInnerNode>(node->cowid());
@@ -774,9 +836,11 @@ SHAMap::addGiveItem(SHAMapNodeType type, std::shared_ptr<SHAMapItem const> item)
 }
 
 bool
-SHAMap::addItem(SHAMapNodeType type, SHAMapItem&& i)
+SHAMap::addItem(
+    SHAMapNodeType type,
+    boost::intrusive_ptr<SHAMapItem const> item)
 {
-    return addGiveItem(type, std::make_shared<SHAMapItem const>(std::move(i)));
+    return addGiveItem(type, std::move(item));
 }
 
 SHAMapHash
@@ -794,7 +858,7 @@ SHAMap::getHash() const
 bool
 SHAMap::updateGiveItem(
     SHAMapNodeType type,
-    std::shared_ptr<SHAMapItem const> item)
+    boost::intrusive_ptr<SHAMapItem const> item)
 {
     // can't change the tag but can change the hash
     uint256 tag = item->key();
@@ -965,6 +1029,30 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
 
     int pos = 0;
 
+    // The dirty leaves of the current inner node are hashed together
+    std::vector<std::pair<int, std::shared_ptr<SHAMapTreeNode>>> leaves;
+    std::vector<SHAMapTreeNode*> unhashed;
+    auto const flushLeaves = [&]() {
+        if (leaves.empty())
+            return;
+
+        unhashed.clear();
+        for (auto const& leaf : leaves)
+            unhashed.push_back(leaf.second.get());
+        SHAMapTreeNode::updateHashes(unhashed);
+
+        for (auto& [branch, leaf] : leaves)
+        {
+            leaf->unshare();
+
+            if (doWrite)
+                leaf = writeNode(t, std::move(leaf));
+
+            node->shareChild(branch, leaf);
+        }
+        leaves.clear();
+    };
+
     // We can't flush an inner node until we flush its children
     while (1)
     {
@@ -990,6 +1078,7 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
                     if (child->isInner())
                     {
                         // save our place and work on this node
+                        flushLeaves();
 
                         stack.emplace(std::move(node), branch);
                         // The semantics of this changes when we move to c++-20
@@ -1005,18 +1094,14 @@ SHAMap::walkSubTree(bool doWrite, NodeObjectType t)
                         ++flushed;
 
                         assert(node->cowid() == cowid_);
-                        child->updateHash();
-                        child->unshare();
-
-                        if (doWrite)
-                            child = writeNode(t, std::move(child));
-
-                        node->shareChild(branch, child);
+                        leaves.emplace_back(branch, std::move(child));
                     }
                 }
             }
         }
 
+        flushLeaves();
+
         // update the hash of this inner node
         node->updateHashDeep();
 
@@ -33,7 +33,7 @@ namespace ripple {
 bool
 SHAMap::walkBranch(
     SHAMapTreeNode* node,
-    std::shared_ptr<SHAMapItem const> const& otherMapItem,
+    boost::intrusive_ptr<SHAMapItem const> const& otherMapItem,
     bool isFirstMap,
     Delta& differences,
     int& maxCount) const
@@ -69,16 +69,18 @@ SHAMap::walkBranch(
                 if (isFirstMap)
                     differences.insert(std::make_pair(
                         item->key(),
-                        DeltaRef(item, std::shared_ptr<SHAMapItem const>())));
+                        DeltaRef(
+                            item, boost::intrusive_ptr<SHAMapItem const>())));
                 else
                     differences.insert(std::make_pair(
                         item->key(),
-                        DeltaRef(std::shared_ptr<SHAMapItem const>(), item)));
+                        DeltaRef(
+                            boost::intrusive_ptr<SHAMapItem const>(), item)));
 
                 if (--maxCount <= 0)
                     return false;
             }
-            else if (item->peekData() != otherMapItem->peekData())
+            else if (item->slice() != otherMapItem->slice())
             {
                 // non-matching items with same tag
                 if (isFirstMap)
@@ -107,11 +109,13 @@ SHAMap::walkBranch(
         if (isFirstMap)  // this is first map, so other item is from second
             differences.insert(std::make_pair(
                 otherMapItem->key(),
-                DeltaRef(std::shared_ptr<SHAMapItem const>(), otherMapItem)));
+                DeltaRef(
+                    boost::intrusive_ptr<SHAMapItem const>(), otherMapItem)));
         else
             differences.insert(std::make_pair(
                 otherMapItem->key(),
-                DeltaRef(otherMapItem, std::shared_ptr<SHAMapItem const>())));
+                DeltaRef(
+                    otherMapItem, boost::intrusive_ptr<SHAMapItem const>())));
 
         if (--maxCount <= 0)
             return false;
@@ -156,8 +160,7 @@ SHAMap::compare(SHAMap const& otherMap, Delta& differences, int maxCount) const
             auto other = static_cast<SHAMapLeafNode*>(otherNode);
             if (ours->peekItem()->key() == other->peekItem()->key())
             {
-                if (ours->peekItem()->peekData() !=
-                    other->peekItem()->peekData())
+                if (ours->peekItem()->slice() != other->peekItem()->slice())
                 {
                     differences.insert(std::make_pair(
                         ours->peekItem()->key(),
@@ -172,14 +175,14 @@ SHAMap::compare(SHAMap const& otherMap, Delta& differences, int maxCount) const
                     ours->peekItem()->key(),
                     DeltaRef(
                         ours->peekItem(),
-                        std::shared_ptr<SHAMapItem const>())));
+                        boost::intrusive_ptr<SHAMapItem const>())));
                 if (--maxCount <= 0)
                     return false;
 
                 differences.insert(std::make_pair(
                     other->peekItem()->key(),
                     DeltaRef(
-                        std::shared_ptr<SHAMapItem const>(),
+                        boost::intrusive_ptr<SHAMapItem const>(),
                         other->peekItem())));
                 if (--maxCount <= 0)
                     return false;
@@ -214,7 +217,7 @@ SHAMap::compare(SHAMap const& otherMap, Delta& differences, int maxCount) const
                         SHAMapTreeNode* iNode = descendThrow(ours, i);
                         if (!walkBranch(
                                 iNode,
-                                std::shared_ptr<SHAMapItem const>(),
+                                boost::intrusive_ptr<SHAMapItem const>(),
                                 true,
                                 differences,
                                 maxCount))
@@ -226,7 +229,7 @@ SHAMap::compare(SHAMap const& otherMap, Delta& differences, int maxCount) const
                         SHAMapTreeNode* iNode = otherMap.descendThrow(other, i);
                         if (!otherMap.walkBranch(
                                 iNode,
-                                std::shared_ptr<SHAMapItem const>(),
+                                boost::intrusive_ptr<SHAMapItem const>(),
                                 false,
                                 differences,
                                 maxCount))
@@ -262,12 +265,14 @@ SHAMap::walkMap(std::vector<SHAMapMissingNode>& missingNodes, int maxMissing)
         std::shared_ptr<SHAMapInnerNode> node = std::move(nodeStack.top());
         nodeStack.pop();
 
+        // Fetch the children that are not in memory in one request
+        auto const children = fetchChildren(node.get());
+
         for (int i = 0; i < 16; ++i)
         {
             if (!node->isEmptyBranch(i))
             {
-                std::shared_ptr<SHAMapTreeNode> nextNode =
-                    descendNoStore(node, i);
+                auto const& nextNode = children[i];
 
                 if (nextNode)
                 {
@@ -158,7 +158,7 @@ SHAMapInnerNode::makeFullInner(
 }
 
 std::shared_ptr<SHAMapTreeNode>
-SHAMapInnerNode::makeCompressedInner(Slice data)
+SHAMapInnerNode::makeCompressedInner(Slice data, bool deferHash)
 {
     Serializer s(data.data(), data.size());
 
@@ -185,7 +185,8 @@ SHAMapInnerNode::makeCompressedInner(Slice data)
 
     ret->resizeChildArrays(ret->getBranchCount());
 
-    ret->updateHash();
+    if (!deferHash)
+        ret->updateHash();
 
     return ret;
 }
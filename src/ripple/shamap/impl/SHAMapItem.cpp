@@ -17,26 +17,194 @@
 */
 //==============================================================================
 
-#include <ripple/protocol/Serializer.h>
+#include <ripple/basics/ByteUtilities.h>
+#include <ripple/basics/SlabAllocator.h>
 #include <ripple/shamap/SHAMapItem.h>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <utility>
+
 namespace ripple {
 
-class SHAMap;
+namespace {
+
+// The sizes of the slab chunks, each holding the item and its data. They
+// are chosen around the usual serialized sizes of account roots, offers,
+// trust lines and small directories, and of transactions with metadata.
+// Larger items come from the heap. Each class gets a share, in 1024ths, of
+// the bytes set aside for slabs.
+struct SizeClass
+{
+    std::size_t chunkSize;
+    std::size_t share;
+};
+
+constexpr std::array<SizeClass, 9> sizeClasses{{
+    {96, 32},
+    {144, 128},
+    {176, 192},
+    {224, 192},
+    {256, 192},
+    {320, 96},
+    {448, 64},
+    {640, 64},
+    {1024, 64},
+}};
 
-SHAMapItem::SHAMapItem(uint256 const& tag, Blob const& data)
-    : tag_(tag), data_(data)
+constexpr std::size_t slabSize = megabytes(1);
+
+// The bytes for slabs until the application sets them from [node_size]
+constexpr std::size_t defaultSlabLimit = megabytes(64);
+
+// The size class of items allocated from the heap
+constexpr std::uint8_t heapClass = 0xff;
+
+class Slabs
 {
+public:
+    Slabs()
+    {
+        for (std::size_t i = 0; i < sizeClasses.size(); ++i)
+        {
+            allocators_[i] = std::make_unique<SlabAllocator>(
+                sizeClasses[i].chunkSize,
+                slabSize,
+                maxSize(i, defaultSlabLimit));
+        }
+    }
+
+    std::size_t
+    setLimit(std::size_t bytes)
+    {
+        std::lock_guard lock(mutex_);
+        for (std::size_t i = 0; i < sizeClasses.size(); ++i)
+            allocators_[i]->setMaxSize(maxSize(i, bytes));
+        return std::exchange(limit_, bytes);
+    }
+
+    // Returns the memory and the size class it came from
+    std::pair<void*, std::uint8_t>
+    allocate(std::size_t bytes)
+    {
+        for (std::size_t i = 0; i < sizeClasses.size(); ++i)
+        {
+            if (bytes > allocators_[i]->chunkSize())
+                continue;
+            if (void* p = allocators_[i]->allocate())
+                return {p, static_cast<std::uint8_t>(i)};
+            break;
+        }
+
+        auto p = ::operator new(bytes);
+        ++heapItems_;
+        heapBytes_ += bytes;
+        return {p, heapClass};
+    }
+
+    void
+    deallocate(void* p, std::size_t bytes, std::uint8_t sizeClass)
+    {
+        if (sizeClass != heapClass)
+            return allocators_[sizeClass]->deallocate(p);
+
+        --heapItems_;
+        heapBytes_ -= bytes;
+        ::operator delete(p);
+    }
+
+    SHAMapItemMemory
+    memory() const
+    {
+        SHAMapItemMemory m;
+        for (auto const& a : allocators_)
+        {
+            auto const s = a->stats();
+            m.slabReserved += s.reserved;
+            m.slabUsed += s.used;
+        }
+        m.heapItems = heapItems_;
+        m.heapBytes = heapBytes_;
+        return m;
+    }
+
+private:
+    // Every class may reserve at least one slab
+    static std::size_t
+    maxSize(std::size_t sizeClass, std::size_t limit)
+    {
+        return std::max(limit / 1024 * sizeClasses[sizeClass].share, slabSize);
+    }
+
+    std::array<std::unique_ptr<SlabAllocator>, sizeClasses.size()> allocators_;
+    std::mutex mutex_;
+    std::size_t limit_ = defaultSlabLimit;
+    std::atomic<std::size_t> heapItems_{0};
+    std::atomic<std::size_t> heapBytes_{0};
+};
+
+// Never destroyed, since items may outlive other static objects
+Slabs&
+slabs()
+{
+    static Slabs* const s = new Slabs;
+    return *s;
+}
+
+}  // namespace
+
+SHAMapItem::SHAMapItem(uint256 const& tag, Slice data, std::uint8_t sizeClass)
+    : tag_(tag)
+    , size_(static_cast<std::uint32_t>(data.size()))
+    , sizeClass_(sizeClass)
+{
+    if (!data.empty())
+        std::memcpy(
+            reinterpret_cast<std::uint8_t*>(this) + sizeof(*this),
+            data.data(),
+            data.size());
+}
+
+boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem(uint256 const& tag, Slice data)
+{
+    auto const bytes = sizeof(SHAMapItem) + data.size();
+    auto const [p, sizeClass] = slabs().allocate(bytes);
+    return {new (p) SHAMapItem(tag, data, sizeClass), false};
+}
+
+boost::intrusive_ptr<SHAMapItem const>
+make_shamapitem(SHAMapItem const& other)
+{
+    return make_shamapitem(other.key(), other.slice());
+}
+
+void
+intrusive_ptr_release(SHAMapItem const* x)
+{
+    if (x->refcount_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    auto const bytes = sizeof(SHAMapItem) + x->size_;
+    auto const sizeClass = x->sizeClass_;
+    auto p = const_cast<SHAMapItem*>(x);
+    p->~SHAMapItem();
+    slabs().deallocate(p, bytes, sizeClass);
 }
 
-SHAMapItem::SHAMapItem(uint256 const& tag, const Serializer& data)
-    : tag_(tag), data_(data.peekData())
+SHAMapItemMemory
+getSHAMapItemMemory()
 {
+    return slabs().memory();
 }
 
-SHAMapItem::SHAMapItem(uint256 const& tag, Serializer&& data)
-    : tag_(tag), data_(std::move(data.modData()))
+std::size_t
+setSHAMapItemSlabLimit(std::size_t bytes)
 {
+    return slabs().setLimit(bytes);
 }
 
 }  // namespace ripple
@@ -20,12 +20,14 @@
 #include <ripple/basics/random.h>
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/shamap/SHAMapSyncFilter.h>
+#include <tuple>
 
 namespace ripple {
 
 void
 SHAMap::visitLeaves(
-    std::function<void(std::shared_ptr<SHAMapItem const> const& item)> const&
+    std::function<
+        void(boost::intrusive_ptr<SHAMapItem const> const& item)> const&
         leafFunction) const
 {
     visitNodes([&leafFunction](SHAMapTreeNode& node) {
@@ -46,21 +48,24 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
     if (!root_->isInner())
         return;
 
-    using StackEntry = std::pair<int, std::shared_ptr<SHAMapInnerNode>>;
+    // Each entry holds the position to resume at, the inner node and its
+    // children, which are fetched together when the node is first reached
+    using StackEntry =
+        std::tuple<int, std::shared_ptr<SHAMapInnerNode>, Children>;
     std::stack<StackEntry, std::vector<StackEntry>> stack;
 
     auto node = std::static_pointer_cast<SHAMapInnerNode>(root_);
+    auto children = descendAll(node.get(), false);
     int pos = 0;
 
     while (1)
     {
         while (pos < 16)
         {
-            uint256 childHash;
             if (!node->isEmptyBranch(pos))
             {
                 std::shared_ptr<SHAMapTreeNode> child =
-                    descendNoStore(node, pos);
+                    std::move(children[pos]);
                 if (!function(*child))
                     return;
 
@@ -75,11 +80,13 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
                     if (pos != 15)
                     {
                         // save next position to resume at
-                        stack.push(std::make_pair(pos + 1, std::move(node)));
+                        stack.emplace(
+                            pos + 1, std::move(node), std::move(children));
                     }
 
                     // descend to the child's first position
                     node = std::static_pointer_cast<SHAMapInnerNode>(child);
+                    children = descendAll(node.get(), false);
                     pos = 0;
                 }
             }
@@ -92,7 +99,7 @@ SHAMap::visitNodes(std::function<bool(SHAMapTreeNode&)> const& function) const
         if (stack.empty())
             break;
 
-        std::tie(pos, node) = stack.top();
+        std::tie(pos, node, children) = std::move(stack.top());
         stack.pop();
     }
 }
@@ -137,13 +144,14 @@ SHAMap::visitDifferences(
             return;
 
         // 2) push non-matching child inner nodes
+        auto const children = descendAll(node, true);
         for (int i = 0; i < 16; ++i)
         {
             if (!node->isEmptyBranch(i))
             {
                 auto const& childHash = node->getChildHash(i);
                 SHAMapNodeID childID = nodeID.getChildNodeID(i);
-                auto next = descendThrow(node, i);
+                auto next = children[i].get();
 
                 if (next->isInner())
                 {
@@ -540,8 +548,24 @@ SHAMap::addRootNode(
         return SHAMapAddNode::duplicate();
     }
 
+    return addRootNode(hash, SHAMapTreeNode::makeFromWire(rootNode), filter);
+}
+
+SHAMapAddNode
+SHAMap::addRootNode(
+    SHAMapHash const& hash,
+    std::shared_ptr<SHAMapTreeNode> node,
+    SHAMapSyncFilter* filter)
+{
+    // we already have a root_ node
+    if (root_->getHash().isNonZero())
+    {
+        JLOG(journal_.trace()) << "got root node, already have one";
+        assert(root_->getHash() == hash);
+        return SHAMapAddNode::duplicate();
+    }
+
     assert(cowid_ >= 1);
-    auto node = SHAMapTreeNode::makeFromWire(rootNode);
     if (!node || node->getHash() != hash)
         return SHAMapAddNode::invalid();
 
@@ -573,6 +597,21 @@ SHAMap::addKnownNode(
     const SHAMapNodeID& node,
     Slice const& rawNode,
     SHAMapSyncFilter* filter)
+{
+    if (!isSynching())
+    {
+        JLOG(journal_.trace()) << "AddKnownNode while not synching";
+        return SHAMapAddNode::duplicate();
+    }
+
+    return addKnownNode(node, SHAMapTreeNode::makeFromWire(rawNode), filter);
+}
+
+SHAMapAddNode
+SHAMap::addKnownNode(
+    const SHAMapNodeID& node,
+    std::shared_ptr<SHAMapTreeNode> newNode,
+    SHAMapSyncFilter* filter)
 {
     assert(!node.isRoot());
 
@@ -583,7 +622,6 @@ SHAMap::addKnownNode(
     }
 
     auto const generation = f_.getFullBelowCache(ledgerSeq_)->getGeneration();
-    auto newNode = SHAMapTreeNode::makeFromWire(rawNode);
     SHAMapNodeID iNodeID;
     auto iNode = root_.get();
 
@@ -697,7 +735,7 @@ SHAMap::deepCompare(SHAMap& other) const
                 static_cast<SHAMapLeafNode*>(otherNode)->peekItem();
             if (nodePeek->key() != otherNodePeek->key())
                 return false;
-            if (nodePeek->peekData() != otherNodePeek->peekData())
+            if (nodePeek->slice() != otherNodePeek->slice())
                 return false;
         }
         else if (node->isInner())
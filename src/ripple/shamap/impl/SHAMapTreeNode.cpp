@@ -42,11 +42,8 @@ SHAMapTreeNode::makeTransaction(
     SHAMapHash const& hash,
     bool hashValid)
 {
-    // FIXME: using a Serializer results in a copy; avoid it?
-    Serializer s(data.begin(), data.size());
-
-    auto item = std::make_shared<SHAMapItem const>(
-        sha512Half(HashPrefix::transactionID, data), s);
+    auto item =
+        make_shamapitem(sha512Half(HashPrefix::transactionID, data), data);
 
     if (hashValid)
         return std::make_shared<SHAMapTxLeafNode>(std::move(item), 0, hash);
@@ -60,21 +57,15 @@ SHAMapTreeNode::makeTransactionWithMeta(
     SHAMapHash const& hash,
     bool hashValid)
 {
-    Serializer s(data.data(), data.size());
-
-    uint256 tag;
-
-    if (s.size() < tag.bytes)
+    if (data.size() < uint256::bytes)
         Throw<std::runtime_error>("Short TXN+MD node");
 
-    // FIXME: improve this interface so that the above check isn't needed
-    if (!s.getBitString(tag, s.size() - tag.bytes))
-        Throw<std::out_of_range>(
-            "Short TXN+MD node (" + std::to_string(s.size()) + ")");
+    // The tag follows the data; the item copies the data straight from the
+    // wire
+    data.remove_suffix(uint256::bytes);
+    auto const tag = uint256::fromVoid(data.data() + data.size());
 
-    s.chop(tag.bytes);
-
-    auto item = std::make_shared<SHAMapItem const>(tag, s.peekData());
+    auto item = make_shamapitem(tag, data);
 
     if (hashValid)
         return std::make_shared<SHAMapTxPlusMetaLeafNode>(
@@ -89,24 +80,16 @@ SHAMapTreeNode::makeAccountState(
     SHAMapHash const& hash,
     bool hashValid)
 {
-    Serializer s(data.data(), data.size());
-
-    uint256 tag;
-
-    if (s.size() < tag.bytes)
+    if (data.size() < uint256::bytes)
         Throw<std::runtime_error>("short AS node");
 
-    // FIXME: improve this interface so that the above check isn't needed
-    if (!s.getBitString(tag, s.size() - tag.bytes))
-        Throw<std::out_of_range>(
-            "Short AS node (" + std::to_string(s.size()) + ")");
-
-    s.chop(tag.bytes);
+    data.remove_suffix(uint256::bytes);
+    auto const tag = uint256::fromVoid(data.data() + data.size());
 
     if (tag.isZero())
         Throw<std::runtime_error>("Invalid AS node");
 
-    auto item = std::make_shared<SHAMapItem const>(tag, s.peekData());
+    auto item = make_shamapitem(tag, data);
 
     if (hashValid)
         return std::make_shared<SHAMapAccountStateLeafNode>(
@@ -117,6 +100,65 @@ SHAMapTreeNode::makeAccountState(
 
 std::shared_ptr<SHAMapTreeNode>
 SHAMapTreeNode::makeFromWire(Slice rawNode)
+{
+    return makeFromWire(rawNode, false);
+}
+
+std::vector<std::shared_ptr<SHAMapTreeNode>>
+SHAMapTreeNode::makeFromWire(std::vector<Slice> const& rawNodes)
+{
+    std::vector<std::shared_ptr<SHAMapTreeNode>> nodes;
+    nodes.reserve(rawNodes.size());
+
+    std::vector<SHAMapTreeNode*> unhashed;
+    unhashed.reserve(rawNodes.size());
+
+    for (auto const& rawNode : rawNodes)
+    {
+        nodes.push_back(makeFromWire(rawNode, true));
+        if (nodes.back())
+            unhashed.push_back(nodes.back().get());
+    }
+
+    updateHashes(unhashed);
+    return nodes;
+}
+
+void
+SHAMapTreeNode::updateHashes(std::vector<SHAMapTreeNode*> const& nodes)
+{
+    // Serialize every node first: the buffer may move as it grows
+    Serializer s;
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    ranges.reserve(nodes.size());
+    for (auto const node : nodes)
+    {
+        auto const start = s.size();
+        if (!node->isInner() ||
+            !static_cast<SHAMapInnerNode*>(node)->isEmpty())
+            node->serializeWithPrefix(s);
+        ranges.emplace_back(start, s.size() - start);
+    }
+
+    auto const data = s.slice();
+    std::vector<Slice> messages;
+    messages.reserve(nodes.size());
+    for (auto const& [start, size] : ranges)
+        messages.emplace_back(data.data() + start, size);
+
+    std::vector<uint256> digests(nodes.size());
+    sha512HalfBatch(messages.data(), digests.data(), messages.size());
+
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        // The hash of an empty inner node is zero
+        nodes[i]->hash_ =
+            SHAMapHash{messages[i].empty() ? uint256{} : digests[i]};
+    }
+}
+
+std::shared_ptr<SHAMapTreeNode>
+SHAMapTreeNode::makeFromWire(Slice rawNode, bool deferHash)
 {
     if (rawNode.empty())
         return {};
@@ -125,7 +167,7 @@ SHAMapTreeNode::makeFromWire(Slice rawNode)
 
     rawNode.remove_suffix(1);
 
-    bool const hashValid = false;
+    bool const hashValid = deferHash;
     SHAMapHash const hash;
 
     if (type == wireTypeTransaction)
@@ -138,7 +180,7 @@ SHAMapTreeNode::makeFromWire(Slice rawNode)
         return SHAMapInnerNode::makeFullInner(rawNode, hash, hashValid);
 
     if (type == wireTypeCompressedInner)
-        return SHAMapInnerNode::makeCompressedInner(rawNode);
+        return SHAMapInnerNode::makeCompressedInner(rawNode, deferHash);
 
     if (type == wireTypeTransactionWithMeta)
         return makeTransactionWithMeta(rawNode, hash, hashValid);
@@ -0,0 +1,335 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/InboundLedger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/basics/chrono.h>
+#include <ripple/overlay/PeerSet.h>
+#include <ripple/shamap/SHAMapNodeID.h>
+#include <test/jtx.h>
+
+#include <deque>
+#include <mutex>
+
+namespace ripple {
+namespace test {
+
+/**
+ * A peer that has every ledger and ignores fees.
+ */
+class LedgerTestPeer : public Peer
+{
+public:
+    void
+    send(std::shared_ptr<Message> const& m) override
+    {
+    }
+    beast::IP::Endpoint
+    getRemoteAddress() const override
+    {
+        return {};
+    }
+    void
+    charge(Resource::Charge const& fee) override
+    {
+    }
+    id_t
+    id() const override
+    {
+        return 1234;
+    }
+    bool
+    cluster() const override
+    {
+        return false;
+    }
+    bool
+    isHighLatency() const override
+    {
+        return false;
+    }
+    int
+    getScore(bool) const override
+    {
+        return 0;
+    }
+    PublicKey const&
+    getNodePublic() const override
+    {
+        static PublicKey key{};
+        return key;
+    }
+    Json::Value
+    json() override
+    {
+        return {};
+    }
+    bool
+    supportsFeature(ProtocolFeature f) const override
+    {
+        return false;
+    }
+    boost::optional<std::size_t>
+    publisherListSequence(PublicKey const&) const override
+    {
+        return {};
+    }
+    void
+    setPublisherListSequence(PublicKey const&, std::size_t const) override
+    {
+    }
+    uint256 const&
+    getClosedLedgerHash() const override
+    {
+        static uint256 hash{};
+        return hash;
+    }
+    bool
+    hasLedger(uint256 const& hash, std::uint32_t seq) const override
+    {
+        return true;
+    }
+    void
+    ledgerRange(std::uint32_t& minSeq, std::uint32_t& maxSeq) const override
+    {
+    }
+    bool
+    hasShard(std::uint32_t shardIndex) const override
+    {
+        return false;
+    }
+    bool
+    hasTxSet(uint256 const& hash) const override
+    {
+        return false;
+    }
+    void
+    cycleStatus() override
+    {
+    }
+    bool
+    hasRange(std::uint32_t uMin, std::uint32_t uMax) override
+    {
+        return false;
+    }
+    bool
+    compressionEnabled() const override
+    {
+        return false;
+    }
+};
+
+/**
+ * Requests sent by an acquire, with whether they went to one peer.
+ */
+class LedgerRequests
+{
+public:
+    void
+    push(protocol::TMGetLedger const& request, bool toPeer)
+    {
+        std::lock_guard lock(mutex_);
+        requests_.emplace_back(request, toPeer);
+    }
+
+    boost::optional<std::pair<protocol::TMGetLedger, bool>>
+    pop()
+    {
+        std::lock_guard lock(mutex_);
+        if (requests_.empty())
+            return boost::none;
+        auto request = std::move(requests_.front());
+        requests_.pop_front();
+        return request;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<std::pair<protocol::TMGetLedger, bool>> requests_;
+};
+
+/**
+ * A peerSet that queues every request so the test can answer it.
+ */
+struct LedgerTestPeerSet : public PeerSet
+{
+    LedgerTestPeerSet(std::shared_ptr<Peer> const& p, LedgerRequests& q)
+        : peer(p), requests(q)
+    {
+    }
+
+    void
+    addPeers(
+        std::size_t limit,
+        std::function<bool(std::shared_ptr<Peer> const&)> hasItem,
+        std::function<void(std::shared_ptr<Peer> const&)> onPeerAdded) override
+    {
+        if (hasItem(peer))
+            onPeerAdded(peer);
+    }
+
+    void
+    sendRequest(
+        ::google::protobuf::Message const& msg,
+        protocol::MessageType type,
+        std::shared_ptr<Peer> const& to) override
+    {
+        if (type == protocol::mtGET_LEDGER)
+            requests.push(
+                dynamic_cast<protocol::TMGetLedger const&>(msg), !!to);
+    }
+
+    const std::set<Peer::id_t>&
+    getPeerIds() const override
+    {
+        static std::set<Peer::id_t> emptyPeers;
+        return emptyPeers;
+    }
+
+    std::shared_ptr<Peer> peer;
+    LedgerRequests& requests;
+};
+
+class InboundLedger_test : public beast::unit_test::suite
+{
+    // Answer a request the way a peer holding the ledger would
+    static std::shared_ptr<protocol::TMLedgerData>
+    makeReply(Ledger const& ledger, protocol::TMGetLedger const& request)
+    {
+        auto const& info = ledger.info();
+        auto reply = std::make_shared<protocol::TMLedgerData>();
+        reply->set_ledgerhash(info.hash.begin(), info.hash.size());
+        reply->set_ledgerseq(info.seq);
+        reply->set_type(request.itype());
+
+        if (request.itype() == protocol::liBASE)
+        {
+            Serializer header(128);
+            addRaw(info, header);
+            reply->add_nodes()->set_nodedata(
+                header.getDataPtr(), header.getLength());
+
+            Serializer root(768);
+            ledger.stateMap().serializeRoot(root);
+            reply->add_nodes()->set_nodedata(
+                root.getDataPtr(), root.getLength());
+            return reply;
+        }
+
+        for (auto const& raw : request.nodeids())
+        {
+            auto const id = deserializeSHAMapNodeID(raw);
+            std::vector<SHAMapNodeID> nodeIDs;
+            std::vector<Blob> rawNodes;
+            if (!id ||
+                !ledger.stateMap().getNodeFat(
+                    *id, nodeIDs, rawNodes, false, request.querydepth()))
+                continue;
+            for (std::size_t i = 0; i < nodeIDs.size(); ++i)
+            {
+                auto node = reply->add_nodes();
+                node->set_nodeid(nodeIDs[i].getRawString());
+                node->set_nodedata(rawNodes[i].data(), rawNodes[i].size());
+            }
+        }
+        return reply;
+    }
+
+    void
+    testStripeReplies()
+    {
+        testcase("Only stripe replies measure throughput");
+
+        using namespace jtx;
+        using namespace std::chrono_literals;
+
+        // A ledger with a state map deep enough to need several requests
+        Env server(*this);
+        for (int i = 0; i < 64; ++i)
+            server.fund(XRP(1000), Account("alice" + std::to_string(i)));
+        server.close();
+        server.close();
+        auto const ledger = server.app().getLedgerMaster().getClosedLedger();
+        BEAST_EXPECT(ledger->info().txHash.isZero());
+
+        Env env(*this);
+        TestStopwatch clock;
+        LedgerRequests requests;
+        auto const peer = std::make_shared<LedgerTestPeer>();
+        auto const il = std::make_shared<InboundLedger>(
+            env.app(),
+            ledger->info().hash,
+            ledger->info().seq,
+            InboundLedger::Reason::GENERIC,
+            clock,
+            std::make_unique<LedgerTestPeerSet>(peer, requests));
+
+        auto answer = [&](protocol::TMGetLedger const& request) {
+            il->gotData(peer, makeReply(*ledger, request));
+            il->runData();
+        };
+
+        // The header comes first
+        il->trigger(peer, InboundLedger::TriggerReason::added);
+        auto const header = requests.pop();
+        if (!BEAST_EXPECT(header && header->second))
+            return;
+        BEAST_EXPECT(header->first.itype() == protocol::liBASE);
+        answer(header->first);
+
+        // The reply to the header sends the peer a stripe
+        auto const stripe = requests.pop();
+        if (!BEAST_EXPECT(stripe && stripe->second))
+            return;
+        BEAST_EXPECT(stripe->first.itype() == protocol::liAS_NODE);
+        BEAST_EXPECT(stripe->first.nodeids_size() > 0);
+        BEAST_EXPECT(!requests.pop());
+
+        // A reply to another request, here for the root as a timeout
+        // would ask, does not answer the stripe: the peer stays busy with
+        // it and no throughput is measured
+        clock.advance(100ms);
+        protocol::TMGetLedger other;
+        other.set_ledgerhash(
+            ledger->info().hash.begin(), ledger->info().hash.size());
+        other.set_itype(protocol::liAS_NODE);
+        other.set_querydepth(0);
+        *other.add_nodeids() = SHAMapNodeID().getRawString();
+        answer(other);
+        BEAST_EXPECT(il->mStripes.throughput(peer->id()) == 0);
+        BEAST_EXPECT(!requests.pop());
+
+        // The reply to the stripe is measured
+        answer(stripe->first);
+        BEAST_EXPECT(il->mStripes.throughput(peer->id()) > 0);
+        BEAST_EXPECT(il->mStripes.timeouts() == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testStripeReplies();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(InboundLedger, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
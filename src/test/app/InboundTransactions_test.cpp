@@ -0,0 +1,355 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/InboundTransactions.h>
+#include <ripple/app/ledger/TransactionMaster.h>
+#include <ripple/app/misc/Transaction.h>
+#include <ripple/overlay/PeerSet.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <ripple/shamap/SHAMapNodeID.h>
+#include <test/jtx.h>
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+/**
+ * A peer that has every transaction set and ignores fees.
+ */
+class TxSetTestPeer : public Peer
+{
+public:
+    void
+    send(std::shared_ptr<Message> const& m) override
+    {
+    }
+    beast::IP::Endpoint
+    getRemoteAddress() const override
+    {
+        return {};
+    }
+    void
+    charge(Resource::Charge const& fee) override
+    {
+    }
+    id_t
+    id() const override
+    {
+        return 4321;
+    }
+    bool
+    cluster() const override
+    {
+        return false;
+    }
+    bool
+    isHighLatency() const override
+    {
+        return false;
+    }
+    int
+    getScore(bool) const override
+    {
+        return 0;
+    }
+    PublicKey const&
+    getNodePublic() const override
+    {
+        static PublicKey key{};
+        return key;
+    }
+    Json::Value
+    json() override
+    {
+        return {};
+    }
+    bool
+    supportsFeature(ProtocolFeature f) const override
+    {
+        return false;
+    }
+    boost::optional<std::size_t>
+    publisherListSequence(PublicKey const&) const override
+    {
+        return {};
+    }
+    void
+    setPublisherListSequence(PublicKey const&, std::size_t const) override
+    {
+    }
+    uint256 const&
+    getClosedLedgerHash() const override
+    {
+        static uint256 hash{};
+        return hash;
+    }
+    bool
+    hasLedger(uint256 const& hash, std::uint32_t seq) const override
+    {
+        return false;
+    }
+    void
+    ledgerRange(std::uint32_t& minSeq, std::uint32_t& maxSeq) const override
+    {
+    }
+    bool
+    hasShard(std::uint32_t shardIndex) const override
+    {
+        return false;
+    }
+    bool
+    hasTxSet(uint256 const& hash) const override
+    {
+        return true;
+    }
+    void
+    cycleStatus() override
+    {
+    }
+    bool
+    hasRange(std::uint32_t uMin, std::uint32_t uMax) override
+    {
+        return false;
+    }
+    bool
+    compressionEnabled() const override
+    {
+        return false;
+    }
+};
+
+/**
+ * Requests sent by acquires. Timers may send from other threads.
+ */
+class TxSetRequests
+{
+public:
+    void
+    push(protocol::TMGetLedger const& request)
+    {
+        std::lock_guard lock(mutex_);
+        requests_.push_back(request);
+    }
+
+    boost::optional<protocol::TMGetLedger>
+    pop()
+    {
+        std::lock_guard lock(mutex_);
+        if (requests_.empty())
+            return boost::none;
+        auto request = std::move(requests_.front());
+        requests_.pop_front();
+        return request;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<protocol::TMGetLedger> requests_;
+};
+
+/**
+ * A peerSet that queues every request so the test can answer it.
+ */
+struct TxSetTestPeerSet : public PeerSet
+{
+    TxSetTestPeerSet(
+        std::shared_ptr<Peer> const& p,
+        TxSetRequests& q)
+        : peer(p), requests(q)
+    {
+    }
+
+    void
+    addPeers(
+        std::size_t limit,
+        std::function<bool(std::shared_ptr<Peer> const&)> hasItem,
+        std::function<void(std::shared_ptr<Peer> const&)> onPeerAdded) override
+    {
+        if (hasItem(peer))
+            onPeerAdded(peer);
+    }
+
+    void
+    sendRequest(
+        ::google::protobuf::Message const& msg,
+        protocol::MessageType type,
+        std::shared_ptr<Peer> const& peer) override
+    {
+        if (type == protocol::mtGET_LEDGER)
+            requests.push(dynamic_cast<protocol::TMGetLedger const&>(msg));
+    }
+
+    const std::set<Peer::id_t>&
+    getPeerIds() const override
+    {
+        static std::set<Peer::id_t> emptyPeers;
+        return emptyPeers;
+    }
+
+    std::shared_ptr<Peer> peer;
+    TxSetRequests& requests;
+};
+
+class TxSetTestPeerSetBuilder : public PeerSetBuilder
+{
+public:
+    TxSetTestPeerSetBuilder(
+        std::shared_ptr<Peer> const& p,
+        TxSetRequests& q)
+        : peer_(p), requests_(q)
+    {
+    }
+
+    std::unique_ptr<PeerSet>
+    build() override
+    {
+        return std::make_unique<TxSetTestPeerSet>(peer_, requests_);
+    }
+
+private:
+    std::shared_ptr<Peer> peer_;
+    TxSetRequests& requests_;
+};
+
+class InboundTransactions_test : public beast::unit_test::suite
+{
+    static void
+    addTx(SHAMap& set, STTx const& stx)
+    {
+        Serializer s;
+        stx.add(s);
+        set.addItem(
+            SHAMapNodeType::tnTRANSACTION_NM,
+            make_shamapitem(stx.getTransactionID(), s.slice()));
+    }
+
+    void
+    testAcquireFetchesOnlyDifferingBranches()
+    {
+        testcase("Acquire fetches only differing branches");
+
+        using namespace jtx;
+        using namespace std::chrono_literals;
+
+        Env env(*this);
+        auto& app = env.app();
+        Account const alice("alice");
+        env.fund(XRP(10000), alice);
+        env.close();
+
+        // Our set: transactions we hold in the transaction master.
+        auto ours = std::make_shared<SHAMap>(
+            SHAMapType::TRANSACTION, app.getNodeFamily());
+        ours->setUnbacked();
+        auto const baseSeq = env.seq(alice);
+        for (std::uint32_t i = 0; i < 64; ++i)
+        {
+            auto const stx = env.jt(noop(alice), seq(baseSeq + i)).stx;
+            std::string reason;
+            auto txn = std::make_shared<Transaction>(stx, reason, app);
+            app.getMasterTransaction().canonicalize(&txn);
+            addTx(*ours, *stx);
+        }
+        ours->setImmutable();
+
+        // Their set: ours plus one transaction we have never seen.
+        auto theirs = ours->snapShot(true);
+        auto const extra = env.jt(noop(alice), seq(baseSeq + 64)).stx;
+        addTx(*theirs, *extra);
+        theirs->setImmutable();
+        auto const theirHash = theirs->getHash().as_uint256();
+
+        TxSetRequests requests;
+        auto const peer = std::make_shared<TxSetTestPeer>();
+        RootStoppable parent("TestRootStoppable");
+        auto inbound = make_InboundTransactions(
+            app,
+            parent,
+            beast::insight::NullCollector::New(),
+            [](std::shared_ptr<SHAMap> const&, bool) {},
+            std::make_unique<TxSetTestPeerSetBuilder>(peer, requests));
+
+        inbound->giveSet(ours->getHash().as_uint256(), ours, false);
+        BEAST_EXPECT(!inbound->getSet(theirHash, true));
+
+        // Answer every request with exactly the nodes asked for, and
+        // remember which nodes were asked for.
+        std::vector<SHAMapNodeID> requested;
+        while (auto const request = requests.pop())
+        {
+            auto reply = std::make_shared<protocol::TMLedgerData>();
+            reply->set_ledgerhash(theirHash.begin(), theirHash.size());
+            reply->set_ledgerseq(0);
+            reply->set_type(protocol::liTS_CANDIDATE);
+            for (auto const& raw : request->nodeids())
+            {
+                auto const id = deserializeSHAMapNodeID(raw);
+                if (!BEAST_EXPECT(id))
+                    return;
+                requested.push_back(*id);
+
+                std::vector<SHAMapNodeID> nodeIDs;
+                std::vector<Blob> rawNodes;
+                if (!BEAST_EXPECT(
+                        theirs->getNodeFat(*id, nodeIDs, rawNodes, false, 0)))
+                    return;
+                for (std::size_t i = 0; i < nodeIDs.size(); ++i)
+                {
+                    auto node = reply->add_nodes();
+                    node->set_nodeid(nodeIDs[i].getRawString());
+                    node->set_nodedata(rawNodes[i].data(), rawNodes[i].size());
+                }
+            }
+            inbound->gotData(theirHash, peer, reply);
+        }
+
+        // The completed acquire hands the set to the application.
+        auto const start = std::chrono::steady_clock::now();
+        while (!app.getInboundTransactions().getSet(theirHash, false) &&
+               std::chrono::steady_clock::now() - start < 5s)
+            std::this_thread::sleep_for(10ms);
+        BEAST_EXPECT(app.getInboundTransactions().getSet(theirHash, false));
+
+        // Everything off the path to the new transaction was supplied
+        // locally: inner nodes from the cache, leaves from the master.
+        auto const extraID = extra->getTransactionID();
+        BEAST_EXPECT(!requested.empty());
+        for (auto const& id : requested)
+            BEAST_EXPECT(
+                id == SHAMapNodeID::createID(id.getDepth(), extraID));
+
+        parent.stop(env.journal);
+    }
+
+public:
+    void
+    run() override
+    {
+        testAcquireFetchesOnlyDifferingBranches();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(InboundTransactions, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,221 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/basics/UptimeClock.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/protocol/digest.h>
+#include <test/jtx.h>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class LedgerMaster_test : public beast::unit_test::suite
+{
+    // Close a few ledgers, each changing some accounts
+    static void
+    closeLedgers(jtx::Env& env)
+    {
+        using namespace jtx;
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int j = 0; j < 8; ++j)
+                env.fund(
+                    XRP(1000),
+                    Account("alice" + std::to_string(i * 8 + j)));
+            env.close();
+        }
+    }
+
+    void
+    testSharedDiffs()
+    {
+        testcase("Peers share a fetch pack part");
+
+        jtx::Env env(*this);
+        closeLedgers(env);
+
+        auto& lm = env.app().getLedgerMaster();
+        auto const have = lm.getClosedLedger();
+        auto const want = lm.getLedgerByHash(have->info().parentHash);
+        if (!BEAST_EXPECT(want))
+            return;
+
+        // Two peers asking for the same range at once get one build
+        std::shared_ptr<protocol::TMGetObjectByHash> diffs[2];
+        std::thread other(
+            [&] { diffs[0] = lm.getFetchPackDiff(*have, *want); });
+        diffs[1] = lm.getFetchPackDiff(*have, *want);
+        other.join();
+        BEAST_EXPECT(diffs[0] && diffs[0] == diffs[1]);
+        BEAST_EXPECT(diffs[0]->objects_size() > 1);
+
+        // And so does one asking later
+        BEAST_EXPECT(lm.getFetchPackDiff(*have, *want) == diffs[0]);
+
+        std::size_t bytes = 0;
+        for (auto const& obj : diffs[0]->objects())
+            bytes += obj.data().size();
+        std::lock_guard lock(lm.fetch_pack_diffs_mutex_);
+        BEAST_EXPECT(lm.fetch_pack_diffs_.size() == 1);
+        BEAST_EXPECT(lm.fetch_pack_diff_bytes_ == bytes);
+        BEAST_EXPECT(lm.fetch_pack_diffs_building_.empty());
+    }
+
+    void
+    testBuildingDiff()
+    {
+        testcase("A fetch pack part is built without the cache locked");
+
+        jtx::Env env(*this);
+        closeLedgers(env);
+
+        auto& lm = env.app().getLedgerMaster();
+        auto const have = lm.getClosedLedger();
+        auto const want = lm.getLedgerByHash(have->info().parentHash);
+        if (!BEAST_EXPECT(want))
+            return;
+
+        // Stand in for a build of the part which is under way
+        std::promise<std::shared_ptr<protocol::TMGetObjectByHash>> building;
+        {
+            std::lock_guard lock(lm.fetch_pack_diffs_mutex_);
+            lm.fetch_pack_diffs_building_.emplace(
+                have->info().hash, building.get_future().share());
+        }
+
+        // A peer asking for the part waits for that build
+        std::shared_ptr<protocol::TMGetObjectByHash> diff;
+        std::thread other([&] { diff = lm.getFetchPackDiff(*have, *want); });
+
+        // While the cache stays available
+        lm.sweep();
+        auto const built = std::make_shared<protocol::TMGetObjectByHash>();
+        {
+            std::lock_guard lock(lm.fetch_pack_diffs_mutex_);
+            BEAST_EXPECT(lm.fetch_pack_diffs_.empty());
+        }
+        building.set_value(built);
+        other.join();
+        BEAST_EXPECT(diff == built);
+
+        std::lock_guard lock(lm.fetch_pack_diffs_mutex_);
+        lm.fetch_pack_diffs_building_.erase(have->info().hash);
+    }
+
+    void
+    testPrebuiltDiff()
+    {
+        testcase("A prebuilt fetch pack part is reused");
+
+        jtx::Env env(*this);
+        closeLedgers(env);
+
+        auto& lm = env.app().getLedgerMaster();
+        auto const ledger = lm.getClosedLedger();
+        auto const want = lm.getLedgerByHash(ledger->info().parentHash);
+        if (!BEAST_EXPECT(want))
+            return;
+
+        // Parts are only built ahead while peers ask for fetch packs
+        lm.prebuildFetchPack(ledger);
+        env.app().getJobQueue().rendezvous();
+        {
+            std::lock_guard lock(lm.fetch_pack_diffs_mutex_);
+            BEAST_EXPECT(lm.fetch_pack_diffs_.empty());
+        }
+
+        lm.fetch_pack_requested_ =
+            UptimeClock::now().time_since_epoch().count();
+        lm.prebuildFetchPack(ledger);
+        env.app().getJobQueue().rendezvous();
+
+        std::shared_ptr<protocol::TMGetObjectByHash> prebuilt;
+        {
+            std::lock_guard lock(lm.fetch_pack_diffs_mutex_);
+            auto const it = lm.fetch_pack_diffs_.find(ledger->info().hash);
+            if (!BEAST_EXPECT(it != lm.fetch_pack_diffs_.end()))
+                return;
+            prebuilt = it->second.objects;
+        }
+        BEAST_EXPECT(lm.getFetchPackDiff(*ledger, *want) == prebuilt);
+    }
+
+    void
+    testBatches()
+    {
+        testcase("A large fetch pack is verified in batches");
+
+        jtx::Env env(*this);
+        auto& lm = env.app().getLedgerMaster();
+
+        // More objects than one batch, one of them not matching its hash
+        std::size_t const count = 600;
+        std::size_t const badIndex = 450;
+        std::vector<std::pair<uint256, std::shared_ptr<Blob>>> objects;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto data = std::make_shared<Blob>(64);
+            (*data)[0] = static_cast<std::uint8_t>(i);
+            (*data)[1] = static_cast<std::uint8_t>(i >> 8);
+            objects.emplace_back(sha512Half(makeSlice(*data)), data);
+        }
+        ++objects[badIndex].first;
+
+        std::atomic<int> calls{0};
+        std::atomic<std::size_t> bad{0};
+        std::atomic<bool> stashed{false};
+        lm.addFetchPack(objects, [&](std::size_t b) {
+            bool all = true;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (i != badIndex && !lm.fetch_packs_.fetch(objects[i].first))
+                    all = false;
+            }
+            stashed = all;
+            bad = b;
+            ++calls;
+        });
+        env.app().getJobQueue().rendezvous();
+
+        BEAST_EXPECT(calls == 1);
+        BEAST_EXPECT(bad == 1);
+        BEAST_EXPECT(stashed);
+        BEAST_EXPECT(!lm.getFetchPack(objects[badIndex].first));
+    }
+
+public:
+    void
+    run() override
+    {
+        testSharedDiffs();
+        testBuildingDiff();
+        testPrebuiltDiff();
+        testBatches();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerMaster, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/app/ledger/BuildLedger.h>
+#include <ripple/app/ledger/LedgerBackfill.h>
 #include <ripple/app/ledger/LedgerMaster.h>
 #include <ripple/app/ledger/LedgerReplay.h>
 #include <ripple/app/ledger/LedgerReplayTask.h>
@@ -25,6 +26,7 @@
 #include <ripple/app/ledger/impl/LedgerDeltaAcquire.h>
 #include <ripple/app/ledger/impl/LedgerReplayMsgHandler.h>
 #include <ripple/app/ledger/impl/SkipListAcquire.h>
+#include <ripple/core/ConfigSections.h>
 #include <ripple/overlay/PeerSet.h>
 #include <ripple/overlay/impl/PeerImp.h>
 #include <test/jtx.h>
@@ -637,6 +639,91 @@ public:
         return false;
     }
 
+    bool
+    waitForBackfills()
+    {
+        int totalRound = 100;
+        for (int i = 0; i < totalRound; ++i)
+        {
+            std::vector<std::shared_ptr<LedgerBackfill>> backfills;
+            {
+                std::unique_lock<std::mutex> lock(replayer.mtx_);
+                backfills = replayer.backfills_;
+            }
+            if (std::all_of(
+                    backfills.begin(), backfills.end(), [](auto const& b) {
+                        return b->finished();
+                    }))
+            {
+                return std::all_of(
+                    backfills.begin(), backfills.end(), [this](auto const& b) {
+                        return taskStatus(b) == TaskStatus::Completed;
+                    });
+            }
+            if (i < totalRound - 1)
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        return false;
+    }
+
+    std::size_t
+    countBackfills()
+    {
+        std::unique_lock<std::mutex> lock(replayer.mtx_);
+        return replayer.backfills_.size();
+    }
+
+    /**
+     * Wait for the backfill to find its start ledger, which fills the
+     * window of deltas
+     * @return the number of deltas in the window, 0 on timeout
+     */
+    std::size_t
+    waitForWindow()
+    {
+        std::shared_ptr<LedgerBackfill> backfill;
+        {
+            std::unique_lock<std::mutex> lock(replayer.mtx_);
+            if (replayer.backfills_.empty())
+                return 0;
+            backfill = replayer.backfills_.front();
+        }
+
+        int totalRound = 100;
+        for (int i = 0; i < totalRound; ++i)
+        {
+            {
+                LedgerBackfill::ScopedLockType sl(backfill->mtx_);
+                if (backfill->parent_)
+                    return backfill->window_.size();
+            }
+            if (i < totalRound - 1)
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        return 0;
+    }
+
+    /** Fill a history gap the way LedgerMaster does */
+    static bool
+    backfillForHistory(
+        LedgerMaster& ledgerMaster,
+        std::uint32_t missing,
+        uint256 const& hash)
+    {
+        return ledgerMaster.backfillForHistory(missing, hash);
+    }
+
+    /** The finish hash and the size of the range of each backfill */
+    static std::vector<std::pair<uint256, std::uint32_t>>
+    getBackfillRanges(LedgerReplayer& replayer)
+    {
+        std::unique_lock<std::mutex> lock(replayer.mtx_);
+        std::vector<std::pair<uint256, std::uint32_t>> ranges;
+        for (auto const& b : replayer.backfills_)
+            ranges.emplace_back(b->getFinishHash(), b->totalLedgers_);
+        return ranges;
+    }
+
     std::vector<std::shared_ptr<LedgerReplayTask>>
     getTasks()
     {
@@ -841,7 +928,7 @@ struct NetworkOfTwo
  * -- process TMProofPathRequest and TMProofPathResponse
  * -- process TMReplayDeltaRequest and TMReplayDeltaResponse
  * -- update and merge LedgerReplayTask::TaskParameter
- * -- process [ledger_replay] section in config
+ * -- process [ledger_replay] and [ledger_replay_backfill] sections in config
  * -- peer handshake
  * -- replay a range of ledgers that the local node already has
  * -- replay a range of ledgers and fallback to InboundLedgers because
@@ -851,6 +938,9 @@ struct NetworkOfTwo
  * -- process a bad skip list
  * -- process a bad ledger delta
  * -- replay ledger ranges with different overlaps
+ * -- backfill a range of ledgers longer than a skip list
+ * -- bound the backfill window by depth and by memory
+ * -- fill a gap in the ledger history by a backfill
  *
  * LedgerReplayerTimeout_test:
  * -- timeouts of SkipListAcquire
@@ -1060,6 +1150,37 @@ struct LedgerReplayer_test : public beast::unit_test::suite
             c.loadFromString(toLoad);
             BEAST_EXPECT(c.LEDGER_REPLAY == false);
         }
+
+        {
+            Config c;
+            BEAST_EXPECT(c.LEDGER_REPLAY_BACKFILL_DEPTH == 512);
+            BEAST_EXPECT(c.LEDGER_REPLAY_BACKFILL_MEMORY == 256);
+            std::string toLoad = (R"rippleConfig(
+[ledger_replay_backfill]
+depth=64
+memory=32
+)rippleConfig");
+            c.loadFromString(toLoad);
+            BEAST_EXPECT(c.LEDGER_REPLAY_BACKFILL_DEPTH == 64);
+            BEAST_EXPECT(c.LEDGER_REPLAY_BACKFILL_MEMORY == 32);
+        }
+
+        {
+            Config c;
+            std::string toLoad = (R"rippleConfig(
+[ledger_replay_backfill]
+memory=0
+)rippleConfig");
+            try
+            {
+                c.loadFromString(toLoad);
+                fail();
+            }
+            catch (std::runtime_error const&)
+            {
+                pass();
+            }
+        }
     }
 
     void
@@ -1276,7 +1397,7 @@ struct LedgerReplayer_test : public beast::unit_test::suite
             InboundLedger::Reason::GENERIC, finalHash, totalReplay);
 
         auto skipList = net.client.findSkipListAcquire(finalHash);
-        auto item = std::make_shared<SHAMapItem>(uint256(12345), Blob(55, 55));
+        auto item = make_shamapitem(uint256(12345), makeSlice(Blob(55, 55)));
         skipList->processData(l->seq(), item);
 
         std::vector<TaskStatus> deltaStatuses;
@@ -1420,6 +1541,126 @@ struct LedgerReplayer_test : public beast::unit_test::suite
         BEAST_EXPECT(net.client.countsAsExpected(0, 0, 0));
     }
 
+    void
+    testBackfill(int totalReplay)
+    {
+        testcase("backfill");
+        NetworkOfTwo net(
+            *this,
+            {totalReplay + 1},
+            PeerSetBehavior::Good,
+            InboundLedgersBehavior::Good,
+            PeerFeature::LedgerReplayEnabled);
+
+        auto l = net.server.ledgerMaster.getClosedLedger();
+        uint256 finalHash = l->info().hash;
+        BEAST_EXPECT(net.client.replayer.backfill(
+            InboundLedger::Reason::GENERIC, finalHash, totalReplay));
+
+        BEAST_EXPECT(net.client.waitForBackfills());
+        BEAST_EXPECT(net.client.waitForLedgers(finalHash, totalReplay));
+        BEAST_EXPECT(net.client.countBackfills() == 1);
+
+        // sweep
+        net.client.replayer.sweep();
+        BEAST_EXPECT(net.client.countBackfills() == 0);
+        BEAST_EXPECT(net.client.countsAsExpected(0, 0, 0));
+    }
+
+    void
+    testBackfillWindow()
+    {
+        testcase("backfill window");
+        int const totalReplay = 300;
+        std::size_t const hashBytes = sizeof(uint256) * totalReplay;
+
+        {
+            // The deltas never arrive, so the window is bounded by depth
+            NetworkOfTwo net(
+                *this,
+                {totalReplay + 1},
+                PeerSetBehavior::DropLedgerDeltaReply,
+                InboundLedgersBehavior::Good,
+                PeerFeature::LedgerReplayEnabled);
+            net.client.app.config().LEDGER_REPLAY_BACKFILL_DEPTH = 8;
+            net.client.app.config().LEDGER_REPLAY_BACKFILL_MEMORY = 256;
+
+            auto const l = net.server.ledgerMaster.getClosedLedger();
+            BEAST_EXPECT(net.client.replayer.backfill(
+                InboundLedger::Reason::GENERIC, l->info().hash, totalReplay));
+            BEAST_EXPECT(net.client.waitForWindow() == 8);
+        }
+
+        {
+            // or by memory, charging each delta in flight an estimate
+            NetworkOfTwo net(
+                *this,
+                {totalReplay + 1},
+                PeerSetBehavior::DropLedgerDeltaReply,
+                InboundLedgersBehavior::Good,
+                PeerFeature::LedgerReplayEnabled);
+            net.client.app.config().LEDGER_REPLAY_BACKFILL_DEPTH = 512;
+            net.client.app.config().LEDGER_REPLAY_BACKFILL_MEMORY = 1;
+
+            auto const l = net.server.ledgerMaster.getClosedLedger();
+            BEAST_EXPECT(net.client.replayer.backfill(
+                InboundLedger::Reason::GENERIC, l->info().hash, totalReplay));
+            auto const window = net.client.waitForWindow();
+            BEAST_EXPECT(window > 1 && window + 1 < totalReplay);
+
+            // The hashes of the range count against the limit too
+            std::size_t const maxBytes = 1024 * 1024;
+            auto const estimate = LedgerReplayParameters::DELTA_SIZE_ESTIMATE;
+            BEAST_EXPECT(hashBytes + (window - 1) * estimate < maxBytes);
+            BEAST_EXPECT(hashBytes + window * estimate >= maxBytes);
+        }
+    }
+
+    void
+    testBackfillForHistory()
+    {
+        testcase("backfill for history");
+        using namespace jtx;
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+            cfg->LEDGER_REPLAY = true;
+            cfg->overwrite(ConfigSection::nodeDatabase(), "earliest_seq", "1");
+            return cfg;
+        }));
+        for (int i = 0; i < 10; ++i)
+            env.close();
+
+        auto& ledgerMaster = env.app().getLedgerMaster();
+        auto& replayer = env.app().getLedgerReplayer();
+        auto const last = ledgerMaster.getClosedLedger()->info().seq;
+
+        // A gap of three ledgers below the last one
+        auto const missing = last - 1;
+        auto const hash = ledgerMaster.getHashBySeq(missing);
+        BEAST_EXPECT(hash.isNonZero());
+        for (auto seq = missing - 2; seq <= missing; ++seq)
+            ledgerMaster.clearLedger(seq);
+        auto backfill = [&] {
+            return LedgerReplayClient::backfillForHistory(
+                ledgerMaster, missing, hash);
+        };
+
+        // Disabled, the gap is filled one ledger at a time
+        env.app().config().LEDGER_REPLAY = false;
+        BEAST_EXPECT(!backfill());
+        env.app().config().LEDGER_REPLAY = true;
+        env.app().config().LEDGER_REPLAY_BACKFILL_DEPTH = 0;
+        BEAST_EXPECT(!backfill());
+        BEAST_EXPECT(LedgerReplayClient::getBackfillRanges(replayer).empty());
+
+        // The replay starts from the ledger just below the gap
+        env.app().config().LEDGER_REPLAY_BACKFILL_DEPTH = 512;
+        BEAST_EXPECT(backfill());
+        auto const ranges = LedgerReplayClient::getBackfillRanges(replayer);
+        BEAST_EXPECT(ranges.size() == 1);
+        BEAST_EXPECT(ranges.front().first == hash);
+        BEAST_EXPECT(ranges.front().second == 4);
+    }
+
     void
     run() override
     {
@@ -1440,6 +1681,9 @@ struct LedgerReplayer_test : public beast::unit_test::suite
         testSkipListBadReply();
         testLedgerDeltaBadReply();
         testLedgerReplayOverlap();
+        testBackfill(300);
+        testBackfillWindow();
+        testBackfillForHistory();
     }
 };
 
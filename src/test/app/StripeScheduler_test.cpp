@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE  OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/impl/StripeScheduler.h>
+#include <ripple/basics/chrono.h>
+#include <ripple/beast/unit_test.h>
+
+#include <set>
+
+namespace ripple {
+namespace test {
+
+class StripeScheduler_test : public beast::unit_test::suite
+{
+    using Node = StripeScheduler::Node;
+
+    static std::vector<Node>
+    makeNodes(int count)
+    {
+        std::vector<Node> nodes;
+        for (int i = 1; i <= count; ++i)
+            nodes.emplace_back(
+                SHAMapNodeID::createID(64, uint256(i)), uint256(i));
+        return nodes;
+    }
+
+    // The IDs of the nodes in a peer's stripe, as its reply would hold
+    static std::vector<SHAMapNodeID>
+    idsFor(std::vector<StripeScheduler::Stripe> const& stripes, Peer::id_t id)
+    {
+        std::vector<SHAMapNodeID> ids;
+        for (auto const& [peer, stripe] : stripes)
+        {
+            if (peer == id)
+            {
+                for (auto const& n : stripe)
+                    ids.push_back(n.first);
+            }
+        }
+        return ids;
+    }
+
+    static std::size_t
+    sizeFor(std::vector<StripeScheduler::Stripe> const& stripes, Peer::id_t id)
+    {
+        for (auto const& [peer, stripe] : stripes)
+        {
+            if (peer == id)
+                return stripe.size();
+        }
+        return 0;
+    }
+
+public:
+    void
+    testDisjoint()
+    {
+        testcase("disjoint stripes");
+
+        using namespace std::chrono_literals;
+        TestStopwatch clock;
+        StripeScheduler s(clock, 8, 128, 2500ms);
+
+        auto const nodes = makeNodes(100);
+        auto const stripes = s.assign(nodes, {1, 2, 3, 4});
+        BEAST_EXPECT(stripes.size() == 4);
+
+        // Every node is requested once, unmeasured peers get equal shares
+        std::set<uint256> seen;
+        for (auto const& [peer, stripe] : stripes)
+        {
+            BEAST_EXPECT(stripe.size() == 25);
+            for (auto const& n : stripe)
+                BEAST_EXPECT(seen.insert(n.second).second);
+        }
+        BEAST_EXPECT(seen.size() == nodes.size());
+
+        // All peers are busy and all nodes are in flight
+        BEAST_EXPECT(s.assign(nodes, {1, 2, 3, 4, 5}).empty());
+        BEAST_EXPECT(s.assign(makeNodes(110), {1, 2, 3, 4}).empty());
+
+        // A new peer gets only the nodes not in flight
+        auto const more = s.assign(makeNodes(110), {5});
+        BEAST_EXPECT(more.size() == 1 && sizeFor(more, 5) == 10);
+    }
+
+    void
+    testThroughput()
+    {
+        testcase("throughput");
+
+        using namespace std::chrono_literals;
+        TestStopwatch clock;
+        StripeScheduler s(clock, 8, 128, 2500ms);
+
+        auto nodes = makeNodes(100);
+        auto stripes = s.assign(nodes, {1, 2});
+        BEAST_EXPECT(stripes.size() == 2);
+
+        // Peer 1 answers four times as fast as peer 2
+        clock.advance(100ms);
+        BEAST_EXPECT(s.onReply(1, idsFor(stripes, 1), 50));
+        clock.advance(300ms);
+        BEAST_EXPECT(s.onReply(2, idsFor(stripes, 2), 50));
+        BEAST_EXPECT(s.throughput(1) > 3 * s.throughput(2));
+
+        // and gets a larger stripe
+        stripes = s.assign(nodes, {1, 2});
+        BEAST_EXPECT(stripes.size() == 2);
+        BEAST_EXPECT(stripes.front().first == 1);
+        BEAST_EXPECT(sizeFor(stripes, 1) > 3 * sizeFor(stripes, 2));
+        BEAST_EXPECT(sizeFor(stripes, 2) >= 8);
+
+        // Stripes are bounded
+        s.onReply(1, idsFor(stripes, 1), 0);
+        s.onReply(2, idsFor(stripes, 2), 0);
+        stripes = s.assign(makeNodes(1000), {1});
+        BEAST_EXPECT(sizeFor(stripes, 1) == 128);
+    }
+
+    void
+    testTimeout()
+    {
+        testcase("timeout");
+
+        using namespace std::chrono_literals;
+        TestStopwatch clock;
+        StripeScheduler s(clock, 8, 128, 2500ms);
+
+        auto const nodes = makeNodes(64);
+        auto stripes = s.assign(nodes, {1, 2});
+        BEAST_EXPECT(stripes.size() == 2);
+
+        auto const stalled = idsFor(stripes, 2);
+
+        // Peer 1 answers, peer 2 stalls
+        clock.advance(100ms);
+        s.onReply(1, idsFor(stripes, 1), 32);
+        auto const fast = s.throughput(1);
+
+        // The stalled stripe stays in flight until its deadline
+        stripes = s.assign(nodes, {1, 2});
+        BEAST_EXPECT(stripes.size() == 1 && sizeFor(stripes, 1) == 32);
+        s.onReply(1, idsFor(stripes, 1), 32);
+
+        clock.advance(2500ms);
+        s.expire();
+        BEAST_EXPECT(s.timeouts() == 1);
+        BEAST_EXPECT(s.throughput(2) > 0 && s.throughput(2) < fast);
+
+        // Its nodes go to the fast peer, the slow one gets a small share
+        stripes = s.assign(nodes, {1, 2});
+        BEAST_EXPECT(stripes.size() == 2);
+        BEAST_EXPECT(stripes.front().first == 1);
+        BEAST_EXPECT(sizeFor(stripes, 1) + sizeFor(stripes, 2) == 64);
+        BEAST_EXPECT(sizeFor(stripes, 2) == 8);
+
+        // A late reply to a dropped stripe is ignored
+        clock.advance(3s);
+        s.expire();
+        auto const slow = s.throughput(2);
+        BEAST_EXPECT(!s.onReply(2, stalled, 1000));
+        BEAST_EXPECT(s.throughput(2) == slow);
+    }
+
+    void
+    testOtherReplies()
+    {
+        testcase("replies to other requests");
+
+        using namespace std::chrono_literals;
+        TestStopwatch clock;
+        StripeScheduler s(clock, 8, 128, 2500ms);
+
+        auto const nodes = makeNodes(64);
+        auto const stripes = s.assign(nodes, {1, 2});
+        BEAST_EXPECT(stripes.size() == 2);
+
+        // A reply without any node of the peer's stripe, such as one to a
+        // request sent on a timeout, leaves the stripe in flight
+        clock.advance(100ms);
+        BEAST_EXPECT(!s.onReply(1, {SHAMapNodeID{}}, 1));
+        BEAST_EXPECT(!s.onReply(1, idsFor(stripes, 2), 32));
+        BEAST_EXPECT(!s.onReply(1, {}, 0));
+        BEAST_EXPECT(s.throughput(1) == 0);
+        BEAST_EXPECT(s.assign(nodes, {1, 2}).empty());
+
+        // The reply to the stripe is measured and frees the peer
+        clock.advance(100ms);
+        BEAST_EXPECT(s.onReply(1, idsFor(stripes, 1), 32));
+        BEAST_EXPECT(s.throughput(1) > 0);
+        BEAST_EXPECT(!s.assign(nodes, {1, 2}).empty());
+    }
+
+    void
+    run() override
+    {
+        testDisjoint();
+        testThroughput();
+        testTimeout();
+        testOtherReplies();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(StripeScheduler, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -27,6 +27,9 @@
 #include <ripple/protocol/jss.h>
 #include <ripple/protocol/st.h>
 #include <boost/optional.hpp>
+#include <chrono>
+#include <cmath>
+#include <sstream>
 #include <test/jtx.h>
 #include <test/jtx/TestSuite.h>
 #include <test/jtx/WSClient.h>
@@ -4683,8 +4686,124 @@ class TxQ2_test : public TxQ1_test
     }
 };
 
+/** Measures queue admission throughput as the queue grows.
+
+    Every queued transaction comes from a distinct account, which is the
+    shape of a spam event. The transactions are signed, and their
+    signatures marked valid, before the clock starts so the numbers
+    reflect preflight plus TxQ::apply.
+
+    The argument is a comma separated list of queue depths, e.g.
+    "1000,10000,100000". For each depth the suite reports the rate at
+    which the queue was filled from the previous depth.
+*/
+class TxQAdmission_test : public beast::unit_test::suite
+{
+    static std::unique_ptr<Config>
+    makeConfig(std::size_t maxDepth)
+    {
+        auto p = test::jtx::envconfig();
+        auto& section = p->section("transaction_queue");
+        section.set("minimum_txn_in_ledger_standalone", "1000");
+        section.set("minimum_queue_size", std::to_string(maxDepth + 1));
+        return p;
+    }
+
+    static std::vector<std::size_t>
+    parseDepths(std::string const& args)
+    {
+        std::vector<std::size_t> depths;
+        std::istringstream is(args);
+        std::string item;
+        while (std::getline(is, item, ','))
+            depths.push_back(std::stoul(item));
+        std::sort(depths.begin(), depths.end());
+        return depths;
+    }
+
+    void
+    testAdmission(std::vector<std::size_t> const& depths)
+    {
+        using namespace jtx;
+        using namespace std::chrono;
+
+        auto const maxDepth = depths.back();
+        Env env(*this, makeConfig(maxDepth));
+        auto& app = env.app();
+
+        // Fund one account per queued transaction, staying below the
+        // escalation threshold in each ledger.
+        std::vector<Account> accounts;
+        accounts.reserve(maxDepth);
+        for (std::size_t i = 0; i < maxDepth; ++i)
+        {
+            auto metrics = app.getTxQ().getMetrics(*env.current());
+            if (metrics.txInLedger >= metrics.txPerLedger)
+                env.close();
+            accounts.emplace_back("bench" + std::to_string(i));
+            env(pay(env.master, accounts.back(), XRP(1000)));
+        }
+        env.close();
+
+        // Sign everything up front.
+        std::vector<std::shared_ptr<STTx const>> txns;
+        txns.reserve(maxDepth);
+        for (auto const& account : accounts)
+        {
+            auto const jt = env.jt(noop(account));
+            forceValidity(
+                app.getHashRouter(),
+                jt.stx->getTransactionID(),
+                Validity::Valid);
+            txns.push_back(jt.stx);
+        }
+
+        // Fill the open ledger so that everything after it is queued.
+        auto metrics = app.getTxQ().getMetrics(*env.current());
+        for (auto i = metrics.txInLedger; i <= metrics.txPerLedger; ++i)
+            env(noop(env.master));
+
+        std::size_t queued = 0;
+        for (auto const depth : depths)
+        {
+            auto const first = queued;
+            auto const start = steady_clock::now();
+            app.openLedger().modify([&](OpenView& view, beast::Journal j) {
+                for (; queued < depth; ++queued)
+                {
+                    auto const result = app.getTxQ().apply(
+                        app, view, txns[queued], tapNONE, j);
+                    BEAST_EXPECT(result.first == terQUEUED);
+                }
+                return false;
+            });
+            auto const elapsed =
+                duration_cast<duration<double>>(steady_clock::now() - start);
+
+            BEAST_EXPECT(
+                app.getTxQ().getMetrics(*env.current()).txCount == depth);
+            log << "depth " << depth << ": " << (queued - first)
+                << " admitted in " << elapsed.count() << "s, "
+                << std::llround((queued - first) / elapsed.count())
+                << " tx/s" << std::endl;
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        auto const depths =
+            parseDepths(arg().empty() ? "1000,10000,50000" : arg());
+        if (!BEAST_EXPECT(!depths.empty() && depths.front() > 0))
+            return;
+        testAdmission(depths);
+    }
+};
+
 BEAST_DEFINE_TESTSUITE_PRIO(TxQ1, app, ripple, 1);
 BEAST_DEFINE_TESTSUITE_PRIO(TxQ2, app, ripple, 1);
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(TxQAdmission, app, ripple, 1);
 
 }  // namespace test
 }  // namespace ripple
@@ -0,0 +1,563 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/BuildLedger.h>
+#include <ripple/app/ledger/InboundLedger.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/LedgerReplay.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/core/ConfigSections.h>
+#include <ripple/nodestore/Database.h>
+#include <ripple/protocol/TxFormats.h>
+#include <ripple/shamap/Family.h>
+#include <test/jtx.h>
+#include <test/jtx/envconfig.h>
+
+#ifdef PROFILE_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif
+
+#include <boost/algorithm/string.hpp>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace ripple {
+namespace test {
+
+/*  A compact recording of a range of ledgers, from which their transactions
+    can be replayed.
+
+    It holds the state of the ledger before the range, followed by the header
+    and the transactions of each ledger in the range. Inner nodes and
+    metadata are left out, since replaying recreates them. It is a sequence
+    of records, each a one byte type and a four byte length followed by the
+    record itself:
+
+        parent  The header, with the hash, of the ledger before the range.
+        entry   The key and data of one state entry of that ledger.
+        ledger  The header, with the hash, of a ledger in the range.
+        tx      A transaction of the ledger whose header came before it, in
+                the order it was applied.
+        end     The end of the recording.
+*/
+class ReplayFile
+{
+public:
+    enum Record : std::uint8_t { end = 0, parent, entry, ledger, tx };
+
+    /** Record the state of the first ledger and the transactions of the
+        others, which must each follow the one before.
+    */
+    static void
+    write(
+        std::ostream& os,
+        std::vector<std::shared_ptr<Ledger const>> const& ledgers)
+    {
+        assert(!ledgers.empty());
+        writeHeader(os, parent, ledgers.front()->info());
+        for (auto const& item : ledgers.front()->stateMap())
+        {
+            Serializer s(item.size() + 40);
+            s.addBitString(item.key());
+            s.addVL(item.slice());
+            writeRecord(os, entry, s.slice());
+        }
+
+        for (auto iter = ledgers.begin() + 1; iter != ledgers.end(); ++iter)
+        {
+            writeHeader(os, ledger, (*iter)->info());
+            for (auto const& t : LedgerReplay(nullptr, *iter).orderedTxns())
+            {
+                Serializer s;
+                t.second->add(s);
+                writeRecord(os, tx, s.slice());
+            }
+        }
+        writeRecord(os, end, {});
+    }
+
+    explicit ReplayFile(std::istream& is) : is_(is)
+    {
+        next();
+    }
+
+    /** Build the ledger before the range. */
+    std::shared_ptr<Ledger const>
+    readParent(Application& app)
+    {
+        if (type_ != parent)
+            Throw<std::runtime_error>("replay file: missing parent ledger");
+        auto const info = deserializeHeader(makeSlice(data_), true);
+
+        auto built = std::make_shared<Ledger>(
+            info.seq, info.closeTime, app.config(), app.getNodeFamily());
+        while (next() == entry)
+        {
+            SerialIter sit(makeSlice(data_));
+            auto const key = sit.get256();
+            auto const data = sit.getVL();
+            built->stateMap().addItem(
+                SHAMapNodeType::tnACCOUNT_STATE,
+                make_shamapitem(key, makeSlice(data)));
+        }
+        if (built->stateMap().getHash().as_uint256() != info.accountHash)
+            Throw<std::runtime_error>(
+                "replay file: state does not match parent ledger");
+
+        built->stateMap().flushDirty(hotACCOUNT_NODE);
+        built->setLedgerInfo(info);
+        built->setImmutable(app.config(), false);
+        return built;
+    }
+
+    /** Read the next ledger in the range, to replay on top of the parent.
+
+        @return The ledger, or boost::none at the end of the recording.
+    */
+    boost::optional<LedgerReplay>
+    readLedger(std::shared_ptr<Ledger const> const& parent, Application& app)
+    {
+        if (type_ == end)
+            return boost::none;
+        if (type_ != ledger)
+            Throw<std::runtime_error>("replay file: missing ledger header");
+
+        auto const info = deserializeHeader(makeSlice(data_), true);
+        auto header =
+            std::make_shared<Ledger>(info, app.config(), app.getNodeFamily());
+        if (header->info().hash != info.hash)
+            Throw<std::runtime_error>("replay file: bad ledger header");
+
+        std::map<std::uint32_t, std::shared_ptr<STTx const>> txns;
+        while (next() == tx)
+        {
+            SerialIter sit(makeSlice(data_));
+            txns.emplace(txns.size(), std::make_shared<STTx const>(sit));
+        }
+        return LedgerReplay(parent, std::move(header), std::move(txns));
+    }
+
+private:
+    static void
+    writeRecord(std::ostream& os, Record type, Slice data)
+    {
+        Serializer s(data.size() + 5);
+        s.add8(type);
+        s.add32(data.size());
+        s.addRaw(data);
+        os.write(
+            reinterpret_cast<char const*>(s.data()),
+            static_cast<std::streamsize>(s.size()));
+    }
+
+    static void
+    writeHeader(std::ostream& os, Record type, LedgerInfo const& info)
+    {
+        Serializer s;
+        addRaw(info, s, true);
+        writeRecord(os, type, s.slice());
+    }
+
+    Record
+    next()
+    {
+        std::uint8_t head[5];
+        if (!is_.read(reinterpret_cast<char*>(head), sizeof(head)))
+            Throw<std::runtime_error>("replay file: truncated");
+        SerialIter sit(head, sizeof(head));
+        type_ = static_cast<Record>(sit.get8());
+        data_.resize(sit.get32());
+        if (!data_.empty() &&
+            !is_.read(
+                reinterpret_cast<char*>(data_.data()),
+                static_cast<std::streamsize>(data_.size())))
+            Throw<std::runtime_error>("replay file: truncated");
+        return type_;
+    }
+
+    std::istream& is_;
+    Record type_ = end;
+    Blob data_;
+};
+
+//------------------------------------------------------------------------------
+
+class TxReplay_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        testcase("Record and replay");
+
+        using namespace jtx;
+
+        Env env(*this);
+        Account const gw{"gw"};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(100000), gw, alice, bob);
+        env.close();
+        auto const first = env.closed()->seq();
+
+        env.trust(USD(1000), alice, bob);
+        env(pay(gw, alice, USD(500)));
+        env.close();
+        env(offer(alice, XRP(100), USD(50)));
+        env(offer(bob, USD(20), XRP(40)));
+        env(pay(alice, bob, XRP(10)));
+        env.close();
+        env.close();
+
+        auto& ledgerMaster = env.app().getLedgerMaster();
+        std::vector<std::shared_ptr<Ledger const>> ledgers;
+        for (auto seq = first; seq <= env.closed()->seq(); ++seq)
+            ledgers.push_back(ledgerMaster.getLedgerBySeq(seq));
+
+        std::stringstream ss;
+        ReplayFile::write(ss, ledgers);
+
+        ReplayFile file(ss);
+        auto parent = file.readParent(env.app());
+        BEAST_EXPECT(parent->info().hash == ledgers.front()->info().hash);
+
+        std::size_t replayed = 0;
+        while (auto const replay = file.readLedger(parent, env.app()))
+        {
+            auto const& expected = ledgers.at(++replayed);
+            BEAST_EXPECT(
+                replay->orderedTxns().size() ==
+                LedgerReplay(nullptr, expected).orderedTxns().size());
+            parent = buildLedger(*replay, tapNONE, env.app(), env.journal);
+            BEAST_EXPECT(parent->info().hash == expected->info().hash);
+        }
+        BEAST_EXPECT(replayed == ledgers.size() - 1);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/*  Replays a recording of real ledgers and reports the cost of applying
+    each type of transaction. Arguments are comma separated key=value pairs:
+
+        file=<path>     Replay the recording at <path>.
+
+        export=<path>   Write a recording to <path> from a node store,
+        type=<backend>  with the given backend type (NuDB by default)
+        path=<path>     and path, of the <count> ledgers which end at the
+        ledger=<hash>   ledger with the given hash. Use the database of a
+        count=<count>   stopped server, or a copy of it.
+
+    With no arguments a few ledgers of payments, trust lines and offers are
+    created, recorded and replayed.
+
+    Bytes allocated are only reported when built with -Djemalloc=ON.
+*/
+class TxReplay_timing_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct Timing
+    {
+        std::size_t count = 0;
+        std::size_t notApplied = 0;
+        clock_type::duration elapsed{};
+        std::uint64_t allocated = 0;
+    };
+
+#ifdef PROFILE_JEMALLOC
+    static bool constexpr countsAllocations = true;
+#else
+    static bool constexpr countsAllocations = false;
+#endif
+
+    // The bytes allocated so far by this thread
+    static std::uint64_t
+    allocatedBytes()
+    {
+#ifdef PROFILE_JEMALLOC
+        std::uint64_t allocated = 0;
+        std::size_t size = sizeof(allocated);
+        if (mallctl("thread.allocated", &allocated, &size, nullptr, 0) == 0)
+            return allocated;
+#endif
+        return 0;
+    }
+
+    static double
+    nanoseconds(clock_type::duration d)
+    {
+        return std::chrono::duration_cast<std::chrono::duration<double>>(d)
+                   .count() *
+            1e9;
+    }
+
+    void
+    replay(jtx::Env& env, std::istream& is)
+    {
+        auto& app = env.app();
+        auto const j = env.journal;
+        auto& nodeStore = app.getNodeStore();
+
+        ReplayFile file(is);
+        auto parent = file.readParent(app);
+
+        std::map<TxType, Timing> byType;
+        std::size_t ledgers = 0;
+        std::size_t txns = 0;
+        clock_type::duration building{};
+        auto const fetches = nodeStore.getFetchTotalCount();
+        auto const fetchHits = nodeStore.getFetchHitCount();
+        auto const treeNodeCache = app.getNodeFamily().getTreeNodeCache(0);
+        auto const cacheHits = treeNodeCache->getHits();
+        auto const cacheMisses = treeNodeCache->getMisses();
+
+        while (auto const replay = file.readLedger(parent, app))
+        {
+            // Apply the transactions one at a time to time each of them.
+            {
+                auto const built = std::make_shared<Ledger>(
+                    *parent, replay->replay()->info().closeTime);
+                OpenView accum(&*built);
+                for (auto const& t : replay->orderedTxns())
+                {
+                    auto const allocated = allocatedBytes();
+                    auto const start = clock_type::now();
+                    auto const result = applyTransaction(
+                        app, accum, *t.second, false, tapNONE, j);
+                    auto& timing = byType[t.second->getTxnType()];
+                    timing.elapsed += clock_type::now() - start;
+                    timing.allocated += allocatedBytes() - allocated;
+                    ++timing.count;
+                    if (result != ApplyResult::Success)
+                        ++timing.notApplied;
+                }
+            }
+
+            // Then build the whole ledger, which must match the original.
+            auto const start = clock_type::now();
+            auto const built = buildLedger(*replay, tapNONE, app, j);
+            building += clock_type::now() - start;
+            if (!BEAST_EXPECTS(
+                    built->info().hash == replay->replay()->info().hash,
+                    "ledger " + std::to_string(built->info().seq) +
+                        " does not match"))
+                break;
+
+            parent = built;
+            ++ledgers;
+            txns += replay->orderedTxns().size();
+        }
+
+        log << std::left << std::setw(24) << "Transaction" << std::right
+            << std::setw(10) << "Count" << std::setw(12) << "ns/tx"
+            << std::setw(14) << "bytes/tx" << std::setw(12) << "Not applied"
+            << std::endl;
+        for (auto const& [type, timing] : byType)
+        {
+            auto const format = TxFormats::getInstance().findByType(type);
+            log << std::left << std::setw(24)
+                << (format ? format->getName() : std::to_string(type))
+                << std::right << std::setw(10) << timing.count
+                << std::setw(12) << std::fixed << std::setprecision(0)
+                << nanoseconds(timing.elapsed) / timing.count
+                << std::setw(14)
+                << (countsAllocations
+                        ? std::to_string(timing.allocated / timing.count)
+                        : "-")
+                << std::setw(12) << timing.notApplied << std::endl;
+        }
+
+        log << ledgers << " ledgers, " << txns << " transactions, "
+            << std::fixed << std::setprecision(0)
+            << (txns ? nanoseconds(building) / txns : 0.0)
+            << " ns/tx to build each ledger" << std::endl;
+        auto const hits = treeNodeCache->getHits() - cacheHits;
+        auto const lookups = hits + treeNodeCache->getMisses() - cacheMisses;
+        log << "Tree node cache hit rate: " << std::setprecision(1)
+            << (lookups ? 100.0 * hits / lookups : 0.0) << "%" << std::endl;
+        log << "Node store fetches: "
+            << nodeStore.getFetchTotalCount() - fetches << ", hits "
+            << nodeStore.getFetchHitCount() - fetchHits << std::endl;
+    }
+
+    // Load the ledgers ending at the given one from the node store
+    std::vector<std::shared_ptr<Ledger const>>
+    loadLedgers(Application& app, uint256 hash, std::size_t count)
+    {
+        std::vector<std::shared_ptr<Ledger const>> ledgers(count + 1);
+        for (auto iter = ledgers.rbegin(); iter != ledgers.rend(); ++iter)
+        {
+            auto const object = app.getNodeStore().fetchNodeObject(hash);
+            if (!object)
+                Throw<std::runtime_error>(
+                    "missing ledger header " + to_string(hash));
+
+            auto info = deserializePrefixedHeader(makeSlice(object->getData()));
+            info.hash = hash;
+            bool loaded = false;
+            *iter = std::make_shared<Ledger>(
+                info,
+                loaded,
+                false,
+                app.config(),
+                app.getNodeFamily(),
+                app.journal("TxReplay"));
+            if (!loaded)
+                Throw<std::runtime_error>(
+                    "incomplete ledger " + std::to_string(info.seq));
+            hash = info.parentHash;
+        }
+        return ledgers;
+    }
+
+    void
+    exportLedgers(Section const& args)
+    {
+        using namespace jtx;
+
+        uint256 hash;
+        std::size_t count = 0;
+        if (!BEAST_EXPECTS(
+                hash.parseHex(get<std::string>(args, "ledger")) &&
+                    get_if_exists(args, "count", count) && count > 0,
+                "export needs a ledger and a count"))
+            return;
+
+        Env env(*this, envconfig([&](std::unique_ptr<Config> cfg) {
+            cfg->overwrite(
+                ConfigSection::nodeDatabase(),
+                "type",
+                get<std::string>(args, "type", "NuDB"));
+            cfg->overwrite(
+                ConfigSection::nodeDatabase(),
+                "path",
+                get<std::string>(args, "path"));
+            return cfg;
+        }));
+
+        std::ofstream os(
+            get<std::string>(args, "export"),
+            std::ios::binary | std::ios::trunc);
+        ReplayFile::write(os, loadLedgers(env.app(), hash, count));
+        BEAST_EXPECT(os.good());
+    }
+
+    // Build a few ledgers of ordinary traffic to record and replay
+    std::string
+    makeLedgers(jtx::Env& env)
+    {
+        using namespace jtx;
+
+        Account const gw{"gw"};
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000000), gw);
+        env.close();
+
+        std::vector<Account> accounts;
+        for (int i = 0; i < 200; ++i)
+        {
+            accounts.emplace_back("a" + std::to_string(i));
+            env.fund(XRP(100000), accounts.back());
+        }
+        env.close();
+        auto const first = env.closed()->seq();
+
+        for (auto const& a : accounts)
+        {
+            env(trust(a, USD(100000)));
+            env(pay(gw, a, USD(1000)));
+        }
+        env.close();
+
+        for (int round = 0; round < 5; ++round)
+        {
+            for (std::size_t i = 0; i < accounts.size(); ++i)
+            {
+                auto const& a = accounts[i];
+                auto const& b = accounts[(i + round + 1) % accounts.size()];
+                env(pay(a, b, XRP(10)));
+                env(pay(a, b, USD(5)));
+                if (i % 2)
+                    env(offer(a, XRP(100 + round), USD(10 + i % 7)));
+                else
+                    env(offer(a, USD(10 + i % 7), XRP(90 + round)));
+            }
+            env.close();
+        }
+
+        std::vector<std::shared_ptr<Ledger const>> ledgers;
+        for (auto seq = first; seq <= env.closed()->seq(); ++seq)
+            ledgers.push_back(env.app().getLedgerMaster().getLedgerBySeq(seq));
+
+        std::stringstream ss;
+        ReplayFile::write(ss, ledgers);
+        return ss.str();
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+
+        Section args;
+        {
+            std::vector<std::string> v;
+            boost::split(v, arg(), boost::algorithm::is_any_of(","));
+            args.append(v);
+        }
+
+        if (args.exists("export"))
+        {
+            testcase("Export");
+            exportLedgers(args);
+        }
+        else if (args.exists("file"))
+        {
+            testcase("Replay " + get<std::string>(args, "file"));
+            std::ifstream is(get<std::string>(args, "file"), std::ios::binary);
+            if (!BEAST_EXPECTS(is.is_open(), "can't open the replay file"))
+                return;
+
+            // Only the amendments enabled in the recorded ledgers apply.
+            Env env(*this, envconfig(), FeatureBitset{});
+            replay(env, is);
+        }
+        else
+        {
+            testcase("Replay generated ledgers");
+            Env env(*this);
+            std::stringstream ss(makeLedgers(env));
+            replay(env, ss);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TxReplay, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(TxReplay_timing, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
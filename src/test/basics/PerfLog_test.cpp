@@ -957,12 +957,16 @@ public:
                                   int queued_us,
                                   int running_us) {
             BEAST_EXPECT(countersJson.isObject());
-            BEAST_EXPECT(countersJson.size() == 2);
+            BEAST_EXPECT(countersJson.size() == 3);
 
             BEAST_EXPECT(countersJson.isMember(jss::rpc));
             BEAST_EXPECT(countersJson[jss::rpc].isObject());
             BEAST_EXPECT(countersJson[jss::rpc].size() == 0);
 
+            BEAST_EXPECT(countersJson.isMember(jss::ledger_close));
+            BEAST_EXPECT(countersJson[jss::ledger_close].isObject());
+            BEAST_EXPECT(countersJson[jss::ledger_close].size() == 0);
+
             BEAST_EXPECT(countersJson.isMember(jss::job_queue));
             BEAST_EXPECT(countersJson[jss::job_queue].isObject());
             BEAST_EXPECT(countersJson[jss::job_queue].size() == 1);
@@ -1061,6 +1065,49 @@ public:
         }
     }
 
+    void
+    testLedgerPhases(WithFile withFile)
+    {
+        // Exercise the ledger close phase interface of PerfLog.
+        using namespace std::chrono;
+        PerfLogParent parent{j_};
+        auto perfLog{getPerfLog(parent, withFile)};
+        parent.doStart();
+
+        // Phases that never ran are not reported.
+        BEAST_EXPECT(perfLog->countersJson()[jss::ledger_close].size() == 0);
+
+        perfLog->ledgerPhase(perf::LedgerPhase::apply, microseconds{10});
+        perfLog->ledgerPhase(perf::LedgerPhase::apply, microseconds{1500});
+        perfLog->ledgerPhase(perf::LedgerPhase::apply, milliseconds{3});
+        perfLog->ledgerPhase(perf::LedgerPhase::publish, hours{1});
+
+        Json::Value const phases{perfLog->countersJson()[jss::ledger_close]};
+        BEAST_EXPECT(phases.size() == 2);
+        {
+            Json::Value const& apply{phases["apply"]};
+            BEAST_EXPECT(apply[jss::count] == "3");
+            BEAST_EXPECT(apply[jss::duration_us] == "4510");
+            BEAST_EXPECT(apply[jss::max_us] == "3000");
+
+            // Durations are bucketed by the power of two milliseconds
+            // they fall below.
+            Json::Value const& histogram{apply[jss::histogram_ms]};
+            BEAST_EXPECT(histogram.size() == 3);
+            BEAST_EXPECT(histogram["1"] == "1");
+            BEAST_EXPECT(histogram["2"] == "1");
+            BEAST_EXPECT(histogram["4"] == "1");
+        }
+        {
+            // Anything too long for the bounded buckets lands in the last.
+            Json::Value const& histogram{phases["publish"][jss::histogram_ms]};
+            BEAST_EXPECT(histogram.size() == 1);
+            BEAST_EXPECT(histogram["inf"] == "1");
+        }
+
+        parent.doStop();
+    }
+
     void
     testRotate(WithFile withFile)
     {
@@ -1130,6 +1177,8 @@ public:
         testJobs(WithFile::yes);
         testInvalidID(WithFile::no);
         testInvalidID(WithFile::yes);
+        testLedgerPhases(WithFile::no);
+        testLedgerPhases(WithFile::yes);
         testRotate(WithFile::no);
         testRotate(WithFile::yes);
     }
@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/SlabAllocator.h>
+#include <ripple/beast/unit_test.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+struct SlabAllocator_test : beast::unit_test::suite
+{
+    void
+    testAllocate()
+    {
+        testcase("allocate");
+
+        // Two slabs, each holding a header and then its chunks
+        SlabAllocator a(64, 4096, 8192, 1);
+        BEAST_EXPECT(a.chunkSize() == 64);
+        BEAST_EXPECT(a.stats().reserved == 0);
+
+        std::vector<void*> chunks;
+        while (auto p = a.allocate())
+        {
+            std::memset(p, 0xab, a.chunkSize());
+            chunks.push_back(p);
+        }
+        BEAST_EXPECT(chunks.size() > 2 * (4096 / 64 - 4));
+        BEAST_EXPECT(chunks.size() < 2 * (4096 / 64));
+        BEAST_EXPECT(a.stats().reserved == 8192);
+        BEAST_EXPECT(a.stats().used == chunks.size() * 64);
+
+        // Chunks are distinct and do not overlap
+        std::sort(chunks.begin(), chunks.end());
+        for (std::size_t i = 1; i < chunks.size(); ++i)
+        {
+            BEAST_EXPECT(
+                static_cast<char*>(chunks[i]) -
+                    static_cast<char*>(chunks[i - 1]) >=
+                64);
+        }
+
+        // A freed chunk is handed out again
+        a.deallocate(chunks[3]);
+        BEAST_EXPECT(a.stats().used == (chunks.size() - 1) * 64);
+        BEAST_EXPECT(a.allocate() == chunks[3]);
+        BEAST_EXPECT(a.allocate() == nullptr);
+
+        for (auto p : chunks)
+            a.deallocate(p);
+        BEAST_EXPECT(a.stats().used == 0);
+    }
+
+    void
+    testRelease()
+    {
+        testcase("release");
+
+        SlabAllocator a(64, 4096, 4 * 4096, 1);
+
+        std::vector<void*> chunks;
+        while (auto p = a.allocate())
+            chunks.push_back(p);
+        BEAST_EXPECT(a.stats().reserved == 4 * 4096);
+
+        // Emptied slabs are released, but for one kept for reuse
+        for (auto p : chunks)
+            a.deallocate(p);
+        BEAST_EXPECT(a.stats().used == 0);
+        BEAST_EXPECT(a.stats().reserved == 4096);
+
+        // The kept slab is used before another is reserved
+        auto p = a.allocate();
+        BEAST_EXPECT(p);
+        BEAST_EXPECT(a.stats().reserved == 4096);
+        a.deallocate(p);
+        BEAST_EXPECT(a.stats().reserved == 4096);
+
+        // Slabs beyond a lowered maximum are released as they empty
+        chunks.clear();
+        while (auto p = a.allocate())
+            chunks.push_back(p);
+        a.setMaxSize(0);
+        BEAST_EXPECT(a.allocate() == nullptr);
+        for (auto p : chunks)
+            a.deallocate(p);
+        BEAST_EXPECT(a.stats().reserved == 0);
+    }
+
+    void
+    testChunkSize()
+    {
+        testcase("chunk size");
+
+        // Chunks keep the alignment of the heap
+        SlabAllocator a(44, 1024, 1024);
+        BEAST_EXPECT(a.chunkSize() % alignof(std::max_align_t) == 0);
+        BEAST_EXPECT(a.chunkSize() >= 44);
+
+        auto p = a.allocate();
+        BEAST_EXPECT(p);
+        BEAST_EXPECT(
+            reinterpret_cast<std::uintptr_t>(p) % alignof(std::max_align_t) ==
+            0);
+        a.deallocate(p);
+    }
+
+    void
+    testThreads()
+    {
+        testcase("threads");
+
+        SlabAllocator a(64, 4096, 1024 * 1024, 4);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&a, t] {
+                std::vector<void*> chunks;
+                for (int round = 0; round < 100; ++round)
+                {
+                    for (int i = 0; i < 100; ++i)
+                    {
+                        if (auto p = a.allocate())
+                        {
+                            std::memset(p, t, 64);
+                            chunks.push_back(p);
+                        }
+                    }
+                    for (auto p : chunks)
+                        a.deallocate(p);
+                    chunks.clear();
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+
+        BEAST_EXPECT(a.stats().used == 0);
+        BEAST_EXPECT(a.stats().reserved <= 4096);
+    }
+
+    void
+    testShards()
+    {
+        testcase("shards");
+
+        // Chunks freed on another thread go back to the shard holding them,
+        // and a thread whose shard cannot reserve a slab takes chunks from
+        // the other shards
+        SlabAllocator a(64, 4096, 4096, 2);
+
+        std::vector<void*> chunks;
+        std::thread([&] {
+            while (auto p = a.allocate())
+                chunks.push_back(p);
+        }).join();
+        BEAST_EXPECT(!chunks.empty());
+        BEAST_EXPECT(a.stats().reserved == 4096);
+
+        a.deallocate(chunks.back());
+        chunks.pop_back();
+        void* p = nullptr;
+        std::thread([&] { p = a.allocate(); }).join();
+        BEAST_EXPECT(p);
+        chunks.push_back(p);
+
+        for (auto p : chunks)
+            a.deallocate(p);
+        BEAST_EXPECT(a.stats().used == 0);
+    }
+
+    void
+    run() override
+    {
+        testAllocate();
+        testRelease();
+        testChunkSize();
+        testThreads();
+        testShards();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SlabAllocator, ripple_basics, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE  OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/insight/Histogram.h>
+#include <ripple/beast/insight/TextCollector.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace beast {
+namespace insight {
+
+class Histogram_test : public unit_test::suite
+{
+public:
+    void
+    testBuckets()
+    {
+        testcase("buckets");
+
+        // Every value lies in its bucket, within 1/16 of the bound
+        std::size_t last = 0;
+        std::uint64_t v = 0;
+        for (; v < (std::uint64_t{1} << 20); ++v)
+        {
+            auto const i = Histogram::bucket(v);
+            if ((i != last && i != last + 1) ||
+                v > Histogram::upperBound(i) ||
+                (i != 0 && v <= Histogram::upperBound(i - 1)) ||
+                Histogram::upperBound(i) - v > v / 16)
+                break;
+            last = i;
+        }
+        BEAST_EXPECTS(v == (std::uint64_t{1} << 20), std::to_string(v));
+
+        BEAST_EXPECT(
+            Histogram::bucket(~std::uint64_t{0}) ==
+            Histogram::bucketCount - 1);
+    }
+
+    void
+    testPercentiles()
+    {
+        testcase("percentiles");
+
+        Histogram h;
+        BEAST_EXPECT(h.snapshot(false).percentile(0.5) == 0);
+
+        for (std::uint64_t v = 1; v <= 1000; ++v)
+            h.record(v);
+
+        auto const s = h.snapshot(true);
+        BEAST_EXPECT(s.count == 1000);
+        BEAST_EXPECT(s.sum == 500500);
+        BEAST_EXPECT(s.max == 1000);
+        BEAST_EXPECT(s.percentile(1.0) == 1000);
+
+        auto near = [](std::uint64_t value, std::uint64_t expected) {
+            return value >= expected && value - expected <= expected / 16;
+        };
+        BEAST_EXPECT(near(s.percentile(0.5), 500));
+        BEAST_EXPECT(near(s.percentile(0.9), 900));
+        BEAST_EXPECT(near(s.percentile(0.99), 990));
+
+        // The snapshot reset the histogram
+        BEAST_EXPECT(h.snapshot(false).count == 0);
+    }
+
+    void
+    testConcurrency()
+    {
+        testcase("concurrency");
+
+        Histogram h;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&h, t] {
+                for (std::uint64_t v = 0; v < 10000; ++v)
+                    h.record(v + t);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        auto const s = h.snapshot(false);
+        BEAST_EXPECT(s.count == 40000);
+        BEAST_EXPECT(s.max == 10002);
+        std::uint64_t total = 0;
+        for (auto const n : s.buckets)
+            total += n;
+        BEAST_EXPECT(total == s.count);
+    }
+
+    void
+    testTextCollector()
+    {
+        testcase("text collector");
+
+        auto const collector = TextCollector::New("rippled");
+        auto counter = collector->make_counter("rpc.requests");
+        auto gauge = collector->make_gauge("peers");
+        auto event = collector->make_event("rpc.time");
+        int hooked = 0;
+        auto hook = collector->make_hook([&] {
+            ++hooked;
+            gauge = 21;
+        });
+
+        counter.increment(3);
+        event.notify(std::chrono::milliseconds(5));
+        event.notify(std::chrono::milliseconds(5));
+
+        auto const text = collector->format();
+        BEAST_EXPECT(hooked == 1);
+        auto has = [&text](std::string const& line) {
+            return text.find(line + "\n") != std::string::npos;
+        };
+        BEAST_EXPECT(has("# TYPE rippled_rpc_requests counter"));
+        BEAST_EXPECT(has("rippled_rpc_requests 3"));
+        BEAST_EXPECT(has("# TYPE rippled_peers gauge"));
+        BEAST_EXPECT(has("rippled_peers 21"));
+        BEAST_EXPECT(has("# TYPE rippled_rpc_time histogram"));
+        BEAST_EXPECT(has("rippled_rpc_time_bucket{le=\"5\"} 2"));
+        BEAST_EXPECT(has("rippled_rpc_time_bucket{le=\"+Inf\"} 2"));
+        BEAST_EXPECT(has("rippled_rpc_time_sum 10"));
+        BEAST_EXPECT(has("rippled_rpc_time_count 2"));
+
+        // Values are cumulative between scrapes
+        counter.increment(1);
+        BEAST_EXPECT(
+            collector->format().find("rippled_rpc_requests 4\n") !=
+            std::string::npos);
+    }
+
+    void
+    run() override
+    {
+        testBuckets();
+        testPercentiles();
+        testConcurrency();
+        testTextCollector();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Histogram, insight, beast);
+
+}  // namespace insight
+}  // namespace beast
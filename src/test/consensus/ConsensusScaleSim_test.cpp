@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+#include <ripple/beast/unit_test.h>
+#include <test/csf.h>
+#include <test/csf/random.h>
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace ripple {
+namespace test {
+
+/** Measures how consensus cost grows with the size of the network.
+
+    Each configuration builds a network of validators and relay-only peers,
+    connects every peer to a handful of random neighbors with link delays
+    drawn from a long-tailed distribution, runs a fixed number of rounds
+    and reports CPU time, relayed messages and peak memory per round.
+
+    The suite argument is a comma separated list of peer counts, for
+    example `--unittest-arg=500,1000,2000`.
+*/
+class ConsensusScaleSim_test : public beast::unit_test::suite
+{
+    // Counts the messages relayed between peers, by message type
+    struct RelayCollector
+    {
+        std::size_t proposals = 0;
+        std::size_t validations = 0;
+        std::size_t txs = 0;
+        std::size_t other = 0;
+
+        template <class E>
+        void
+        on(csf::PeerID, csf::SimTime, E const&)
+        {
+        }
+
+        template <class V>
+        void
+        on(csf::PeerID, csf::SimTime, csf::Relay<V> const&)
+        {
+            if constexpr (std::is_same_v<V, csf::Proposal>)
+                ++proposals;
+            else if constexpr (std::is_same_v<V, csf::Validation>)
+                ++validations;
+            else if constexpr (std::is_same_v<V, csf::Tx>)
+                ++txs;
+            else
+                ++other;
+        }
+
+        std::size_t
+        total() const
+        {
+            return proposals + validations + txs + other;
+        }
+    };
+
+    // Peak resident set size of the process in kilobytes, or 0 if unknown
+    static std::size_t
+    peakMemoryKB()
+    {
+#if defined(__linux__)
+        rusage ru;
+        if (getrusage(RUSAGE_SELF, &ru) == 0)
+            return ru.ru_maxrss;
+#elif defined(__APPLE__)
+        rusage ru;
+        if (getrusage(RUSAGE_SELF, &ru) == 0)
+            return ru.ru_maxrss / 1024;
+#endif
+        return 0;
+    }
+
+    void
+    simulate(
+        std::size_t numPeers,
+        std::size_t numValidators,
+        std::size_t degree,
+        int rounds)
+    {
+        using namespace csf;
+        using namespace std::chrono;
+
+        numValidators = std::min(numValidators, numPeers);
+        testcase(
+            std::to_string(numPeers) + " peers, " +
+            std::to_string(numValidators) + " validators");
+
+        Sim sim;
+        PeerGroup validators = sim.createGroup(numValidators);
+        PeerGroup relays = sim.createGroup(numPeers - numValidators);
+        PeerGroup network = validators + relays;
+
+        for (Peer* p : relays)
+            p->runAsValidator = false;
+
+        // Everyone listens to the same set of validators
+        network.trust(validators);
+
+        // Link delays follow a log-normal distribution with a median of
+        // 80ms, which approximates measured latencies between hosting
+        // regions, capped to avoid pathological outliers
+        std::lognormal_distribution<double> latency{std::log(80.0), 0.6};
+        auto delay = [&]() {
+            return milliseconds{static_cast<milliseconds::rep>(
+                std::clamp(latency(sim.rng), 5.0, 1000.0))};
+        };
+
+        // A ring keeps the network connected; random chords bring each
+        // peer up to the requested degree
+        std::uniform_int_distribution<std::size_t> pick{0, numPeers - 1};
+        for (std::size_t i = 0; i < numPeers; ++i)
+        {
+            network[i]->connect(*network[(i + 1) % numPeers], delay());
+            for (std::size_t d = 2; d < degree; ++d)
+            {
+                std::size_t const j = pick(sim.rng);
+                if (j != i)
+                    network[i]->connect(*network[j], delay());
+            }
+        }
+
+        RelayCollector relayed;
+        auto colls = makeCollectors(relayed);
+        sim.collectors.add(colls);
+
+        // Initial round to set prior state
+        sim.run(1);
+        relayed = RelayCollector{};
+
+        std::clock_t const cpuStart = std::clock();
+        auto const wallStart = steady_clock::now();
+        sim.run(rounds);
+        auto const wall = steady_clock::now() - wallStart;
+        double const cpuMs =
+            1000.0 * (std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+        BEAST_EXPECT(sim.synchronized());
+        BEAST_EXPECT(sim.branches() == 1);
+
+        std::size_t currentVals = 0;
+        for (Peer* p : network)
+            currentVals += p->validations.getCurrentNodeIDs().size();
+
+        log << "  rounds: " << rounds
+            << ", wall ms/round: "
+            << duration_cast<milliseconds>(wall).count() / rounds
+            << ", cpu ms/round: " << static_cast<long>(cpuMs / rounds)
+            << std::endl;
+        log << "  relayed/round: " << relayed.total() / rounds
+            << " (proposals " << relayed.proposals / rounds
+            << ", validations " << relayed.validations / rounds
+            << ", txs " << relayed.txs / rounds << ", other "
+            << relayed.other / rounds << ")" << std::endl;
+        log << "  current validations per peer: " << currentVals / numPeers
+            << ", peak rss KB: " << peakMemoryKB() << std::endl;
+    }
+
+    void
+    run() override
+    {
+        std::vector<std::string> sizes;
+        std::string const a = arg().empty() ? "100,500,1000" : arg();
+        boost::split(sizes, a, boost::algorithm::is_any_of(","));
+
+        for (auto const& s : sizes)
+            simulate(std::stoul(s), 35, 10, 10);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL_PRIO(ConsensusScaleSim, consensus, ripple, 80);
+
+}  // namespace test
+}  // namespace ripple
@@ -23,7 +23,9 @@
 #include <ripple/consensus/Validations.h>
 #include <test/csf/Validation.h>
 
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <vector>
@@ -971,6 +973,42 @@ class Validations_test : public beast::unit_test::suite
 
         BEAST_EXPECT(ValStatus::current == harness.add(b.validate(ledgerA)));
         BEAST_EXPECT(harness.vals().numTrustedForLedger(ledgerA.id()) == 1);
+
+        // Untrusted validations are stored but not counted
+        Node c = harness.makeNode();
+        c.untrust();
+        BEAST_EXPECT(ValStatus::current == harness.add(c.validate(ledgerA)));
+        BEAST_EXPECT(harness.vals().numTrustedForLedger(ledgerA.id()) == 1);
+
+        // Readers observe a monotonic count while validations for the
+        // ledger are added concurrently
+        Ledger ledgerAB = h["ab"];
+        std::vector<Node> nodes;
+        for (int i = 0; i < 100; ++i)
+            nodes.push_back(harness.makeNode());
+
+        std::atomic<bool> done{false};
+        std::atomic<bool> monotonic{true};
+        std::thread reader([&]() {
+            std::size_t last = 0;
+            while (!done.load())
+            {
+                auto const n =
+                    harness.vals().numTrustedForLedger(ledgerAB.id());
+                if (n < last || n > nodes.size())
+                    monotonic = false;
+                last = n;
+            }
+        });
+        for (auto& n : nodes)
+            BEAST_EXPECT(
+                ValStatus::current == harness.add(n.validate(ledgerAB)));
+        done = true;
+        reader.join();
+
+        BEAST_EXPECT(monotonic.load());
+        BEAST_EXPECT(
+            harness.vals().numTrustedForLedger(ledgerAB.id()) == nodes.size());
     }
 
     void
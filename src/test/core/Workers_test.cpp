@@ -74,6 +74,12 @@ class PerfLogTest : public PerfLog
     {
     }
 
+    void
+    ledgerPhase(LedgerPhase const phase, std::chrono::microseconds dur)
+        override
+    {
+    }
+
     Json::Value
     countersJson() const override
     {
@@ -24,6 +24,7 @@
 #include <boost/function_output_iterator.hpp>
 #include <map>
 #include <ostream>
+#include <sstream>
 #include <string>
 
 namespace ripple {
@@ -35,7 +35,9 @@
 #include <boost/lexical_cast.hpp>
 #include <test/jtx/envconfig.h>
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 namespace ripple {
@@ -64,6 +66,10 @@ class TrustedPublisherServer
     // actual version.
     std::function<std::string(int)> getList2_;
 
+    // Files served verbatim, keyed by request path
+    std::mutex filesMutex_;
+    std::map<std::string, std::string> files_;
+
     // The SSL context is required, and holds certificates
     bool useSSL_;
     boost::asio::ssl::context sslCtx_{boost::asio::ssl::context::tlsv12};
@@ -320,6 +326,14 @@ public:
         return publisherPublic_;
     }
 
+    /** Serve `body` at `path`, e.g. "/1.tar.lz4". */
+    void
+    addFile(std::string const& path, std::string body)
+    {
+        std::lock_guard lock(filesMutex_);
+        files_[path] = std::move(body);
+    }
+
     /* CA/self-signed certs :
      *
      * The following three methods return certs/keys used by
@@ -578,7 +592,26 @@ private:
                 res.keep_alive(req.keep_alive());
                 bool prepare = true;
 
-                if (boost::starts_with(path, "/validators2"))
+                auto const file = [&]() -> boost::optional<std::string> {
+                    std::lock_guard lock(filesMutex_);
+                    if (auto const it = files_.find(path); it != files_.end())
+                        return it->second;
+                    return boost::none;
+                }();
+
+                if (file)
+                {
+                    res.result(http::status::ok);
+                    res.insert("Content-Type", "application/octet-stream");
+                    if (req.method() == http::verb::get)
+                        res.body() = *file;
+                    else
+                    {
+                        prepare = false;
+                        res.content_length(file->size());
+                    }
+                }
+                else if (boost::starts_with(path, "/validators2"))
                 {
                     res.result(http::status::ok);
                     res.insert("Content-Type", "application/json");
@@ -19,12 +19,16 @@
 
 #include <ripple/app/tx/apply.h>
 #include <ripple/app/tx/impl/ApplyContext.h>
+#include <ripple/app/tx/impl/InvariantCheck.h>
 #include <ripple/app/tx/impl/Transactor.h>
+#include <ripple/beast/type_name.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/protocol/STLedgerEntry.h>
 #include <boost/algorithm/string/predicate.hpp>
 #include <test/jtx.h>
 #include <test/jtx/Env.h>
+#include <chrono>
+#include <iomanip>
 
 namespace ripple {
 
@@ -461,6 +465,60 @@ class Invariants_test : public beast::unit_test::suite
             STTx{ttPAYMENT, [](STObject& tx) {}});
     }
 
+    void
+    testVisitOriginals()
+    {
+        using namespace test::jtx;
+        testcase << "visit originals";
+
+        Env env{*this};
+        Account A1{"A1"};
+        Account A2{"A2"};
+        env.fund(XRP(1000), A1, A2);
+        env.close();
+
+        OpenView ov{*env.current()};
+        ApplyContext ac{
+            env.app(),
+            ov,
+            STTx{ttACCOUNT_SET, [](STObject&) {}},
+            tesSUCCESS,
+            safe_cast<FeeUnit64>(env.current()->fees().units),
+            tapNONE,
+            env.journal};
+
+        auto const balance = env.balance(A1).value();
+
+        // Modify one account, and erase and then recreate the other
+        auto const sleA1 = ac.view().peek(keylet::account(A1.id()));
+        auto const sleA2 = ac.view().peek(keylet::account(A2.id()));
+        if (!BEAST_EXPECT(sleA1 && sleA2))
+            return;
+        sleA1->setFieldAmount(sfBalance, balance - STAmount{10});
+        ac.view().update(sleA1);
+        ac.view().erase(sleA2);
+        auto const sleNew = std::make_shared<SLE>(*sleA2);
+        sleNew->setFieldAmount(sfBalance, STAmount{20});
+        ac.view().insert(sleNew);
+
+        std::size_t visited = 0;
+        ac.visit([&](uint256 const& key,
+                     bool isDelete,
+                     std::shared_ptr<SLE const> const& before,
+                     std::shared_ptr<SLE const> const& after) {
+            ++visited;
+            BEAST_EXPECT(!isDelete);
+            if (!BEAST_EXPECT(before && after))
+                return;
+            // The entries as they were before the transaction, not the
+            // copies which it modified.
+            BEAST_EXPECT(*before == *ov.read(keylet::unchecked(key)));
+            BEAST_EXPECT(before->getFieldAmount(sfBalance) == balance);
+            BEAST_EXPECT(after->getFieldAmount(sfBalance) != balance);
+        });
+        BEAST_EXPECT(visited == 2);
+    }
+
 public:
     void
     run() override
@@ -474,9 +532,137 @@ public:
         testNoBadOffers();
         testNoZeroEscrow();
         testValidNewAccountRoot();
+        testVisitOriginals();
+    }
+};
+
+// Reports what each invariant check costs for every entry a transaction
+// changes, over a transaction which changes many offers and trust lines.
+class Invariants_timing_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct NoCheck
+    {
+        void
+        visitEntry(
+            bool,
+            std::shared_ptr<SLE const> const&,
+            std::shared_ptr<SLE const> const&)
+        {
+        }
+    };
+
+    template <class Check>
+    clock_type::duration
+    time(ApplyContext& ac, int rounds)
+    {
+        auto const start = clock_type::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            Check check;
+            ac.visit([&check](
+                         uint256 const&,
+                         bool isDelete,
+                         std::shared_ptr<SLE const> const& before,
+                         std::shared_ptr<SLE const> const& after) {
+                check.visitEntry(isDelete, before, after);
+            });
+        }
+        return clock_type::now() - start;
+    }
+
+    void
+    report(std::string const& name, clock_type::duration d, double visits)
+    {
+        using namespace std::chrono;
+        log << std::setw(24) << std::left << name << std::setw(10)
+            << std::right << std::fixed << std::setprecision(1)
+            << duration_cast<nanoseconds>(d).count() / visits << " ns/entry"
+            << std::endl;
+    }
+
+    template <std::size_t... Is>
+    void
+    timeChecks(
+        ApplyContext& ac,
+        int rounds,
+        double visits,
+        std::index_sequence<Is...>)
+    {
+        // The cost of visiting the changes is reported on its own and taken
+        // out of the cost of each check.
+        auto const visit = time<NoCheck>(ac, rounds);
+        report("(visit)", visit, visits);
+        (...,
+         report(
+             beast::type_name<std::tuple_element_t<Is, InvariantChecks>>(),
+             time<std::tuple_element_t<Is, InvariantChecks>>(ac, rounds) -
+                 visit,
+             visits));
+    }
+
+public:
+    void
+    run() override
+    {
+        using namespace test::jtx;
+
+        Env env{*this};
+        Account const gw{"gw"};
+        auto const USD = gw["USD"];
+        env.fund(XRP(100000), gw);
+
+        std::size_t const accounts = 100;
+        std::size_t const offers = 10;
+        for (std::size_t i = 0; i < accounts; ++i)
+        {
+            Account const a{"a" + std::to_string(i)};
+            env.fund(XRP(100000), a);
+            env(trust(a, USD(100000)));
+            env(pay(gw, a, USD(10000)));
+            for (std::size_t j = 0; j < offers; ++j)
+                env(offer(a, XRP(100 + j), USD(10 + i)));
+            env.close();
+        }
+
+        OpenView ov{*env.current()};
+        ApplyContext ac{
+            env.app(),
+            ov,
+            STTx{ttACCOUNT_SET, [](STObject&) {}},
+            tesSUCCESS,
+            safe_cast<FeeUnit64>(env.current()->fees().units),
+            tapNONE,
+            env.journal};
+
+        // Touch every entry in the ledger, as crossing all of those offers
+        // would.
+        std::vector<uint256> keys;
+        for (auto const& sle : ov.sles)
+            keys.push_back(sle->key());
+        for (auto const& key : keys)
+            ac.view().update(ac.view().peek(keylet::unchecked(key)));
+
+        int const rounds = 200;
+        double const visits = static_cast<double>(rounds) * keys.size();
+        log << keys.size() << " entries changed" << std::endl;
+
+        timeChecks(
+            ac,
+            rounds,
+            visits,
+            std::make_index_sequence<std::tuple_size_v<InvariantChecks>>{});
+
+        auto const start = clock_type::now();
+        for (int r = 0; r < rounds; ++r)
+            BEAST_EXPECT(
+                ac.checkInvariants(tesSUCCESS, XRPAmount{}) == tesSUCCESS);
+        report("(all, one pass)", clock_type::now() - start, visits);
     }
 };
 
 BEAST_DEFINE_TESTSUITE(Invariants, ledger, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(Invariants_timing, ledger, ripple);
 
 }  // namespace ripple
@@ -19,9 +19,14 @@
 
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/BatchWriter.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
 #include <test/nodestore/TestBase.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace ripple {
 namespace NodeStore {
@@ -76,6 +81,117 @@ public:
         }
     }
 
+    // Checks that stores only stall while the pending batch is full
+    void
+    testBatchWriter(std::uint64_t const seedValue)
+    {
+        testcase("batch writer");
+
+        // Runs each scheduled task on its own thread
+        struct ThreadScheduler : DummyScheduler
+        {
+            std::vector<std::thread> threads;
+
+            ~ThreadScheduler()
+            {
+                for (auto& t : threads)
+                    t.join();
+            }
+
+            void
+            scheduleTask(Task& task) override
+            {
+                threads.emplace_back(
+                    [&task]() { task.performScheduledTask(); });
+            }
+        };
+
+        // Holds every batch write until opened
+        struct Gate : BatchWriter::Callback
+        {
+            std::mutex m;
+            std::condition_variable cv;
+            bool open = false;
+            std::size_t written = 0;
+
+            void
+            writeBatch(Batch const& batch) override
+            {
+                std::unique_lock lock(m);
+                cv.wait(lock, [this] { return open; });
+                written += batch.size();
+            }
+        };
+
+        auto const object = createPredictableBatch(1, seedValue).front();
+        std::size_t const total = 2 * batchWriteLimitSize + 1;
+
+        ThreadScheduler scheduler;
+        Gate gate;
+        {
+            BatchWriter writer(gate, scheduler);
+
+            std::thread producer([&]() {
+                for (std::size_t i = 0; i < total; ++i)
+                    writer.store(object);
+            });
+
+            // The producer fills the batch behind the blocked write and
+            // then has to wait
+            using namespace std::chrono;
+            auto const deadline = steady_clock::now() + 30s;
+            while (writer.counters().writesDelayed == 0 &&
+                   steady_clock::now() < deadline)
+                std::this_thread::sleep_for(1ms);
+            BEAST_EXPECT(writer.counters().writesDelayed == 1);
+
+            {
+                std::lock_guard lock(gate.m);
+                gate.open = true;
+            }
+            gate.cv.notify_all();
+            producer.join();
+        }
+
+        BEAST_EXPECT(gate.written == total);
+    }
+
+    void
+    testBatchWriterInline(std::uint64_t const seedValue)
+    {
+        testcase("batch writer on the storing thread");
+
+        // DummyScheduler writes the batch before scheduleTask returns
+        struct Counter : BatchWriter::Callback
+        {
+            std::size_t batches = 0;
+            std::size_t written = 0;
+
+            void
+            writeBatch(Batch const& batch) override
+            {
+                ++batches;
+                written += batch.size();
+            }
+        };
+
+        auto const batch = createPredictableBatch(16, seedValue);
+
+        DummyScheduler scheduler;
+        Counter counter;
+        {
+            BatchWriter writer(counter, scheduler);
+            for (auto const& object : batch)
+            {
+                writer.store(object);
+                BEAST_EXPECT(writer.getWriteLoad() == 0);
+            }
+        }
+
+        BEAST_EXPECT(counter.batches == batch.size());
+        BEAST_EXPECT(counter.written == batch.size());
+    }
+
     void
     run() override
     {
@@ -84,6 +200,10 @@ public:
         testBatches(seedValue);
 
         testBlobs(seedValue);
+
+        testBatchWriter(seedValue);
+
+        testBatchWriterInline(seedValue);
     }
 };
 
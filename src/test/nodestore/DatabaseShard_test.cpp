@@ -23,11 +23,17 @@
 #include <ripple/core/ConfigSections.h>
 #include <ripple/nodestore/DatabaseShard.h>
 #include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/ShardArchive.h>
+#include <ripple/nodestore/impl/DatabaseShardImp.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/Shard.h>
+#include <ripple/rpc/ShardArchiveHandler.h>
+#include <boost/filesystem/fstream.hpp>
 #include <chrono>
 #include <numeric>
 #include <test/jtx.h>
+#include <test/jtx/TrustedPublisherServer.h>
 #include <test/nodestore/TestBase.h>
 
 namespace ripple {
@@ -268,7 +274,8 @@ class DatabaseShard_test : public TestBase
     saveLedger(
         Database& db,
         Ledger const& ledger,
-        std::shared_ptr<Ledger const> const& next = {})
+        std::shared_ptr<Ledger const> const& next = {},
+        bool storeStateRoot = true)
     {
         // Store header
         {
@@ -284,6 +291,10 @@ class DatabaseShard_test : public TestBase
 
         // Store the state map
         auto visitAcc = [&](SHAMapTreeNode const& node) {
+            if (!storeStateRoot &&
+                node.getHash().as_uint256() == ledger.info().accountHash)
+                return true;
+
             Serializer s;
             node.serializeWithPrefix(s);
             db.store(
@@ -488,6 +499,25 @@ class DatabaseShard_test : public TestBase
         DatabaseShard& db,
         int maxShardNumber = 1,
         int ledgerOffset = 0)
+    {
+        auto const shardIndex{
+            storeShard(data, db, maxShardNumber, ledgerOffset)};
+        if (!shardIndex)
+            return {};
+
+        return waitShard(db, *shardIndex);
+    }
+
+    // Store the ledgers of one shard without waiting for it to be
+    // finalized. If `missingRoot` is set, the state root of the ledger
+    // with that index in `data` is left out.
+    std::optional<int>
+    storeShard(
+        TestData& data,
+        DatabaseShard& db,
+        int maxShardNumber = 1,
+        int ledgerOffset = 0,
+        std::optional<int> missingRoot = std::nullopt)
     {
         int shardIndex{-1};
 
@@ -504,7 +534,8 @@ class DatabaseShard_test : public TestBase
                 ledgersPerShard - 1;
             BEAST_EXPECT(
                 arrInd >= 0 && arrInd < maxShardNumber * ledgersPerShard);
-            BEAST_EXPECT(saveLedger(db, *data.ledgers_[arrInd]));
+            BEAST_EXPECT(saveLedger(
+                db, *data.ledgers_[arrInd], {}, arrInd != missingRoot));
             if (arrInd % ledgersPerShard == (ledgersPerShard - 1))
             {
                 uint256 const finalKey_{0};
@@ -519,7 +550,7 @@ class DatabaseShard_test : public TestBase
             db.setStored(data.ledgers_[arrInd]);
         }
 
-        return waitShard(db, shardIndex);
+        return shardIndex;
     }
 
     void
@@ -612,6 +643,116 @@ class DatabaseShard_test : public TestBase
         }
     }
 
+    void
+    testFinalizeThreads(std::uint64_t const seedValue)
+    {
+        testcase("Finalize with several threads");
+
+        using namespace test::jtx;
+
+        beast::temp_dir shardDir;
+        auto config{testConfig(shardDir.path())};
+        config->overwrite(
+            ConfigSection::shardDatabase(), "finalize_threads", "4");
+        Env env{*this, std::move(config)};
+        DatabaseShard* db = env.app().getShardStore();
+        BEAST_EXPECT(db);
+
+        TestData data(seedValue, 4, 2);
+        if (!BEAST_EXPECT(data.makeLedgers(env)))
+            return;
+
+        // Each shard's ledgers are verified in ranges by separate threads
+        for (std::uint32_t i = 0; i < 2; ++i)
+            if (!BEAST_EXPECT(createShard(data, *db, 2)))
+                return;
+
+        for (std::uint32_t i = 0; i < 2 * ledgersPerShard; ++i)
+            checkLedger(data, *db, *data.ledgers_[i]);
+    }
+
+    void
+    testConcurrentFinalize(std::uint64_t const seedValue)
+    {
+        testcase("Finalize shards concurrently");
+
+        using namespace test::jtx;
+
+        beast::temp_dir shardDir;
+        auto config{testConfig(shardDir.path())};
+        config->overwrite(
+            ConfigSection::shardDatabase(), "finalize_threads", "2");
+        Env env{*this, std::move(config)};
+        auto db = dynamic_cast<DatabaseShardImp*>(env.app().getShardStore());
+        if (!BEAST_EXPECT(db))
+            return;
+
+        TestData data(seedValue, 4, 4);
+        if (!BEAST_EXPECT(data.makeLedgers(env)))
+            return;
+
+        // Store every shard before waiting so finalizations overlap
+        std::vector<int> shardIndexes;
+        for (std::uint32_t i = 0; i < 4; ++i)
+        {
+            auto const shardIndex{storeShard(data, *db, 4)};
+            if (!BEAST_EXPECT(shardIndex))
+                return;
+            shardIndexes.push_back(*shardIndex);
+        }
+        for (auto const shardIndex : shardIndexes)
+            if (!BEAST_EXPECT(waitShard(*db, shardIndex)))
+                return;
+
+        // The shards never used more threads than the budget
+        BEAST_EXPECT(db->finalizeThreadsPeak() >= 1);
+        BEAST_EXPECT(db->finalizeThreadsPeak() <= 2);
+
+        for (std::uint32_t i = 0; i < 4 * ledgersPerShard; ++i)
+            checkLedger(data, *db, *data.ledgers_[i]);
+    }
+
+    void
+    testFinalizeRangeFailure(std::uint64_t const seedValue)
+    {
+        testcase("Finalize fails in a later range");
+
+        using namespace test::jtx;
+
+        beast::temp_dir shardDir;
+        auto config{testConfig(shardDir.path())};
+        config->overwrite(
+            ConfigSection::shardDatabase(), "finalize_threads", "4");
+        Env env{*this, std::move(config)};
+        DatabaseShard* db = env.app().getShardStore();
+        BEAST_EXPECT(db);
+
+        TestData data(seedValue, 2);
+        if (!BEAST_EXPECT(data.makeLedgers(env)))
+            return;
+
+        // With four threads the last ledgers are verified by a worker,
+        // not by the thread running the finalize task
+        auto const shardIndex{
+            storeShard(data, *db, 1, 0, ledgersPerShard - 2)};
+        if (!BEAST_EXPECT(shardIndex))
+            return;
+
+        // The invalid shard is removed
+        boost::filesystem::path path(shardDir.path());
+        path /= std::to_string(*shardIndex);
+        boost::system::error_code ec;
+        auto const end = std::chrono::system_clock::now() + shardStoreTimeout;
+        while (std::chrono::system_clock::now() < end &&
+               boost::filesystem::exists(path, ec))
+        {
+            std::this_thread::yield();
+        }
+
+        BEAST_EXPECT(!boost::filesystem::exists(path, ec));
+        BEAST_EXPECT(db->getCompleteShards() == bitmask2Rangeset(0));
+    }
+
     void
     testGetCompleteShards(std::uint64_t const seedValue)
     {
@@ -770,6 +911,175 @@ class DatabaseShard_test : public TestBase
         }
     }
 
+    // Create shards 1 and 2 and archive them to `archiveDir`, shard 1 whole
+    // and shard 2 against shard 1.
+    bool
+    exportShardArchives(
+        TestData& data,
+        boost::filesystem::path const& archiveDir)
+    {
+        using namespace test::jtx;
+
+        beast::temp_dir exportDir;
+        Env env{*this, testConfig(exportDir.path())};
+        DatabaseShard* db = env.app().getShardStore();
+        BEAST_EXPECT(db);
+
+        if (!BEAST_EXPECT(data.makeLedgers(env)))
+            return false;
+
+        for (std::uint32_t i = 0; i < 2; ++i)
+            if (!BEAST_EXPECT(createShard(data, *db, 2)))
+                return false;
+        data.ledgers_.clear();
+
+        // The base shard must be final
+        BEAST_EXPECT(!db->exportShardArchive(2, archiveDir / "2.shard", 3));
+
+        if (!BEAST_EXPECT(
+                db->exportShardArchive(1, archiveDir / "1.shard", 0)) ||
+            !BEAST_EXPECT(
+                db->exportShardArchive(2, archiveDir / "2.shard", 1)))
+        {
+            return false;
+        }
+
+        // Objects shared with the base shard are only referenced
+        boost::filesystem::ifstream is(
+            archiveDir / "2.shard", std::ios::binary);
+        ShardArchiveReader reader(is);
+        BEAST_EXPECT(reader.shardIndex() == 2 && reader.baseIndex() == 1);
+        while (!reader.next().empty())
+            ;
+        return BEAST_EXPECT(!reader.references().empty());
+    }
+
+    void
+    testImportShardArchive(std::uint64_t const seedValue)
+    {
+        testcase("Import shard archive");
+
+        using namespace test::jtx;
+        using boost::filesystem::path;
+
+        beast::temp_dir archiveDir;
+        auto archivePath = [&](std::uint32_t shardIndex) {
+            return path(archiveDir.path()) /
+                (std::to_string(shardIndex) + ".shard");
+        };
+
+        TestData data(seedValue, 4, 2);
+        if (!exportShardArchives(data, archiveDir.path()))
+            return;
+
+        beast::temp_dir shardDir;
+        Env env{*this, testConfig(shardDir.path())};
+        DatabaseShard* db = env.app().getShardStore();
+        BEAST_EXPECT(db);
+
+        if (!BEAST_EXPECT(data.makeLedgers(env)))
+            return;
+
+        db->prepareShards({1, 2});
+        BEAST_EXPECT(db->getPreShards() == bitmask2Rangeset(0x6));
+
+        // The base shard must be imported first
+        BEAST_EXPECT(!db->importShardArchive(2, archivePath(2)));
+        BEAST_EXPECT(!db->importShardArchive(2, archivePath(1)));
+
+        if (!BEAST_EXPECT(db->importShardArchive(1, archivePath(1))))
+            return;
+        auto n = waitShard(*db, 1);
+        if (!BEAST_EXPECT(n && *n == 1))
+            return;
+
+        if (!BEAST_EXPECT(db->importShardArchive(2, archivePath(2))))
+            return;
+        n = waitShard(*db, 2);
+        if (!BEAST_EXPECT(n && *n == 2))
+            return;
+
+        BEAST_EXPECT(db->getPreShards() == "");
+        for (std::uint32_t i = 0; i < 2 * ledgersPerShard; ++i)
+            checkLedger(data, *db, *data.ledgers_[i]);
+    }
+
+    void
+    testDownloadShardArchive(std::uint64_t const seedValue)
+    {
+        testcase("Download shard archive");
+
+        using namespace test::jtx;
+        using boost::filesystem::path;
+
+        beast::temp_dir archiveDir;
+        TestData data(seedValue, 4, 2);
+        if (!exportShardArchives(data, archiveDir.path()))
+            return;
+
+        beast::temp_dir shardDir;
+        Env env{*this, testConfig(shardDir.path())};
+        DatabaseShard* db = env.app().getShardStore();
+        BEAST_EXPECT(db);
+
+        if (!BEAST_EXPECT(data.makeLedgers(env)))
+            return;
+
+        // The handler needs a validated ledger past the shard
+        // to confirm the hash of its last ledger
+        env.close();
+
+        // Import the base shard, a shard archive can only be imported
+        // once its base shard is final
+        db->prepareShards({1});
+        if (!BEAST_EXPECT(db->importShardArchive(
+                1, path(archiveDir.path()) / "1.shard")))
+            return;
+        auto n = waitShard(*db, 1);
+        if (!BEAST_EXPECT(n && *n == 1))
+            return;
+
+        std::string archive;
+        {
+            boost::filesystem::ifstream is(
+                path(archiveDir.path()) / "2.shard", std::ios::binary);
+            archive.assign(
+                std::istreambuf_iterator<char>(is),
+                std::istreambuf_iterator<char>());
+        }
+
+        std::vector<test::TrustedPublisherServer::Validator> validators;
+        validators.push_back(test::TrustedPublisherServer::randomValidator());
+        auto server = test::make_TrustedPublisherServer(
+            env.app().getIOService(),
+            validators,
+            env.timeKeeper().now() + std::chrono::seconds{3600},
+            {},
+            false);
+        server->addFile("/2.shard", std::move(archive));
+
+        auto const rawUrl = "http://" +
+            server->local_endpoint().address().to_string() + ":" +
+            std::to_string(server->local_endpoint().port()) + "/2.shard";
+        parsedURL url;
+        if (!BEAST_EXPECT(parseUrl(url, rawUrl)))
+            return;
+
+        auto handler = env.app().getShardArchiveHandler();
+        if (!BEAST_EXPECT(handler))
+            return;
+        BEAST_EXPECT(handler->add(2, {url, rawUrl}));
+        if (!BEAST_EXPECT(handler->start()))
+            return;
+
+        n = waitShard(*db, 2);
+        if (!BEAST_EXPECT(n && *n == 2))
+            return;
+
+        for (std::uint32_t i = 0; i < 2 * ledgersPerShard; ++i)
+            checkLedger(data, *db, *data.ledgers_[i]);
+    }
+
     void
     testCorruptedDatabase(std::uint64_t const seedValue)
     {
@@ -1333,9 +1643,14 @@ public:
         testStandalone();
         testCreateShard(seedValue);
         testReopenDatabase(seedValue + 10);
+        testFinalizeThreads(seedValue + 15);
+        testConcurrentFinalize(seedValue + 16);
+        testFinalizeRangeFailure(seedValue + 17);
         testGetCompleteShards(seedValue + 20);
         testPrepareShards(seedValue + 30);
         testImportShard(seedValue + 40);
+        testImportShardArchive(seedValue + 45);
+        testDownloadShardArchive(seedValue + 47);
         testCorruptedDatabase(seedValue + 50);
         testIllegalFinalKey(seedValue + 60);
         testImport(seedValue + 70);
@@ -21,11 +21,15 @@
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/DatabaseRotatingImp.h>
 #include <test/jtx.h>
 #include <test/jtx/CheckMessageLogs.h>
 #include <test/jtx/envconfig.h>
 #include <test/nodestore/TestBase.h>
 #include <test/unit_test/SuiteJournal.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 namespace ripple {
 
@@ -598,6 +602,69 @@ public:
 
         if (type == "memory")
         {
+            // Read thread tests
+            {
+                Section params{nodeParams};
+                params.set("read_threads", "0");
+                try
+                {
+                    std::unique_ptr<Database> db =
+                        Manager::instance().make_Database(
+                            "test",
+                            megabytes(4),
+                            scheduler,
+                            2,
+                            parent,
+                            params,
+                            journal_);
+                    fail("read_threads=0 accepted");
+                }
+                catch (std::runtime_error const& e)
+                {
+                    BEAST_EXPECT(
+                        std::strcmp(e.what(), "Invalid read_threads") == 0);
+                }
+
+                // Many background reads complete with a large thread pool
+                std::mutex m;
+                std::condition_variable cv;
+                Batch copy;
+
+                params.set("read_threads", "16");
+                std::unique_ptr<Database> db =
+                    Manager::instance().make_Database(
+                        "test",
+                        megabytes(4),
+                        scheduler,
+                        2,
+                        parent,
+                        params,
+                        journal_);
+                storeBatch(*db, batch);
+
+                for (auto const& obj : batch)
+                {
+                    db->asyncFetch(
+                        obj->getHash(),
+                        0,
+                        [&](std::shared_ptr<NodeObject> const& found) {
+                            std::lock_guard lock(m);
+                            copy.push_back(found);
+                            cv.notify_one();
+                        });
+                }
+                {
+                    std::unique_lock lock(m);
+                    BEAST_EXPECT(
+                        cv.wait_for(lock, std::chrono::seconds(30), [&] {
+                            return copy.size() == batch.size();
+                        }));
+                }
+                std::sort(batch.begin(), batch.end(), LessThan{});
+                std::sort(copy.begin(), copy.end(), LessThan{});
+                BEAST_EXPECT(areBatchesEqual(batch, copy));
+            }
+
             // Earliest ledger sequence tests
             {
                 // Verify default earliest ledger sequence
@@ -678,6 +745,216 @@ public:
 
     //--------------------------------------------------------------------------
 
+    // Forwards to another backend, counting fetches that reach it
+    class CountingBackend : public Backend
+    {
+        std::unique_ptr<Backend> backend_;
+        std::atomic<int>& fetches_;
+
+    public:
+        CountingBackend(
+            std::unique_ptr<Backend> backend,
+            std::atomic<int>& fetches)
+            : backend_(std::move(backend)), fetches_(fetches)
+        {
+        }
+
+        std::string
+        getName() override
+        {
+            return backend_->getName();
+        }
+
+        void
+        open(bool createIfMissing) override
+        {
+            backend_->open(createIfMissing);
+        }
+
+        bool
+        isOpen() override
+        {
+            return backend_->isOpen();
+        }
+
+        void
+        close() override
+        {
+            backend_->close();
+        }
+
+        Status
+        fetch(void const* key, std::shared_ptr<NodeObject>* pObject) override
+        {
+            ++fetches_;
+            return backend_->fetch(key, pObject);
+        }
+
+        bool
+        canFetchBatch() override
+        {
+            return backend_->canFetchBatch();
+        }
+
+        std::pair<std::vector<std::shared_ptr<NodeObject>>, Status>
+        fetchBatch(std::vector<uint256 const*> const& hashes) override
+        {
+            fetches_ += hashes.size();
+            return backend_->fetchBatch(hashes);
+        }
+
+        void
+        store(std::shared_ptr<NodeObject> const& object) override
+        {
+            backend_->store(object);
+        }
+
+        void
+        storeBatch(Batch const& batch) override
+        {
+            backend_->storeBatch(batch);
+        }
+
+        void
+        sync() override
+        {
+            backend_->sync();
+        }
+
+        void
+        for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override
+        {
+            backend_->for_each(f);
+        }
+
+        int
+        getWriteLoad() override
+        {
+            return backend_->getWriteLoad();
+        }
+
+        void
+        setDeletePath() override
+        {
+            backend_->setDeletePath();
+        }
+
+        void
+        verify() override
+        {
+            backend_->verify();
+        }
+
+        int
+        fdRequired() const override
+        {
+            return backend_->fdRequired();
+        }
+    };
+
+    void
+    testHotTier(std::int64_t const seedValue)
+    {
+        testcase("rotating hot tier");
+
+        DummyScheduler scheduler;
+        RootStoppable parent("TestRootStoppable");
+
+        beast::temp_dir node_db;
+        int generation = 0;
+        std::atomic<int> fetches{0};
+        auto makeBackend = [&]() -> std::unique_ptr<Backend> {
+            Section params;
+            params.set("type", "memory");
+            params.set(
+                "path",
+                node_db.file("rotate." + std::to_string(generation++)));
+            std::unique_ptr<Backend> backend =
+                std::make_unique<CountingBackend>(
+                    Manager::instance().make_Backend(
+                        params, megabytes(4), scheduler, journal_),
+                    fetches);
+            backend->open();
+            return backend;
+        };
+
+        Section config;
+        config.set("type", "memory");
+
+        // Negative sizes are rejected
+        config.set("hot_tier_size", "-1");
+        try
+        {
+            DatabaseRotatingImp db(
+                "test",
+                scheduler,
+                2,
+                parent,
+                makeBackend(),
+                makeBackend(),
+                config,
+                journal_);
+            fail("hot_tier_size=-1 accepted");
+        }
+        catch (std::runtime_error const& e)
+        {
+            BEAST_EXPECT(
+                std::strcmp(
+                    e.what(), "Specified negative value for hot_tier_size") ==
+                0);
+        }
+
+        config.set("hot_tier_size", std::to_string(numObjectsToTest));
+        DatabaseRotatingImp db(
+            "test",
+            scheduler,
+            2,
+            parent,
+            makeBackend(),
+            makeBackend(),
+            config,
+            journal_);
+
+        auto batch = createPredictableBatch(numObjectsToTest, seedValue);
+        storeBatch(db, batch);
+
+        // Recently stored objects are served without reaching a backend
+        {
+            Batch copy;
+            fetchCopyOfBatch(db, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+            BEAST_EXPECT(fetches == 0);
+        }
+
+        // After rotation everything is fetched from the archive and copied
+        // forward, so it survives a second rotation
+        db.rotateWithLock([&](std::string const&) { return makeBackend(); });
+        {
+            Batch copy;
+            fetchCopyOfBatch(db, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+            BEAST_EXPECT(fetches == 2 * batch.size());
+        }
+
+        // Objects copied forward are hot again
+        fetches = 0;
+        {
+            Batch copy;
+            fetchCopyOfBatch(db, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+            BEAST_EXPECT(fetches == 0);
+        }
+
+        db.rotateWithLock([&](std::string const&) { return makeBackend(); });
+        {
+            Batch copy;
+            fetchCopyOfBatch(db, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     void
     run() override
     {
@@ -687,6 +964,8 @@ public:
 
         testNodeStore("memory", false, seedValue);
 
+        testHotTier(seedValue);
+
         // Persistent backend tests
         {
             testNodeStore("nudb", true, seedValue);
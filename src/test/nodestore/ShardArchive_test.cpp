@@ -0,0 +1,275 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE  OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Slice.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/nodestore/ShardArchive.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/digest.h>
+#include <test/nodestore/TestBase.h>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <sstream>
+
+namespace ripple {
+namespace NodeStore {
+
+class ShardArchive_test : public TestBase
+{
+    // Node objects keyed by the hash of their data, like a shard stores
+    Batch
+    makeBatch(int count, std::uint64_t seedValue)
+    {
+        Batch batch;
+        for (auto const& object : createPredictableBatch(count, seedValue))
+        {
+            auto const& data{object->getData()};
+            batch.push_back(NodeObject::createObject(
+                object->getType(), Blob(data), sha512Half(makeSlice(data))));
+        }
+        return batch;
+    }
+
+    // Read every chunk of an archive
+    Batch
+    readAll(ShardArchiveReader& reader, int& chunks)
+    {
+        Batch result;
+        chunks = 0;
+        for (auto batch = reader.next(); !batch.empty(); batch = reader.next())
+        {
+            ++chunks;
+            result.insert(result.end(), batch.begin(), batch.end());
+        }
+        return result;
+    }
+
+    template <class F>
+    void
+    expectThrow(F&& f, std::string const& what)
+    {
+        try
+        {
+            f();
+            fail("no exception, expected " + what);
+        }
+        catch (std::runtime_error const& e)
+        {
+            BEAST_EXPECTS(e.what() == what, e.what());
+        }
+    }
+
+public:
+    void
+    testRoundTrip(std::uint64_t const seedValue)
+    {
+        testcase("round trip");
+
+        // Large enough to span several chunks
+        auto batch = makeBatch(10000, seedValue);
+
+        // The final key is not keyed by its hash
+        batch.push_back(NodeObject::createObject(
+            hotUNKNOWN, Blob{1, 2, 3, 4}, uint256{}));
+
+        std::stringstream ss;
+        {
+            ShardArchiveWriter writer(ss, 5, 0);
+            for (auto const& object : batch)
+                writer.add(object);
+            writer.finish();
+        }
+
+        ShardArchiveReader reader(ss);
+        BEAST_EXPECT(reader.shardIndex() == 5);
+        BEAST_EXPECT(reader.baseIndex() == 0);
+
+        int chunks;
+        auto const copy{readAll(reader, chunks)};
+        BEAST_EXPECT(chunks > 1);
+        BEAST_EXPECT(areBatchesEqual(batch, copy));
+        BEAST_EXPECT(reader.next().empty());
+        BEAST_EXPECT(reader.references().empty());
+    }
+
+    void
+    testReferences(std::uint64_t const seedValue)
+    {
+        testcase("references");
+
+        auto const base{makeBatch(500, seedValue)};
+        auto const batch{makeBatch(500, seedValue + 1)};
+
+        // Objects held by the base shard are only referenced
+        std::stringstream ss;
+        {
+            ShardArchiveWriter writer(ss, 6, 5);
+            for (auto const& object : batch)
+                writer.add(object);
+            for (auto const& object : base)
+                writer.addReference(object->getHash());
+            writer.finish();
+        }
+        BEAST_EXPECT(ss.str().size() < 500 * (maxPayloadBytes + 100));
+
+        ShardArchiveReader reader(ss);
+        BEAST_EXPECT(reader.shardIndex() == 6);
+        BEAST_EXPECT(reader.baseIndex() == 5);
+
+        int chunks;
+        BEAST_EXPECT(areBatchesEqual(batch, readAll(reader, chunks)));
+        BEAST_EXPECT(chunks == 1);
+
+        auto const references{reader.references()};
+        BEAST_EXPECT(references.size() == base.size());
+        for (std::size_t i = 0; i < base.size(); ++i)
+            BEAST_EXPECT(references[i] == base[i]->getHash());
+
+        // References need a base shard
+        std::stringstream ss2;
+        ShardArchiveWriter writer(ss2, 6, 0);
+        expectThrow(
+            [&] { writer.addReference(base.front()->getHash()); },
+            "shard archive has no base shard");
+    }
+
+    void
+    testCorruption(std::uint64_t const seedValue)
+    {
+        testcase("corruption");
+
+        auto const batch{makeBatch(100, seedValue)};
+        std::string archive;
+        {
+            std::stringstream ss;
+            ShardArchiveWriter writer(ss, 7, 6);
+            for (auto const& object : batch)
+                writer.add(object);
+            writer.addReference(batch.front()->getHash());
+            writer.finish();
+            archive = ss.str();
+        }
+
+        auto read = [&](std::string const& s) {
+            std::stringstream ss(s);
+            ShardArchiveReader reader(ss);
+            int chunks;
+            readAll(reader, chunks);
+            reader.references();
+        };
+
+        // Intact
+        read(archive);
+
+        expectThrow(
+            [&] { read("XXXX" + archive.substr(4)); }, "not a shard archive");
+
+        // A byte of an object, past the header and chunk prefix
+        auto corrupt{archive};
+        corrupt[16 + 40 + 100] ^= 1;
+        expectThrow([&] { read(corrupt); }, "shard archive chunk corrupt");
+
+        // A byte of the reference list
+        corrupt = archive;
+        corrupt.back() ^= 1;
+        expectThrow(
+            [&] { read(corrupt); }, "shard archive references corrupt");
+
+        expectThrow(
+            [&] { read(archive.substr(0, archive.size() / 2)); },
+            "shard archive truncated");
+
+        // A chunk claiming more objects than its payload can hold
+        {
+            // Room for one object's hash and size
+            Blob const payload(36);
+            Serializer s;
+            s.addRaw(makeSlice(archive.substr(0, 16)));
+            s.add32(2);
+            s.add32(payload.size());
+            s.addBitString(sha512Half(makeSlice(payload)));
+            s.addRaw(payload);
+            expectThrow(
+                [&] {
+                    read(std::string(
+                        reinterpret_cast<char const*>(s.data()), s.size()));
+                },
+                "shard archive chunk invalid");
+        }
+
+        // A reference count far beyond the hashes that follow it fails
+        // on the missing hashes rather than allocating for all of them
+        {
+            Serializer s;
+            s.addRaw(makeSlice(archive.substr(0, 16)));
+            s.add32(0);
+            s.add32((1 << 26) - 1);
+            s.addBitString(uint256());
+            s.addBitString(batch.front()->getHash());
+            expectThrow(
+                [&] {
+                    read(std::string(
+                        reinterpret_cast<char const*>(s.data()), s.size()));
+                },
+                "shard archive truncated");
+        }
+    }
+
+    void
+    testDetect(std::uint64_t const seedValue)
+    {
+        testcase("detect");
+
+        beast::temp_dir dir;
+        boost::filesystem::path const archive{dir.file("1.shard")};
+        {
+            boost::filesystem::ofstream os(archive, std::ios::binary);
+            ShardArchiveWriter writer(os, 1, 0);
+            for (auto const& object : makeBatch(10, seedValue))
+                writer.add(object);
+            writer.finish();
+        }
+        BEAST_EXPECT(isShardArchive(archive));
+
+        boost::filesystem::path const other{dir.file("1.tar.lz4")};
+        {
+            boost::filesystem::ofstream os(other, std::ios::binary);
+            os << "not an archive";
+        }
+        BEAST_EXPECT(!isShardArchive(other));
+        BEAST_EXPECT(!isShardArchive(dir.file("missing")));
+    }
+
+    void
+    run() override
+    {
+        std::uint64_t const seedValue = 50;
+
+        testRoundTrip(seedValue);
+        testReferences(seedValue);
+        testCorruption(seedValue);
+        testDetect(seedValue);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ShardArchive, NodeStore, ripple);
+
+}  // namespace NodeStore
+}  // namespace ripple
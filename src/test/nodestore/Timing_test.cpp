@@ -145,7 +145,10 @@ class Timing_test : public beast::unit_test::suite
 public:
     enum {
         // percent of fetches for missing nodes
-        missingNodePercent = 20
+        missingNodePercent = 20,
+
+        // number of keys requested per batch fetch
+        batchSize = 16
     };
 
     std::size_t const default_repeat = 3;
@@ -392,6 +395,86 @@ public:
         backend->close();
     }
 
+    // Fetch existing keys in batches the size of a SHAMap inner node
+    void
+    do_fetchBatch(
+        Section const& config,
+        Params const& params,
+        beast::Journal journal)
+    {
+        DummyScheduler scheduler;
+        auto backend = make_Backend(config, scheduler, journal);
+        BEAST_EXPECT(backend != nullptr);
+        backend->open();
+
+        class Body
+        {
+        private:
+            suite& suite_;
+            Backend& backend_;
+            Sequence seq1_;
+            beast::xor_shift_engine gen_;
+            std::uniform_int_distribution<std::size_t> dist_;
+
+        public:
+            Body(
+                std::size_t id,
+                suite& s,
+                Params const& params,
+                Backend& backend)
+                : suite_(s)
+                , backend_(backend)
+                , seq1_(1)
+                , gen_(id + 1)
+                , dist_(0, params.items - 1)
+            {
+            }
+
+            void
+            operator()(std::size_t i)
+            {
+                try
+                {
+                    std::vector<std::shared_ptr<NodeObject>> objs;
+                    std::vector<uint256 const*> hashes;
+                    objs.reserve(batchSize);
+                    hashes.reserve(batchSize);
+                    for (std::size_t j = 0; j < batchSize; ++j)
+                    {
+                        objs.push_back(seq1_.obj(dist_(gen_)));
+                        hashes.push_back(&objs.back()->getHash());
+                    }
+                    auto const results = backend_.fetchBatch(hashes).first;
+                    suite_.expect(results.size() == objs.size());
+                    for (std::size_t j = 0; j < results.size(); ++j)
+                        suite_.expect(
+                            results[j] && isSame(results[j], objs[j]));
+                }
+                catch (std::exception const& e)
+                {
+                    suite_.fail(e.what());
+                }
+            }
+        };
+        try
+        {
+            parallel_for_id<Body>(
+                params.items / batchSize,
+                params.threads,
+                std::ref(*this),
+                std::ref(params),
+                std::ref(*backend));
+        }
+        catch (std::exception const&)
+        {
+#if NODESTORE_TIMING_DO_VERIFY
+            backend->verify();
+#endif
+            Rethrow();
+        }
+        backend->close();
+    }
+
     // Perform lookups of non-existent keys
     void
     do_missing(
@@ -758,6 +841,7 @@ public:
         test_list const tests = {
             {"Insert", &Timing_test::do_insert},
             {"Fetch", &Timing_test::do_fetch},
+            {"FetchBatch", &Timing_test::do_fetchBatch},
             {"Missing", &Timing_test::do_missing},
             {"Mixed", &Timing_test::do_mixed},
             {"Work", &Timing_test::do_work}};
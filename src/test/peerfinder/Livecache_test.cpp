@@ -21,11 +21,15 @@
 #include <ripple/basics/safe_cast.h>
 #include <ripple/beast/clock/manual_clock.h>
 #include <ripple/beast/unit_test.h>
+#include <ripple/peerfinder/impl/Handouts.h>
 #include <ripple/peerfinder/impl/Livecache.h>
 #include <boost/algorithm/string.hpp>
 #include <test/beast/IPEndpointCommon.h>
 #include <test/unit_test/SuiteJournal.h>
 
+#include <map>
+#include <set>
+
 namespace ripple {
 namespace PeerFinder {
 
@@ -156,74 +160,148 @@ public:
     }
 
     void
-    testShuffle()
+    testRandomOrder()
     {
-        testcase("Shuffle");
+        testcase("Random order");
         Livecache<> c(clock_, journal_);
-        for (auto i = 0; i < 100; ++i)
-            add(beast::IP::randomEP(true),
-                c,
-                ripple::rand_int(0, safe_cast<int>(Tuning::maxHops + 1)));
-
-        using at_hop = std::vector<ripple::PeerFinder::Endpoint>;
+        using at_hop = std::vector<beast::IP::Endpoint>;
         using all_hops = std::array<at_hop, 1 + Tuning::maxHops + 1>;
 
-        auto cmp_EP = [](Endpoint const& a, Endpoint const& b) {
-            return (
-                b.hops < a.hops || (b.hops == a.hops && b.address < a.address));
-        };
-        all_hops before;
-        all_hops before_sorted;
+        all_hops inserted;
+        for (auto i = 0; i < 100; ++i)
+        {
+            auto const ep = beast::IP::randomEP(true);
+            auto const hops =
+                ripple::rand_int(0, safe_cast<int>(Tuning::maxHops + 1));
+            add(ep, c, hops);
+            inserted[hops].push_back(ep);
+        }
+
+        all_hops listed;
         for (auto i = std::make_pair(0, c.hops.begin());
              i.second != c.hops.end();
              ++i.first, ++i.second)
         {
-            std::copy(
-                (*i.second).begin(),
-                (*i.second).end(),
-                std::back_inserter(before[i.first]));
-            std::copy(
-                (*i.second).begin(),
-                (*i.second).end(),
-                std::back_inserter(before_sorted[i.first]));
-            std::sort(
-                before_sorted[i.first].begin(),
-                before_sorted[i.first].end(),
-                cmp_EP);
+            for (auto const& ep : *i.second)
+                listed[i.first].push_back(ep.address);
+        }
+
+        // Each hop list holds the endpoints inserted at its hops, but
+        // not in the order they were inserted
+        bool all_match = true;
+        for (std::size_t i = 0; i < inserted.size(); ++i)
+        {
+            all_match = all_match && (inserted[i] == listed[i]);
+            std::sort(inserted[i].begin(), inserted[i].end());
+            std::sort(listed[i].begin(), listed[i].end());
+            BEAST_EXPECT(inserted[i] == listed[i]);
+        }
+        BEAST_EXPECT(!all_match);
+    }
+
+    void
+    testHandout()
+    {
+        testcase("Handout");
+        constexpr auto num_eps = 5000;
+        constexpr auto num_targets = 1000;
+        Livecache<> c(clock_, journal_);
+        std::map<beast::IP::Endpoint, int> inserted;
+        for (auto i = 0; i < num_eps; ++i)
+        {
+            auto const ep = beast::IP::randomEP(true);
+            auto const hops =
+                ripple::rand_int(1, static_cast<int>(Tuning::maxHops));
+            add(ep, c, hops);
+            // The cache keeps the lowest hops seen for an address
+            auto const result = inserted.emplace(ep, hops);
+            if (!result.second)
+                result.first->second = std::min(result.first->second, hops);
+        }
+
+        // Takes at most 2 endpoints, offered ones are counted
+        struct Target
+        {
+            std::vector<Endpoint> list;
+            std::size_t* offered;
+
+            bool
+            full() const
+            {
+                return list.size() >= 2;
+            }
+
+            bool
+            try_insert(Endpoint const& ep)
+            {
+                ++*offered;
+                if (std::find(list.begin(), list.end(), ep) != list.end())
+                    return false;
+                list.push_back(ep);
+                return true;
+            }
+        };
+
+        std::size_t offered = 0;
+        std::vector<Target> targets(num_targets, Target{{}, &offered});
+        handout(
+            targets.begin(), targets.end(), c.hops.begin(), c.hops.end());
+
+        // Every target is filled, without scanning the whole cache
+        std::set<beast::IP::Endpoint> handedOut;
+        BEAST_EXPECT(std::all_of(
+            targets.begin(), targets.end(), [](Target const& t) {
+                return t.full();
+            }));
+        for (auto const& t : targets)
+        {
+            for (auto const& ep : t.list)
+                handedOut.insert(ep.address);
         }
+        BEAST_EXPECT(offered < 4 * num_targets);
 
-        c.hops.shuffle();
+        // Targets are given different endpoints
+        BEAST_EXPECT(handedOut.size() > num_targets);
 
-        all_hops after;
-        all_hops after_sorted;
+        // Every endpoint is still in the list of its hops, and only there
+        std::size_t n = 0;
         for (auto i = std::make_pair(0, c.hops.begin());
              i.second != c.hops.end();
              ++i.first, ++i.second)
         {
-            std::copy(
-                (*i.second).begin(),
-                (*i.second).end(),
-                std::back_inserter(after[i.first]));
-            std::copy(
-                (*i.second).begin(),
-                (*i.second).end(),
-                std::back_inserter(after_sorted[i.first]));
-            std::sort(
-                after_sorted[i.first].begin(),
-                after_sorted[i.first].end(),
-                cmp_EP);
+            for (auto const& ep : *i.second)
+            {
+                auto const it = inserted.find(ep.address);
+                if (it != inserted.end() && it->second == i.first)
+                    ++n;
+            }
         }
+        BEAST_EXPECT(n == inserted.size());
 
-        // each hop bucket should contain the same items
-        // before and after sort, albeit in different order
-        bool all_match = true;
-        for (auto i = 0; i < before.size(); ++i)
+        // A target which accepts only one endpoint still finds it when a
+        // round of probes misses it
+        struct Picky
         {
-            BEAST_EXPECT(before[i].size() == after[i].size());
-            all_match = all_match && (before[i] == after[i]);
-            BEAST_EXPECT(before_sorted[i] == after_sorted[i]);
-        }
-        BEAST_EXPECT(!all_match);
+            beast::IP::Endpoint wanted;
+            bool found = false;
+
+            bool
+            full() const
+            {
+                return found;
+            }
+
+            bool
+            try_insert(Endpoint const& ep)
+            {
+                found = ep.address == wanted;
+                return found;
+            }
+        };
+
+        std::vector<Picky> picky(1, Picky{inserted.begin()->first});
+        handout(picky.begin(), picky.end(), c.hops.begin(), c.hops.end());
+        BEAST_EXPECT(picky.front().found);
     }
 
     void
@@ -233,7 +311,8 @@ public:
         testInsertUpdate();
         testExpire();
         testHistogram();
-        testShuffle();
+        testRandomOrder();
+        testHandout();
     }
 };
 
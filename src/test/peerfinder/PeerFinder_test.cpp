@@ -157,6 +157,70 @@ public:
         BEAST_EXPECT(n <= (seconds + 59) / 60);
     }
 
+    void
+    test_bootcache_save()
+    {
+        testcase("bootcache save");
+
+        // Counts the saves and keeps the last one
+        struct CountingStore : TestStore
+        {
+            std::size_t saves = 0;
+            std::vector<Entry> saved;
+
+            void
+            save(std::vector<Entry> const& v) override
+            {
+                ++saves;
+                saved = v;
+            }
+        };
+
+        CountingStore store;
+        TestChecker checker;
+        TestStopwatch clock;
+        Logic<TestChecker> logic(clock, store, checker, journal_);
+        auto const remote = boost::asio::ip::tcp::endpoint(
+            boost::asio::ip::address::from_string("65.0.0.1"), 5);
+
+        auto redirect = [&](int first, int count) {
+            std::vector<boost::asio::ip::tcp::endpoint> eps;
+            for (int i = first; i < first + count; ++i)
+                eps.emplace_back(
+                    boost::asio::ip::address_v4(0x42000000 + i), 51235);
+            logic.onRedirects(eps.begin(), eps.end(), remote);
+        };
+
+        // Changes are not saved as they are made
+        redirect(0, 10);
+        BEAST_EXPECT(store.saves == 0);
+
+        // They are saved together by the timer
+        clock.advance(std::chrono::seconds(1));
+        logic.once_per_second();
+        BEAST_EXPECT(store.saves == 1);
+        BEAST_EXPECT(store.saved.size() == 10);
+
+        // No more often than the cooldown allows
+        redirect(10, 10);
+        for (int i = 0; i < 30; ++i)
+        {
+            clock.advance(std::chrono::seconds(1));
+            logic.once_per_second();
+        }
+        BEAST_EXPECT(store.saves == 1);
+
+        clock.advance(Tuning::bootcacheCooldownTime);
+        logic.once_per_second();
+        BEAST_EXPECT(store.saves == 2);
+        BEAST_EXPECT(store.saved.size() == 20);
+
+        // Nothing changed, nothing to save
+        clock.advance(2 * Tuning::bootcacheCooldownTime);
+        logic.once_per_second();
+        BEAST_EXPECT(store.saves == 2);
+    }
+
     void
     test_config()
     {
@@ -279,6 +343,7 @@ public:
     {
         test_backoff1();
         test_backoff2();
+        test_bootcache_save();
         test_config();
         test_invalid_config();
     }
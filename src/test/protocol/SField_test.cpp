@@ -0,0 +1,292 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STLedgerEntryView.h>
+#include <ripple/protocol/st.h>
+
+#include <chrono>
+#include <initializer_list>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+// Ledger entries of the types transactors read most, serialized
+std::vector<std::pair<uint256, Serializer>>
+makeEntries()
+{
+    AccountID const alice{1};
+    AccountID const bob{2};
+    Currency const usd{3};
+
+    std::vector<std::shared_ptr<SLE>> sles;
+
+    auto root = std::make_shared<SLE>(keylet::account(alice));
+    root->setAccountID(sfAccount, alice);
+    root->setFieldAmount(sfBalance, STAmount(1000000000));
+    root->setFieldU32(sfSequence, 42);
+    root->setFieldU32(sfOwnerCount, 3);
+    root->setFieldH256(sfPreviousTxnID, uint256{4});
+    root->setFieldU32(sfPreviousTxnLgrSeq, 5);
+    root->setFieldU32(sfFlags, 0);
+    sles.push_back(root);
+
+    auto line = std::make_shared<SLE>(keylet::line(alice, bob, usd));
+    line->setFieldAmount(sfBalance, STAmount({usd, noAccount()}, 100));
+    line->setFieldAmount(sfLowLimit, STAmount({usd, alice}, 1000));
+    line->setFieldAmount(sfHighLimit, STAmount({usd, bob}, 0));
+    line->setFieldU64(sfLowNode, 0);
+    line->setFieldU64(sfHighNode, 0);
+    line->setFieldH256(sfPreviousTxnID, uint256{6});
+    line->setFieldU32(sfPreviousTxnLgrSeq, 7);
+    line->setFieldU32(sfFlags, lsfLowReserve);
+    sles.push_back(line);
+
+    auto offer = std::make_shared<SLE>(keylet::offer(alice, 8));
+    offer->setAccountID(sfAccount, alice);
+    offer->setFieldU32(sfSequence, 8);
+    offer->setFieldAmount(sfTakerPays, STAmount({usd, bob}, 10));
+    offer->setFieldAmount(sfTakerGets, STAmount(100000));
+    offer->setFieldH256(sfBookDirectory, uint256{9});
+    offer->setFieldU64(sfBookNode, 0);
+    offer->setFieldU64(sfOwnerNode, 0);
+    offer->setFieldH256(sfPreviousTxnID, uint256{10});
+    offer->setFieldU32(sfPreviousTxnLgrSeq, 11);
+    offer->setFieldU32(sfFlags, 0);
+    sles.push_back(offer);
+
+    auto dir = std::make_shared<SLE>(keylet::ownerDir(alice));
+    STVector256 indexes;
+    for (int i = 0; i < 32; ++i)
+        indexes.push_back(uint256(100 + i));
+    dir->setFieldV256(sfIndexes, indexes);
+    dir->setFieldH256(sfRootIndex, dir->key());
+    dir->setAccountID(sfOwner, alice);
+    dir->setFieldU32(sfFlags, 0);
+    sles.push_back(dir);
+
+    std::vector<std::pair<uint256, Serializer>> result;
+    for (auto const& sle : sles)
+    {
+        Serializer s;
+        sle->add(s);
+        result.emplace_back(sle->key(), std::move(s));
+    }
+    return result;
+}
+
+// Reads the fields a payment or an offer crossing would
+std::uint64_t
+readFields(SLE const& sle)
+{
+    std::uint64_t sum = sle[sfFlags];
+    switch (sle.getType())
+    {
+        case ltACCOUNT_ROOT:
+            sum += sle[sfSequence] + sle[sfOwnerCount] +
+                sle[sfBalance].mantissa() + sle[~sfTransferRate].value_or(0);
+            break;
+        case ltRIPPLE_STATE:
+            sum += sle[sfBalance].mantissa() + sle[sfLowLimit].mantissa() +
+                sle[sfHighLimit].mantissa() + sle[~sfLowQualityIn].value_or(0);
+            break;
+        case ltOFFER:
+            sum += sle[sfTakerPays].mantissa() + sle[sfTakerGets].mantissa() +
+                sle[sfBookNode] + sle[~sfExpiration].value_or(0);
+            break;
+        case ltDIR_NODE:
+            sum += sle[sfIndexes].size() + sle[~sfIndexNext].value_or(0);
+            break;
+        default:
+            break;
+    }
+    return sum;
+}
+
+// Reads a field the way typed access did before it compared types: by a
+// dynamic_cast, which an absent field fails
+template <class T>
+boost::optional<std::decay_t<typename T::value_type>>
+castField(STObject const& st, TypedField<T> const& f)
+{
+    if (auto const u = dynamic_cast<T const*>(st.peekAtPField(f)))
+        return u->value();
+    return boost::none;
+}
+
+}  // namespace
+
+class SField_test : public beast::unit_test::suite
+{
+public:
+    void
+    testLookup()
+    {
+        testcase("lookup");
+
+        std::initializer_list<SField const*> const fields = {
+            &sfLedgerEntryType,
+            &sfFlags,
+            &sfBalance,
+            &sfAccount,
+            &sfIndexes,
+            &sfTransaction,
+            &sfMetadata,
+            &sfLedgerEntry};
+        for (auto const f : fields)
+        {
+            BEAST_EXPECT(&SField::getField(f->getCode()) == f);
+            BEAST_EXPECT(&SField::getField(f->fieldType, f->fieldValue) == f);
+            BEAST_EXPECT(&SField::getField(f->getName()) == f);
+        }
+
+        BEAST_EXPECT(&SField::getField(0) == &sfGeneric);
+        BEAST_EXPECT(SField::getField(-1).isInvalid());
+        BEAST_EXPECT(SField::getField(STI_UINT32, 255).isInvalid());
+        BEAST_EXPECT(SField::getField(31, 1).isInvalid());
+        BEAST_EXPECT(SField::getField(STI_UINT16, 200).isInvalid());
+        BEAST_EXPECT(SField::getField(STI_METADATA, 2).isInvalid());
+    }
+
+    void
+    testTypedAccess()
+    {
+        testcase("typed access");
+
+        // Typed access reads what a dynamic_cast finds, for present and
+        // absent fields of every type
+        auto check = [this](STObject const& st, auto const& f) {
+            auto const typed = st[~f];
+            auto const cast = castField(st, f);
+            if (BEAST_EXPECT(!typed == !cast) && typed)
+                BEAST_EXPECT(*typed == *cast);
+        };
+
+        for (auto const& [key, s] : makeEntries())
+        {
+            SLE const sle(SerialIter{s.slice()}, key);
+            check(sle, sfFlags);
+            check(sle, sfSequence);
+            check(sle, sfOwnerCount);
+            check(sle, sfTransferRate);
+            check(sle, sfLowQualityIn);
+            check(sle, sfExpiration);
+            check(sle, sfLowNode);
+            check(sle, sfBookNode);
+            check(sle, sfIndexNext);
+            check(sle, sfBalance);
+            check(sle, sfLowLimit);
+            check(sle, sfTakerPays);
+            check(sle, sfTakerGets);
+            check(sle, sfAccount);
+            check(sle, sfOwner);
+            check(sle, sfPreviousTxnID);
+            check(sle, sfBookDirectory);
+            check(sle, sfIndexes);
+            BEAST_EXPECT(castField(sle, sfFlags));
+        }
+
+        // A typed field which is absent from a free object
+        STObject st(sfGeneric);
+        st.setFieldU32(sfSequence, 1);
+        check(st, sfSequence);
+        check(st, sfOwnerCount);
+        BEAST_EXPECT(st[sfSequence] == 1);
+        BEAST_EXPECT(!st[~sfOwnerCount]);
+        st[sfOwnerCount] = 2;
+        check(st, sfOwnerCount);
+        BEAST_EXPECT(castField(st, sfOwnerCount) == 2u);
+    }
+
+    void
+    run() override
+    {
+        testLookup();
+        testTypedAccess();
+    }
+};
+
+// Times deserializing hot ledger entries and reading their fields.
+class STObjectTiming_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using clock_type = std::chrono::steady_clock;
+        using namespace std::chrono;
+
+        auto const entries = makeEntries();
+        std::size_t const rounds = 200000;
+
+        std::uint64_t sink = 0;
+        auto start = clock_type::now();
+        for (std::size_t i = 0; i < rounds; ++i)
+        {
+            for (auto const& [key, s] : entries)
+            {
+                SLE const sle(SerialIter{s.slice()}, key);
+                sink += sle.getFieldIndex(sfFlags);
+            }
+        }
+        auto const deserialize =
+            duration_cast<nanoseconds>(clock_type::now() - start);
+
+        std::vector<SLE> sles;
+        for (auto const& [key, s] : entries)
+            sles.emplace_back(SerialIter{s.slice()}, key);
+
+        start = clock_type::now();
+        for (std::size_t i = 0; i < rounds; ++i)
+        {
+            for (auto const& sle : sles)
+                sink += readFields(sle);
+        }
+        auto const access =
+            duration_cast<nanoseconds>(clock_type::now() - start);
+
+        // Index the fields of each entry and read only two of them
+        start = clock_type::now();
+        for (std::size_t i = 0; i < rounds; ++i)
+        {
+            for (auto const& [key, s] : entries)
+            {
+                STLedgerEntryView const view(s.slice(), key, nullptr);
+                sink += view[sfFlags] + view[~sfSequence].value_or(0);
+            }
+        }
+        auto const lazy = duration_cast<nanoseconds>(clock_type::now() - start);
+
+        auto const count = rounds * entries.size();
+        log << "deserialize: " << deserialize.count() / count
+            << " ns/entry, read fields: " << access.count() / count
+            << " ns/entry, lazy view: " << lazy.count() / count
+            << " ns/entry (" << sink % 2 << ")" << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SField, protocol, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(STObjectTiming, protocol, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,200 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STLedgerEntryView.h>
+#include <ripple/protocol/st.h>
+
+namespace ripple {
+
+class STLedgerEntryView_test : public beast::unit_test::suite
+{
+    AccountID const alice{1};
+    AccountID const bob{2};
+    Currency const usd{3};
+
+    std::shared_ptr<Serializer>
+    serialize(STObject const& obj)
+    {
+        auto s = std::make_shared<Serializer>();
+        obj.add(*s);
+        return s;
+    }
+
+    STLedgerEntryView
+    makeView(STLedgerEntry const& sle)
+    {
+        auto const s = serialize(sle);
+        return STLedgerEntryView(s->slice(), sle.key(), s);
+    }
+
+    void
+    testFields()
+    {
+        testcase("fields");
+
+        auto root = std::make_shared<SLE>(keylet::account(alice));
+        root->setAccountID(sfAccount, alice);
+        root->setFieldAmount(sfBalance, STAmount(1000000000));
+        root->setFieldU32(sfSequence, 42);
+        root->setFieldU32(sfOwnerCount, 3);
+        root->setFieldU32(sfTransferRate, 1005000000);
+        root->setFieldVL(sfDomain, makeSlice(std::string("example.com")));
+
+        auto const view = makeView(*root);
+        BEAST_EXPECT(view.key() == root->key());
+        BEAST_EXPECT(view.getType() == ltACCOUNT_ROOT);
+        BEAST_EXPECT(view[sfAccount] == alice);
+        BEAST_EXPECT(view[sfBalance] == STAmount(1000000000));
+        BEAST_EXPECT(view[sfSequence] == 42);
+        BEAST_EXPECT(view[~sfTransferRate] == 1005000000u);
+        BEAST_EXPECT(!view[~sfEmailHash]);
+        BEAST_EXPECT(!view.isFieldPresent(sfEmailHash));
+        BEAST_EXPECT(view[sfDomain] == makeSlice(std::string("example.com")));
+
+        // Blobs are read in place
+        auto const domain = view[sfDomain];
+        BEAST_EXPECT(
+            domain.data() >= view.slice().data() &&
+            domain.data() + domain.size() <=
+                view.slice().data() + view.slice().size());
+
+        // A field not in the template
+        try
+        {
+            view[sfTakerPays];
+            fail();
+        }
+        catch (STObject::FieldErr const&)
+        {
+            pass();
+        }
+
+        auto const sle = view.sle();
+        BEAST_EXPECT(*sle == *root);
+        BEAST_EXPECT(sle->getType() == ltACCOUNT_ROOT);
+
+        // A view of an entry which is not serialized yet
+        STLedgerEntryView const copy(*root);
+        BEAST_EXPECT(copy.slice() == view.slice());
+        BEAST_EXPECT(copy[sfOwnerCount] == 3);
+    }
+
+    void
+    testAmountsAndArrays()
+    {
+        testcase("amounts and arrays");
+
+        auto line = std::make_shared<SLE>(keylet::line(alice, bob, usd));
+        line->setFieldAmount(sfBalance, STAmount({usd, noAccount()}, 100));
+        line->setFieldAmount(sfLowLimit, STAmount({usd, alice}, 1000));
+        line->setFieldAmount(sfHighLimit, STAmount({usd, bob}, 0));
+        line->setFieldU32(sfHighQualityIn, 7);
+        line->setFieldU32(sfFlags, lsfLowReserve);
+
+        auto const lineView = makeView(*line);
+        BEAST_EXPECT(lineView[sfLowLimit] == line->getFieldAmount(sfLowLimit));
+        BEAST_EXPECT(lineView[sfLowLimit].getIssuer() == alice);
+        BEAST_EXPECT(lineView[sfHighLimit].getIssuer() == bob);
+        BEAST_EXPECT(lineView[sfHighQualityIn] == 7);
+        BEAST_EXPECT(!lineView[~sfLowQualityIn]);
+        BEAST_EXPECT(lineView[sfFlags] == lsfLowReserve);
+
+        auto list = std::make_shared<SLE>(keylet::signers(alice));
+        list->setFieldU32(sfSignerQuorum, 2);
+        STArray entries(sfSignerEntries);
+        for (auto const& id : {alice, bob})
+        {
+            entries.push_back(STObject(sfSignerEntry));
+            entries.back().setAccountID(sfAccount, id);
+            entries.back().setFieldU16(sfSignerWeight, 1);
+        }
+        list->setFieldArray(sfSignerEntries, entries);
+        list->setFieldU64(sfOwnerNode, 5);
+
+        auto const listView = makeView(*list);
+        BEAST_EXPECT(listView.getType() == ltSIGNER_LIST);
+        BEAST_EXPECT(listView.getFieldArray(sfSignerEntries) == entries);
+        BEAST_EXPECT(listView[sfSignerQuorum] == 2);
+        BEAST_EXPECT(listView[sfOwnerNode] == 5);
+        BEAST_EXPECT(*listView.sle() == *list);
+
+        auto dir = std::make_shared<SLE>(keylet::ownerDir(alice));
+        STVector256 indexes;
+        for (int i = 0; i < 32; ++i)
+            indexes.push_back(uint256(100 + i));
+        dir->setFieldV256(sfIndexes, indexes);
+        dir->setAccountID(sfOwner, alice);
+
+        auto const dirView = makeView(*dir);
+        BEAST_EXPECT(dirView[sfIndexes] == indexes.value());
+        BEAST_EXPECT(!dirView[~sfIndexNext]);
+    }
+
+    void
+    testMalformed()
+    {
+        testcase("malformed");
+
+        auto root = std::make_shared<SLE>(keylet::account(alice));
+        root->setAccountID(sfAccount, alice);
+        root->setFieldAmount(sfBalance, STAmount(1000));
+        auto const s = serialize(*root);
+
+        auto const fails = [&](Slice data) {
+            try
+            {
+                STLedgerEntryView(data, root->key(), s);
+            }
+            catch (std::runtime_error const&)
+            {
+                return true;
+            }
+            return false;
+        };
+
+        BEAST_EXPECT(fails(Slice(s->data(), s->size() - 1)));
+        BEAST_EXPECT(fails(Slice(s->data(), 1)));
+
+        // The same field twice
+        Serializer dup(s->data(), s->size());
+        auto const& balance = root->getFieldAmount(sfBalance);
+        balance.addFieldID(dup);
+        balance.add(dup);
+        BEAST_EXPECT(fails(dup.slice()));
+
+        // Not a ledger entry
+        STObject obj(sfGeneric);
+        obj.setFieldU32(sfSequence, 1);
+        BEAST_EXPECT(fails(serialize(obj)->slice()));
+    }
+
+    void
+    run() override
+    {
+        testFields();
+        testAmountsAndArrays();
+        testMalformed();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(STLedgerEntryView, protocol, ripple);
+
+}  // namespace ripple
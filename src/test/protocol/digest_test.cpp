@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2020 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Blob.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/protocol/digest.h>
+
+#include <chrono>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+// Random messages with the given sizes
+std::vector<Blob>
+makeMessages(std::vector<std::size_t> const& sizes, std::uint64_t seed)
+{
+    beast::xor_shift_engine rng(seed);
+    std::vector<Blob> messages;
+    messages.reserve(sizes.size());
+    for (auto const size : sizes)
+    {
+        Blob message(size);
+        for (auto& c : message)
+            c = static_cast<std::uint8_t>(rng());
+        messages.push_back(std::move(message));
+    }
+    return messages;
+}
+
+std::vector<Slice>
+slices(std::vector<Blob> const& messages)
+{
+    std::vector<Slice> result;
+    result.reserve(messages.size());
+    for (auto const& message : messages)
+        result.push_back(makeSlice(message));
+    return result;
+}
+
+}  // namespace
+
+class digest_test : public beast::unit_test::suite
+{
+    void
+    check(std::vector<std::size_t> const& sizes)
+    {
+        auto const messages = makeMessages(sizes, sizes.size() + 1);
+        auto const s = slices(messages);
+        std::vector<uint256> digests(s.size());
+        sha512HalfBatch(s.data(), digests.data(), s.size());
+        for (std::size_t i = 0; i < s.size(); ++i)
+            BEAST_EXPECT(digests[i] == sha512Half(s[i]));
+    }
+
+    void
+    testBatch()
+    {
+        testcase("batch");
+
+        check({});
+        check({516});
+
+        // Sizes around the padding boundaries of one, two and three blocks
+        std::vector<std::size_t> sizes;
+        for (std::size_t const size :
+             {0, 1, 55, 110, 111, 112, 113, 127, 128, 129, 239, 240, 256, 383})
+        {
+            for (int i = 0; i < 9; ++i)
+                sizes.push_back(size);
+        }
+        check(sizes);
+
+        // Interleaved sizes, including inner nodes and ledger entries
+        sizes.clear();
+        for (int i = 0; i < 100; ++i)
+            sizes.push_back(i % 3 == 0 ? 516 : 40 + 7 * i);
+        check(sizes);
+
+        // Every remainder of a group of lanes
+        for (std::size_t n = 1; n <= 17; ++n)
+            check(std::vector<std::size_t>(n, 516));
+    }
+
+    void
+    run() override
+    {
+        testBatch();
+    }
+};
+
+class digest_timing_test : public beast::unit_test::suite
+{
+    void
+    time(std::string const& name, std::vector<std::size_t> const& sizes)
+    {
+        using namespace std::chrono;
+        using clock_type = steady_clock;
+
+        auto const messages = makeMessages(sizes, 1);
+        auto const s = slices(messages);
+        std::vector<uint256> digests(s.size());
+        std::size_t bytes = 0;
+        for (auto const& message : s)
+            bytes += message.size();
+
+        int const rounds = 20;
+
+        auto start = clock_type::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            for (std::size_t i = 0; i < s.size(); ++i)
+                digests[i] = sha512Half(s[i]);
+        }
+        auto const single =
+            duration_cast<duration<double>>(clock_type::now() - start);
+
+        start = clock_type::now();
+        for (int r = 0; r < rounds; ++r)
+            sha512HalfBatch(s.data(), digests.data(), s.size());
+        auto const batch =
+            duration_cast<duration<double>>(clock_type::now() - start);
+
+        auto const mb = 1e-6 * bytes * rounds;
+        log << name << ": one at a time " << mb / single.count()
+            << " MB/s, batched " << mb / batch.count() << " MB/s"
+            << std::endl;
+        pass();
+    }
+
+    void
+    run() override
+    {
+        std::size_t const count = 100000;
+
+        time("inner nodes", std::vector<std::size_t>(count, 516));
+
+        // Account roots, trust lines and offers
+        std::size_t const leafSizes[] = {170, 230, 250};
+        std::vector<std::size_t> leaves;
+        for (std::size_t i = 0; i < count; ++i)
+            leaves.push_back(leafSizes[i % 3]);
+        time("state leaves", leaves);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(digest, protocol, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(digest_timing, protocol, ripple);
+
+}  // namespace ripple
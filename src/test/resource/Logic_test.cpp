@@ -27,6 +27,8 @@
 
 #include <boost/utility/base_from_member.hpp>
 #include <functional>
+#include <thread>
+#include <vector>
 
 namespace ripple {
 namespace Resource {
@@ -275,6 +277,63 @@ public:
         pass();
     }
 
+    void
+    testConcurrentCharges(beast::Journal j)
+    {
+        testcase("Concurrent charges");
+
+        TestLogic logic(j);
+
+        int const nThreads = 4;
+        int const nCharges = 100000;
+        Charge const fee(1);
+
+        // Every thread charges a shared consumer and one of its own
+        Consumer shared(logic.newInboundEndpoint(
+            beast::IP::Endpoint::from_string("192.0.2.1")));
+        std::vector<Consumer> own;
+        for (int i = 0; i < nThreads; ++i)
+        {
+            own.push_back(
+                logic.newInboundEndpoint(beast::IP::Endpoint::from_string(
+                    "192.0.2." + std::to_string(i + 2))));
+        }
+
+        auto const start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < nThreads; ++i)
+        {
+            threads.emplace_back([&, i] {
+                Consumer c(shared);
+                for (int n = 0; n < nCharges; ++n)
+                {
+                    c.charge(fee);
+                    own[i].charge(fee);
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        auto const elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+
+        JLOG(j.info()) << nThreads << " threads made "
+                       << 2 * nThreads * nCharges << " charges in "
+                       << elapsed.count() << "ms";
+
+        // The clock did not move, so no charge may have been lost
+        BEAST_EXPECT(
+            shared.balance() == nThreads * nCharges / decayWindowSeconds);
+        for (auto& c : own)
+            BEAST_EXPECT(c.balance() == nCharges / decayWindowSeconds);
+
+        // Balances still decay once the clock moves
+        logic.advance();
+        BEAST_EXPECT(
+            shared.balance() < nThreads * nCharges / decayWindowSeconds);
+    }
+
     void
     run() override
     {
@@ -286,6 +345,7 @@ public:
         testCharges(journal);
         testImports(journal);
         testImport(journal);
+        testConcurrentCharges(journal);
     }
 };
 
@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/LedgerToJson.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/protocol/jss.h>
 #include <test/jtx.h>
@@ -487,6 +488,111 @@ public:
         }
     }
 
+    void
+    testThreadedState()
+    {
+        // Converting with several threads gives the same pages
+        using namespace test::jtx;
+        Env env{*this};
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+        env.fund(XRP(100000), gw);
+
+        for (auto i = 0; i < 100; i++)
+        {
+            Account const bob{std::string("bob") + std::to_string(i)};
+            env.fund(XRP(1000), bob);
+            if (i % 3 == 0)
+                env.trust(USD(1000), bob);
+        }
+        env.close();
+
+        auto const ledger = env.closed();
+        auto const convert = [](SLE const& sle) {
+            return Json::Value(to_string(sle.key()));
+        };
+
+        auto const page = [&](uint256 const& after,
+                              std::size_t limit,
+                              LedgerEntryType type,
+                              unsigned int threads) {
+            Json::Value entries{Json::arrayValue};
+            auto const marker = forEachStateJson(
+                *ledger,
+                after,
+                limit,
+                type,
+                &env.app().getJobQueue(),
+                threads,
+                convert,
+                [&entries](Json::Value&& entry) {
+                    entries.append(std::move(entry));
+                });
+            return std::make_pair(entries, marker);
+        };
+
+        // The marker ledger_data has always returned: the key before the
+        // first entry past the limit
+        auto const marker = [&](uint256 const& after, std::size_t limit) {
+            boost::optional<uint256> result;
+            std::size_t visited = 0;
+            for (auto i = ledger->sles.upper_bound(after);
+                 i != ledger->sles.end();
+                 ++i)
+            {
+                if (visited++ == limit)
+                {
+                    auto key = (*i)->key();
+                    result = --key;
+                    break;
+                }
+            }
+            return result;
+        };
+
+        auto const all = page(uint256{}, 100000, ltINVALID, 1);
+        BEAST_EXPECT(!all.second);
+        BEAST_EXPECT(all.first.size() > 150);
+
+        std::size_t count = 0;
+        for (auto const& entry : ledger->sles)
+        {
+            BEAST_EXPECT(all.first[count++] == to_string(entry->key()));
+        }
+        BEAST_EXPECT(count == all.first.size());
+
+        for (auto const type : {ltINVALID, ltRIPPLE_STATE})
+        {
+            for (std::size_t const limit : {0, 1, 7, 64, 100000})
+            {
+                for (unsigned int const threads : {2, 5, 16})
+                {
+                    // Following the markers visits every entry once
+                    uint256 after;
+                    Json::Value threaded{Json::arrayValue};
+                    Json::Value sequential{Json::arrayValue};
+                    for (int pages = 0; pages < 1000; ++pages)
+                    {
+                        auto const expected = page(after, limit, type, 1);
+                        auto const got = page(after, limit, type, threads);
+                        BEAST_EXPECT(got == expected);
+                        BEAST_EXPECT(got.second == marker(after, limit));
+                        for (auto const& entry : got.first)
+                            threaded.append(entry);
+                        for (auto const& entry : expected.first)
+                            sequential.append(entry);
+                        if (!got.second || limit == 0)
+                            break;
+                        after = *got.second;
+                    }
+                    BEAST_EXPECT(threaded == sequential);
+                    if (limit != 0 && type == ltINVALID)
+                        BEAST_EXPECT(threaded == all.first);
+                }
+            }
+        }
+    }
+
     void
     run() override
     {
@@ -497,6 +603,7 @@ public:
         testMarkerFollow();
         testLedgerHeader();
         testLedgerType();
+        testThreadedState();
     }
 };
 
@@ -270,18 +270,13 @@ class NoRippleCheckLimits_test : public beast::unit_test::suite
             // or otherwise disable endpoint charging for certain test
             // cases.
             using namespace ripple::Resource;
-            using namespace std::chrono;
             using namespace beast::IP;
             auto c = env.app().getResourceManager().newInboundEndpoint(
                 Endpoint::from_string(test::getEnvLocalhostAddr()));
 
             // if we go above the warning threshold, reset
             if (c.balance() > warningThreshold)
-            {
-                using ct = beast::abstract_clock<steady_clock>;
-                c.entry().local_balance =
-                    DecayingSample<decayWindowSeconds, ct>{steady_clock::now()};
-            }
+                c.entry().local_balance.clear();
         };
 
         for (auto i = 0; i < ripple::RPC::Tuning::noRippleCheck.rmax + 5; ++i)
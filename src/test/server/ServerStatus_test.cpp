@@ -21,6 +21,7 @@
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/basics/base64.h>
+#include <ripple/beast/insight/Histogram.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/rpc/ServerHandler.h>
 #include <boost/algorithm/string/predicate.hpp>
@@ -448,6 +449,86 @@ class ServerStatus_test : public beast::unit_test::suite,
         }
     }
 
+    void
+    testMetricsRequest(boost::asio::yield_context& yield)
+    {
+        testcase("Metrics request");
+        using namespace jtx;
+        using namespace boost::beast::http;
+
+        auto metricsRequest = [&](Env& env,
+                                  std::string const& section,
+                                  response<string_body>& resp,
+                                  boost::system::error_code& ec) {
+            auto const port =
+                env.app().config()[section].get<std::uint16_t>("port");
+            auto const ip = env.app().config()[section].get<std::string>("ip");
+            auto req = makeHTTPRequest(*ip, *port, "", {});
+            req.target("/metrics");
+            doRequest(yield, std::move(req), *ip, *port, false, resp, ec);
+        };
+
+        // Metrics are only served when pulled from
+        auto makeConfig = [](bool admin) {
+            return envconfig([admin](std::unique_ptr<Config> cfg) {
+                cfg->section("insight").set("server", "prometheus");
+                cfg->section("insight").set("prefix", "test");
+                cfg->section("port_ws").set("protocol", "http");
+                if (!admin)
+                    cfg->section("port_ws").set("admin", "");
+                return cfg;
+            });
+        };
+
+        {
+            Env env{*this, makeConfig(true)};
+            boost::system::error_code ec;
+            response<string_body> resp;
+            metricsRequest(env, "port_ws", resp, ec);
+            if (!BEAST_EXPECTS(!ec, ec.message()))
+                return;
+            BEAST_EXPECT(resp.result() == status::ok);
+            BEAST_EXPECT(boost::starts_with(
+                resp[field::content_type].to_string(), "text/plain"));
+
+            auto const& body = resp.body();
+            BEAST_EXPECT(
+                body.find("# TYPE test_rpc_requests counter\n") !=
+                std::string::npos);
+            BEAST_EXPECT(
+                body.find("# TYPE test_rpc_time histogram\n") !=
+                std::string::npos);
+
+            // Every bucket is listed, cumulatively, empty ones included
+            std::regex const bucket{
+                R"re(test_rpc_time_bucket\{le="([^"]+)"\} (\d+))re"};
+            std::size_t buckets = 0;
+            std::uint64_t last = 0;
+            bool cumulative = true;
+            for (std::sregex_iterator it{body.begin(), body.end(), bucket}, e;
+                 it != e;
+                 ++it)
+            {
+                auto const count = std::stoull((*it)[2].str());
+                cumulative = cumulative && count >= last;
+                last = count;
+                ++buckets;
+            }
+            BEAST_EXPECT(buckets == beast::insight::Histogram::bucketCount + 1);
+            BEAST_EXPECT(cumulative);
+        }
+
+        {
+            Env env{*this, makeConfig(false)};
+            boost::system::error_code ec;
+            response<string_body> resp;
+            metricsRequest(env, "port_ws", resp, ec);
+            if (!BEAST_EXPECTS(!ec, ec.message()))
+                return;
+            BEAST_EXPECT(resp.result() == status::forbidden);
+        }
+    }
+
     void
     testTruncatedWSUpgrade(boost::asio::yield_context& yield)
     {
@@ -1218,6 +1299,7 @@ public:
         yield_to([&](boost::asio::yield_context& yield) {
             testWSClientToHttpServer(yield);
             testStatusRequest(yield);
+            testMetricsRequest(yield);
             testTruncatedWSUpgrade(yield);
 
             // these are secure/insecure protocol pairs, i.e. for
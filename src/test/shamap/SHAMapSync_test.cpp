@@ -34,7 +34,7 @@ class SHAMapSync_test : public beast::unit_test::suite
 public:
     beast::xor_shift_engine eng_;
 
-    std::shared_ptr<SHAMapItem>
+    boost::intrusive_ptr<SHAMapItem const>
     makeRandomAS()
     {
         Serializer s;
@@ -42,7 +42,7 @@ public:
         for (int d = 0; d < 3; ++d)
             s.add32(rand_int<std::uint32_t>(eng_));
 
-        return std::make_shared<SHAMapItem>(s.getSHA512Half(), s.peekData());
+        return make_shamapitem(s.getSHA512Half(), s.slice());
     }
 
     bool
@@ -56,10 +56,10 @@ public:
 
         for (int i = 0; i < count; ++i)
         {
-            std::shared_ptr<SHAMapItem> item = makeRandomAS();
+            auto item = makeRandomAS();
             items.push_back(item->key());
 
-            if (!map.addItem(SHAMapNodeType::tnACCOUNT_STATE, std::move(*item)))
+            if (!map.addItem(SHAMapNodeType::tnACCOUNT_STATE, std::move(item)))
             {
                 log << "Unable to add item to map\n";
                 return false;
@@ -91,15 +91,18 @@ public:
         using namespace beast::severities;
         test::SuiteJournal journal("SHAMapSync_test", *this);
 
-        TestNodeFamily f(journal), f2(journal);
+        TestNodeFamily f(journal), f2(journal), f3(journal);
         SHAMap source(SHAMapType::FREE, f);
         SHAMap destination(SHAMapType::FREE, f2);
 
+        // Synced from the same nodes, deserialized together as
+        // InboundLedger does
+        SHAMap batched(SHAMapType::FREE, f3);
+
         int items = 10000;
         for (int i = 0; i < items; ++i)
         {
-            source.addItem(
-                SHAMapNodeType::tnACCOUNT_STATE, std::move(*makeRandomAS()));
+            source.addItem(SHAMapNodeType::tnACCOUNT_STATE, makeRandomAS());
             if (i % 100 == 0)
                 source.invariants();
         }
@@ -123,6 +126,7 @@ public:
         std::vector<uint256> hashes;
 
         destination.setSynching();
+        batched.setSynching();
 
         {
             std::vector<SHAMapNodeID> gotNodeIDs_a;
@@ -143,6 +147,12 @@ public:
                                  makeSlice(*gotNodes_a.begin()),
                                  nullptr)
                              .isGood());
+            BEAST_EXPECT(batched
+                             .addRootNode(
+                                 source.getHash(),
+                                 makeSlice(*gotNodes_a.begin()),
+                                 nullptr)
+                             .isGood());
         }
 
         do
@@ -191,14 +201,35 @@ public:
                          .isUseful())
                     fail("", __FILE__, __LINE__);
             }
+
+            std::vector<Slice> rawNodes;
+            for (auto const& node : gotNodes_b)
+                rawNodes.push_back(makeSlice(node));
+            auto const nodes = SHAMapTreeNode::makeFromWire(rawNodes);
+
+            for (std::size_t i = 0; i < gotNodeIDs_b.size(); ++i)
+            {
+                // Don't use BEAST_EXPECT here, as above
+                if (!nodes[i] ||
+                    nodes[i]->getHash() !=
+                        SHAMapTreeNode::makeFromWire(rawNodes[i])->getHash())
+                    fail("", __FILE__, __LINE__);
+
+                if (!batched.addKnownNode(gotNodeIDs_b[i], nodes[i], nullptr)
+                         .isUseful())
+                    fail("", __FILE__, __LINE__);
+            }
         } while (true);
 
         destination.clearSynching();
+        batched.clearSynching();
 
         BEAST_EXPECT(source.deepCompare(destination));
+        BEAST_EXPECT(source.deepCompare(batched));
 
         log << "Checking destination invariants..." << std::endl;
         destination.invariants();
+        batched.invariants();
     }
 };
 
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/basics/Blob.h>
+#include <ripple/basics/ByteUtilities.h>
 #include <ripple/basics/StringUtilities.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/beast/utility/Journal.h>
@@ -44,10 +45,10 @@ static_assert(std::is_move_assignable<SHAMap::const_iterator>{}, "");
 
 static_assert(std::is_nothrow_destructible<SHAMapItem>{}, "");
 static_assert(!std::is_default_constructible<SHAMapItem>{}, "");
-static_assert(std::is_copy_constructible<SHAMapItem>{}, "");
-static_assert(std::is_copy_assignable<SHAMapItem>{}, "");
-static_assert(std::is_move_constructible<SHAMapItem>{}, "");
-static_assert(std::is_move_assignable<SHAMapItem>{}, "");
+static_assert(!std::is_copy_constructible<SHAMapItem>{}, "");
+static_assert(!std::is_copy_assignable<SHAMapItem>{}, "");
+static_assert(!std::is_move_constructible<SHAMapItem>{}, "");
+static_assert(!std::is_move_assignable<SHAMapItem>{}, "");
 
 static_assert(std::is_nothrow_destructible<SHAMapNodeID>{}, "");
 static_assert(std::is_default_constructible<SHAMapNodeID>{}, "");
@@ -120,12 +121,88 @@ public:
         return vuc;
     }
 
+    void
+    testItems()
+    {
+        testcase("items");
+
+        // Sizes in every slab size class, and too large for any of them
+        std::vector<boost::intrusive_ptr<SHAMapItem const>> items;
+        for (std::size_t size = 0; size < 1200; size += 7)
+        {
+            Blob data(size);
+            for (std::size_t i = 0; i < size; ++i)
+                data[i] = static_cast<std::uint8_t>(size + i);
+            items.push_back(make_shamapitem(uint256(size), makeSlice(data)));
+        }
+
+        bool good = true;
+        for (auto const& item : items)
+        {
+            auto const size = item->size();
+            auto const data = item->slice();
+            good = good && item->key() == uint256(size) && data.size() == size;
+            for (std::size_t i = 0; good && i < size; ++i)
+                good = data[i] == static_cast<std::uint8_t>(size + i);
+        }
+        BEAST_EXPECT(good);
+
+        auto const copy = make_shamapitem(*items.back());
+        BEAST_EXPECT(copy != items.back());
+        BEAST_EXPECT(copy->key() == items.back()->key());
+        BEAST_EXPECT(copy->slice() == items.back()->slice());
+
+        auto const before = getSHAMapItemMemory();
+        BEAST_EXPECT(before.slabUsed != 0);
+        BEAST_EXPECT(before.heapItems != 0);
+        BEAST_EXPECT(before.slabReserved >= before.slabUsed);
+
+        items.clear();
+        auto const after = getSHAMapItemMemory();
+        BEAST_EXPECT(after.slabUsed < before.slabUsed);
+        BEAST_EXPECT(after.heapItems < before.heapItems);
+        BEAST_EXPECT(after.heapBytes < before.heapBytes);
+        BEAST_EXPECT(after.slabReserved <= before.slabReserved);
+    }
+
+    void
+    testItemSlabs()
+    {
+        testcase("item slabs");
+
+        // Two slabs for the smallest items
+        auto const limit = setSHAMapItemSlabLimit(megabytes(64));
+
+        // Fill them, until items come from the heap
+        auto const before = getSHAMapItemMemory();
+        std::vector<boost::intrusive_ptr<SHAMapItem const>> items;
+        for (std::size_t i = 0; i < 100000; ++i)
+        {
+            items.push_back(make_shamapitem(uint256(i), Slice{}));
+            if (getSHAMapItemMemory().heapItems > before.heapItems)
+                break;
+        }
+        auto const full = getSHAMapItemMemory();
+        BEAST_EXPECT(full.heapItems == before.heapItems + 1);
+        BEAST_EXPECT(full.slabReserved > before.slabReserved);
+
+        // Emptied slabs are released
+        items.clear();
+        auto const after = getSHAMapItemMemory();
+        BEAST_EXPECT(after.heapItems == before.heapItems);
+        BEAST_EXPECT(after.slabReserved < full.slabReserved);
+
+        setSHAMapItemSlabLimit(limit);
+    }
+
     void
     run() override
     {
         using namespace beast::severities;
         test::SuiteJournal journal("SHAMap_test", *this);
 
+        testItems();
+        testItemSlabs();
         run(true, journal);
         run(false, journal);
     }
@@ -158,37 +235,41 @@ public:
         if (!backed)
             sMap.setUnbacked();
 
-        SHAMapItem i1(h1, IntToVUC(1)), i2(h2, IntToVUC(2)),
-            i3(h3, IntToVUC(3)), i4(h4, IntToVUC(4)), i5(h5, IntToVUC(5));
+        auto i1 = make_shamapitem(h1, makeSlice(IntToVUC(1)));
+        auto i2 = make_shamapitem(h2, makeSlice(IntToVUC(2)));
+        auto i3 = make_shamapitem(h3, makeSlice(IntToVUC(3)));
+        auto i4 = make_shamapitem(h4, makeSlice(IntToVUC(4)));
         unexpected(
-            !sMap.addItem(SHAMapNodeType::tnTRANSACTION_NM, SHAMapItem{i2}),
+            !sMap.addItem(
+                SHAMapNodeType::tnTRANSACTION_NM, make_shamapitem(*i2)),
             "no add");
         sMap.invariants();
         unexpected(
-            !sMap.addItem(SHAMapNodeType::tnTRANSACTION_NM, SHAMapItem{i1}),
+            !sMap.addItem(
+                SHAMapNodeType::tnTRANSACTION_NM, make_shamapitem(*i1)),
             "no add");
         sMap.invariants();
 
         auto i = sMap.begin();
         auto e = sMap.end();
-        unexpected(i == e || (*i != i1), "bad traverse");
+        unexpected(i == e || (*i != *i1), "bad traverse");
         ++i;
-        unexpected(i == e || (*i != i2), "bad traverse");
+        unexpected(i == e || (*i != *i2), "bad traverse");
         ++i;
         unexpected(i != e, "bad traverse");
-        sMap.addItem(SHAMapNodeType::tnTRANSACTION_NM, SHAMapItem{i4});
+        sMap.addItem(SHAMapNodeType::tnTRANSACTION_NM, make_shamapitem(*i4));
         sMap.invariants();
-        sMap.delItem(i2.key());
+        sMap.delItem(i2->key());
         sMap.invariants();
-        sMap.addItem(SHAMapNodeType::tnTRANSACTION_NM, SHAMapItem{i3});
+        sMap.addItem(SHAMapNodeType::tnTRANSACTION_NM, make_shamapitem(*i3));
         sMap.invariants();
         i = sMap.begin();
         e = sMap.end();
-        unexpected(i == e || (*i != i1), "bad traverse");
+        unexpected(i == e || (*i != *i1), "bad traverse");
         ++i;
-        unexpected(i == e || (*i != i3), "bad traverse");
+        unexpected(i == e || (*i != *i3), "bad traverse");
         ++i;
-        unexpected(i == e || (*i != i4), "bad traverse");
+        unexpected(i == e || (*i != *i4), "bad traverse");
         ++i;
         unexpected(i != e, "bad traverse");
 
@@ -284,9 +365,9 @@ public:
             BEAST_EXPECT(map.getHash() == beast::zero);
             for (int k = 0; k < keys.size(); ++k)
             {
-                SHAMapItem item(keys[k], IntToVUC(k));
                 BEAST_EXPECT(map.addItem(
-                    SHAMapNodeType::tnTRANSACTION_NM, std::move(item)));
+                    SHAMapNodeType::tnTRANSACTION_NM,
+                    make_shamapitem(keys[k], makeSlice(IntToVUC(k)))));
                 BEAST_EXPECT(map.getHash().as_uint256() == hashes[k]);
                 map.invariants();
             }
@@ -339,7 +420,7 @@ public:
             {
                 map.addItem(
                     SHAMapNodeType::tnTRANSACTION_NM,
-                    SHAMapItem{k, IntToVUC(0)});
+                    make_shamapitem(k, makeSlice(IntToVUC(0))));
                 map.invariants();
             }
 
@@ -372,7 +453,9 @@ class SHAMapPathProof_test : public beast::unit_test::suite
         {
             uint256 k(c);
             Blob b(32, c);
-            map.addItem(SHAMapNodeType::tnACCOUNT_STATE, SHAMapItem{k, b});
+            map.addItem(
+                SHAMapNodeType::tnACCOUNT_STATE,
+                make_shamapitem(k, makeSlice(b)));
             map.invariants();
 
             auto root = map.getHash().as_uint256();